@@ -1,11 +1,32 @@
 #include "device_actions.h"
 
+#include <cstring>
+#include <span>
+
 #include "actions/action_types.h"
 #include "drivers/device_types.h"
+#include "utils/request_arena.h"
 #include "frozen.h"
 
 #include "smartqua_config.h"
 
+namespace {
+    // The rest of the arena of the request, outside of a request the buffer is borrowed from the pool
+    std::span<char> actionBuffer(std::optional<BufferPoolType::LargeBufferBorrowerType> &pooledBuffer) {
+        if (auto *arena = RequestArena::current(); arena != nullptr) {
+            return arena->allocateRemaining();
+        }
+
+        pooledBuffer = BufferPoolType::wait_for_free_buffer(large_buffer_size, buffer_wait_timeout);
+
+        if (!pooledBuffer.has_value()) {
+            return {};
+        }
+
+        return std::span<char>(pooledBuffer->data(), pooledBuffer->size());
+    }
+}
+
 // TODO: add the equivalent for the other actions
 bool writeDeviceValue(unsigned int index, std::string_view input, const DeviceValues &value, bool deferSaving) {
     WriteToDevice single_device_value{ .index = index, .what = input, .write_value = value };
@@ -36,16 +57,22 @@ JsonActionResult get_devices_action(std::optional<unsigned int> index, const cha
     JsonActionResult result{ 0, JsonActionResultStatus::failed };
 
     if (!index.has_value()) {
-        auto overview_buffer = LargeBufferPoolType::get_free_buffer();
+        std::optional<BufferPoolType::LargeBufferBorrowerType> pooledBuffer;
+        auto overview_buffer = actionBuffer(pooledBuffer);
+
+        if (overview_buffer.empty()) {
+            return result;
+        }
+
         RetrieveDeviceOverview overview{};
-        overview.output_dst = overview_buffer->data();
-        overview.output_len = overview_buffer->size();
+        overview.output_dst = overview_buffer.data();
+        overview.output_len = overview_buffer.size();
 
         global_store->readEvent(overview);
 
         if (overview.result.collection_result != DeviceCollectionOperation::failed) {
             if (output_buffer != nullptr && output_buffer_len != 0) {
-                result.answer_len = json_printf(&answer, "{ data : %s }", overview_buffer->data());
+                result.answer_len = json_printf(&answer, "{ data : %s }", overview_buffer.data());
             }
             result.result = JsonActionResultStatus::success;
         }
@@ -75,16 +102,22 @@ JsonActionResult get_device_info(unsigned int index, const char *input, size_t i
     json_out answer = JSON_OUT_BUF(output_buffer, output_buffer_len);
     JsonActionResult result{ 0, JsonActionResultStatus::failed };
 
-    auto info_buffer = LargeBufferPoolType::get_free_buffer();
+    std::optional<BufferPoolType::LargeBufferBorrowerType> pooledBuffer;
+    auto info_buffer = actionBuffer(pooledBuffer);
+
+    if (info_buffer.empty()) {
+        return result;
+    }
+
     RetrieveDeviceInfo info{ .index = static_cast<unsigned int>(index) };
-    info.output_dst = info_buffer->data();
-    info.output_len = info_buffer->size();
+    info.output_dst = info_buffer.data();
+    info.output_len = info_buffer.size();
 
     global_store->readEvent(info);
 
     if (info.result.collection_result == DeviceCollectionOperation::ok && info.result.op_result == DeviceOperationResult::ok) {
         if (output_buffer != nullptr && output_buffer_len != 0) {
-            result.answer_len = json_printf(&answer, "{ data : %s }", info_buffer->data());
+            result.answer_len = json_printf(&answer, "{ data : %s }", info_buffer.data());
         }
         result.result = JsonActionResultStatus::success;
     } else {
@@ -204,22 +237,28 @@ JsonActionResult write_device_options_action(unsigned int index, const char *act
     json_out answer = JSON_OUT_BUF(output_buffer, output_buffer_len);
     JsonActionResult result{ 0, JsonActionResultStatus::failed };
 
-    auto info_buffer = LargeBufferPoolType::get_free_buffer();
+    std::optional<BufferPoolType::LargeBufferBorrowerType> pooledBuffer;
+    auto info_buffer = actionBuffer(pooledBuffer);
+
+    if (info_buffer.empty()) {
+        return result;
+    }
+
     // TODO: check if this fixes the issue
-    std::memset(info_buffer->data(), 0, info_buffer->size());
+    std::memset(info_buffer.data(), 0, info_buffer.size());
 
     WriteDeviceOptions info{
         .index = static_cast<unsigned int>(index), 
         .action = action,
         .input = std::string_view{input, input_len},
-        .output_dst = info_buffer->data(),
-        .output_len = info_buffer->size()};
+        .output_dst = info_buffer.data(),
+        .output_len = info_buffer.size()};
 
     global_store->writeEvent(info);
 
     if (info.result.collection_result == DeviceCollectionOperation::ok && info.result.op_result == DeviceOperationResult::ok) {
         if (output_buffer != nullptr && output_buffer[0] != '\0' && output_buffer_len != 0) {
-            result.answer_len = json_printf(&answer, "{ data : %s }", info_buffer->data());
+            result.answer_len = json_printf(&answer, "{ data : %s }", info_buffer.data());
         }
         result.result = JsonActionResultStatus::success;
     } else {
@@ -157,12 +157,16 @@ DeviceSettings<N, DeviceDrivers ...> &DeviceSettings<N, DeviceDrivers ...>::oper
 template<size_t N, typename ... DeviceDrivers>
 void DeviceSettings<N, DeviceDrivers ...>::initializeUpdater() {
     std::call_once(initialized_updater_flag, [this]() {
-        this->m_task_resource = MainTaskPool::postTask(TaskDescription{
+        this->m_task_resource = mainTaskPool.postTask(TaskDescription{
                 .single_shot = false,
                 .func_ptr = &updateDeviceRuntime,
                 .interval = std::chrono::seconds(10),
                 .argument = reinterpret_cast<void *>(this),
-                .description = "Device Updater thread"
+                .description = "Device Updater thread",
+                .priority = TaskPriority::control,
+                .rate_mode = TaskRateMode::fixedRate,
+                .catch_up = TaskCatchUpPolicy::runOnce,
+                .slack = std::chrono::milliseconds(500)
         });
     });
 }
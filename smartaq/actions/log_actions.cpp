@@ -0,0 +1,50 @@
+#include "log_actions.h"
+
+#include <cstring>
+
+#include "frozen.h"
+
+#include "build_config.h"
+
+// Escaping can double the message, the rest is needed for the fields and the closing brackets
+static constexpr size_t max_record_overhead = 96;
+
+JsonActionResult get_logs_action(uint32_t since, char *output_buffer, size_t output_buffer_len) {
+    JsonActionResult result{ 0, JsonActionResultStatus::failed };
+
+    if (output_buffer == nullptr || output_buffer_len == 0) {
+        return result;
+    }
+
+    json_out answer = JSON_OUT_BUF(output_buffer, output_buffer_len);
+    bool firstPrint = true;
+
+    result.answer_len = json_printf(&answer, "{ data : [");
+
+    // The records are only copied into the buffer, the buffer is sent, once the records aren't locked anymore
+    const auto range = Logger::sink<RecentLogSink>().forEachRecordSince(since,
+        [&answer, &result, &firstPrint, output_buffer_len](const RecentLogSink::RecordType &record) {
+            const auto messageLength = strnlen(record.message.data(), record.message.size());
+
+            if (static_cast<size_t>(result.answer_len) + 2 * messageLength + max_record_overhead > output_buffer_len) {
+                return false;
+            }
+
+            const char *format = ", { seq : %u, level : %Q, uptime_ms : %u, msg : %.*Q }";
+            result.answer_len += json_printf(&answer, format + (firstPrint ? 1 : 0),
+                static_cast<unsigned int>(record.sequence),
+                to_string(record.level),
+                static_cast<unsigned int>(record.uptimeMs),
+                static_cast<int>(messageLength), record.message.data());
+            firstPrint = false;
+            return true;
+        });
+
+    // Clients pass next as since of the next request
+    result.answer_len += json_printf(&answer, "], next : %u, missed : %u }",
+        static_cast<unsigned int>(range.lastSequence),
+        static_cast<unsigned int>(range.missedRecords));
+    result.result = JsonActionResultStatus::success;
+
+    return result;
+}
@@ -0,0 +1,8 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "actions/action_types.h"
+
+JsonActionResult get_logs_action(uint32_t since, char *output_buffer, size_t output_buffer_len);
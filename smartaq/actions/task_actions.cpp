@@ -0,0 +1,74 @@
+#include "task_actions.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+
+#include "frozen.h"
+
+#include "build_config.h"
+#include "utils/task_pool.h"
+
+// The numbers, the field names and the histogram of a record, escaping can double the description,
+// the rest is needed for the closing brackets
+static constexpr size_t max_task_record_overhead = 512 + 11 * taskExecutionHistogramSize;
+
+// Times are printed in microseconds, the accumulated drift in milliseconds.
+// Tasks, which don't fit into the buffer anymore, are left out and truncated is set.
+JsonActionResult get_tasks_action(char *output_buffer, size_t output_buffer_len) {
+    JsonActionResult result{ 0, JsonActionResultStatus::failed };
+
+    if (output_buffer == nullptr || output_buffer_len == 0) {
+        return result;
+    }
+
+    json_out answer = JSON_OUT_BUF(output_buffer, output_buffer_len);
+    bool firstPrint = true;
+    bool truncated = false;
+
+    result.answer_len = json_printf(&answer, "{ data : [");
+
+    mainTaskPool.forEachTaskMetrics([&answer, &result, &firstPrint, &truncated, output_buffer_len](const TaskMetrics &metrics) {
+        const auto descriptionLength = std::strlen(metrics.description);
+
+        if (static_cast<size_t>(result.answer_len) + 2 * descriptionLength + max_task_record_overhead > output_buffer_len) {
+            truncated = true;
+            return false;
+        }
+
+        const char *format = ", { description : %Q, priority : %Q, runs : %u, overruns : %u, "
+            "last_execution_us : %u, avg_execution_us : %u, max_execution_us : %u, "
+            "last_lateness_us : %u, avg_lateness_us : %u, max_lateness_us : %u, skipped_runs : %u, "
+            "accumulated_drift_ms : %u, execution_histogram : %M }";
+
+        result.answer_len += json_printf(&answer, format + (firstPrint ? 1 : 0),
+            metrics.description,
+            to_string(metrics.priority),
+            static_cast<unsigned int>(metrics.runs),
+            static_cast<unsigned int>(metrics.overruns),
+            static_cast<unsigned int>(metrics.lastExecutionTime.count()),
+            static_cast<unsigned int>(metrics.averageExecutionTime.count()),
+            static_cast<unsigned int>(metrics.maxExecutionTime.count()),
+            static_cast<unsigned int>(metrics.lastLateness.count()),
+            static_cast<unsigned int>(metrics.averageLateness.count()),
+            static_cast<unsigned int>(metrics.maxLateness.count()),
+            static_cast<unsigned int>(metrics.skippedRuns),
+            static_cast<unsigned int>(std::chrono::duration_cast<std::chrono::milliseconds>(metrics.accumulatedDrift).count()),
+            json_printf_array, metrics.executionTimeHistogram.data(), sizeof(metrics.executionTimeHistogram),
+            sizeof(metrics.executionTimeHistogram[0]), "%u");
+        firstPrint = false;
+        return true;
+    });
+
+    result.answer_len += json_printf(&answer, "], truncated : %B }", truncated);
+
+    // json_printf counts, what didn't fit, as well, so this is only the case for a buffer without room for a single record
+    if (static_cast<size_t>(result.answer_len) >= output_buffer_len) {
+        result.answer_len = 0;
+        return result;
+    }
+
+    result.result = JsonActionResultStatus::success;
+
+    return result;
+}
@@ -0,0 +1,7 @@
+#pragma once
+
+#include <cstddef>
+
+#include "actions/action_types.h"
+
+JsonActionResult get_tasks_action(char *output_buffer, size_t output_buffer_len);
@@ -1,27 +1,60 @@
 #pragma once
 
+#include <chrono>
+
 #include "drivers/hal/device_config.h"
 #include "utils/buffer_types.h"
 
 #include "utils/logger.h"
+#include "utils/memory_log_sink.h"
+
+// Log calls below this level are removed at compile time, e.g. -DMINIMUM_LOG_LEVEL=Warning
+#ifndef MINIMUM_LOG_LEVEL
+#define MINIMUM_LOG_LEVEL Debug
+#endif
+
+static inline constexpr LogLevel minimum_log_level = LogLevel::MINIMUM_LOG_LEVEL;
+
+// The most recent records are kept in memory and served at /api/v1/logs
+static inline constexpr size_t recent_log_records = 32;
+using RecentLogSink = MemoryLogSink<recent_log_records>;
 
 #if TARGET_DEVICE == ESP32
     #include "utils/esp/esp_logger_utils.h"
-    using Logger = ApplicationLogger<EspIdfBackend, VoidSink>;
+    // The sd card has to be mounted at /external
+    #ifdef ENABLE_SD_CARD_LOG
+    using Logger = ApplicationLogger<EspIdfBackend, minimum_log_level, RecentLogSink, SdCardSink>;
+    #else
+    using Logger = ApplicationLogger<EspIdfBackend, minimum_log_level, RecentLogSink>;
+    #endif
 #else
-    using Logger = ApplicationLogger<PrintfBackend, VoidSink>;
+    using Logger = ApplicationLogger<PrintfBackend, minimum_log_level, RecentLogSink>;
 #endif
 
 // TODO: Create system agnostic version of this
 #if TARGET_DEVICE == ESP32
     #include "utils/large_buffer_pool.h"
     // TODO: make configurable
-    using LargeBufferPoolType = LargeBufferPool<num_large_buffers, large_buffer_size, BufferLocation::heap>;
-    using SmallerBufferPoolType = LargeBufferPool<20, 256, BufferLocation::heap>;
+    static inline constexpr size_t small_buffer_size = 256;
+    // Callers ask for the size they need, e.g. BufferPoolType::get_free_buffer(small_buffer_size)
+    using BufferPoolType = LargeBufferPool<BufferLocation::heap,
+        BufferSizeClass<small_buffer_size, 20>,
+        BufferSizeClass<large_buffer_size, num_large_buffers>>;
+    // How long request handlers wait for a buffer, while a burst of requests borrowed all of them
+    static inline constexpr std::chrono::milliseconds buffer_wait_timeout{500};
 
     #include "utils/task_pool.h"
 
-    using MainTaskPool = TaskPool<max_task_pool_size>;
+    static inline constexpr size_t main_task_pool_workers = 3;
+    using MainTaskPool = TaskPool<max_task_pool_size, main_task_pool_workers>;
+
+    // Defined in main_thread.cpp, the workers are started in mainTask
+    extern MainTaskPool mainTaskPool;
+
+    #include "utils/coroutine_task.h"
+
+    // Drivers, which poll their devices, run as coroutines on mainTaskPool instead of their own threads
+    using MainCoroutineTask = CoroutineTask<MainTaskPool>;
 
 
     // Device specific section
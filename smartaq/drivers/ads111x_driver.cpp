@@ -5,7 +5,7 @@
 
 #include <algorithm>
 #include <chrono>
-#include <thread>
+#include <stop_token>
 #include <utility>
 #include <string_view>
 #include <optional>
@@ -92,39 +92,33 @@ std::optional<Ads111xDriver> Ads111xDriver::setupDevice(const DeviceConfig *devi
 
 Ads111xDriver::Ads111xDriver(const DeviceConfig*conf, i2c_dev_t device, std::shared_ptr<GpioResource> sdaPin, std::shared_ptr<GpioResource> sclPin)
     : mConf(conf), mDevice(std::move(device)), mSdaPin(std::move(sdaPin)), mSclPin(std::move(sclPin)) {
-    mAnalogReadingsThread = std::jthread(&Ads111xDriver::updateAnalogThread, this);
+    mAnalogReadingsTask = MainCoroutineTask::spawnFor(this, mainTaskPool, "Ads111x readings", TaskPriority::sensing,
+                                                      &Ads111xDriver::updateAnalogTask);
 }
 
-Ads111xDriver::Ads111xDriver(Ads111xDriver &&other)
-    : mConf(other.mConf)
-    , mDevice(other.mDevice)
-    , mSdaPin(std::move(other.mSdaPin))
-    , mSclPin(std::move(other.mSclPin)) {
-    other.mAnalogReadingsThread.request_stop();
-    if (other.mAnalogReadingsThread.joinable()) {
-        other.mAnalogReadingsThread.join();
-    }
-
-    other.mConf = nullptr;
-    std::memset(&other.mDevice, 0, sizeof(i2c_dev_t));
+// The running readings task is handed over, so a move doesn't wait for the pool
+Ads111xDriver::Ads111xDriver(Ads111xDriver &&other) : mAnalogReadingsTask(std::move(other.mAnalogReadingsTask)) {
+    mAnalogReadingsTask.handOver(this, [this, &other]() {
+        mConf = std::exchange(other.mConf, nullptr);
+        mDevice = other.mDevice;
+        mSdaPin = std::move(other.mSdaPin);
+        mSclPin = std::move(other.mSclPin);
 
-    mAnalogReadingsThread = std::jthread(&Ads111xDriver::updateAnalogThread, this);
+        std::memset(&other.mDevice, 0, sizeof(i2c_dev_t));
+    });
  }
 
  Ads111xDriver &Ads111xDriver::operator=(Ads111xDriver &&other) {
     using std::swap;
 
-    other.mAnalogReadingsThread.request_stop();
-    if (other.mAnalogReadingsThread.joinable()) {
-        other.mAnalogReadingsThread.join();
-    }
-
-    swap(mConf, other.mConf);
-    swap(mDevice, other.mDevice);
-    swap(mSdaPin, other.mSdaPin);
-    swap(mSclPin, other.mSclPin);
-
-    mAnalogReadingsThread = std::jthread(&Ads111xDriver::updateAnalogThread, this);
+    // Stops the readings task of this driver, other cleans up the old device
+    mAnalogReadingsTask = std::move(other.mAnalogReadingsTask);
+    mAnalogReadingsTask.handOver(this, [this, &other]() {
+        swap(mConf, other.mConf);
+        swap(mDevice, other.mDevice);
+        swap(mSdaPin, other.mSdaPin);
+        swap(mSclPin, other.mSclPin);
+    });
 
     return *this;
 }
@@ -134,10 +128,7 @@ Ads111xDriver::~Ads111xDriver() {
         return;
     }
 
-    mAnalogReadingsThread.request_stop();
-    if (mAnalogReadingsThread.joinable()) {
-        mAnalogReadingsThread.join();
-    }
+    mAnalogReadingsTask.join();
     removeAddress(mConf->accessConfig<Ads111xDriverData>()->addr);
 }
 
@@ -148,7 +139,7 @@ DeviceOperationResult Ads111xDriver::write_value(std::string_view what, const De
 DeviceOperationResult Ads111xDriver::read_value(std::string_view what, DeviceValues &value) const {
     const auto *config  = mConf->accessConfig<Ads111xDriverData>();
     int16_t analog = 0;
-    Logger::log(LogLevel::Info, "Reading address : %u value to read : %.*s", 
+    LOG_IF_ENABLED(LogLevel::Info, "Reading address : %u value to read : %.*s",
         static_cast<uint32_t>(config->addr), what.size(), what.data());
 
     if (what == "a0") {
@@ -181,9 +172,11 @@ DeviceOperationResult Ads111xDriver::update_runtime_data() {
     return DeviceOperationResult::not_supported;
 }
 
-void Ads111xDriver::updateAnalogThread(std::stop_token token, Ads111xDriver *instance) {
+MainCoroutineTask Ads111xDriver::updateAnalogTask(std::stop_token token) {
     using namespace std::chrono_literals;
 
+    const auto instance = co_await currentOwner<Ads111xDriver>();
+
     constexpr std::array muxLookUp{
             ADS111X_MUX_0_GND,
             ADS111X_MUX_1_GND,
@@ -196,13 +189,13 @@ void Ads111xDriver::updateAnalogThread(std::stop_token token, Ads111xDriver *ins
         
         ads111x_set_input_mux(&instance->mDevice, muxLookUp[i]);
 
-        bool busy = true;
-        for (unsigned int numWait = 0; numWait < 3 && busy; ++numWait) {
-            std::this_thread::sleep_for(500ms);
+        const bool ready = co_await untilReady([instance]() {
+            bool busy = true;
             ads111x_is_busy(&instance->mDevice, &busy);
-        }
+            return !busy;
+        }, 500ms, 1500ms);
 
-        if (busy) {
+        if (!ready) {
             // Wait for next iteration
             Logger::log(LogLevel::Info, "Device is busy");
             continue;
@@ -212,18 +205,20 @@ void Ads111xDriver::updateAnalogThread(std::stop_token token, Ads111xDriver *ins
         auto result = ads111x_get_value(&instance->mDevice, &analog);
 
         if (result == ESP_OK) {
-            Logger::log(LogLevel::Info, "Read analog value : %u in channel %u", static_cast<uint32_t>(analog),
+            LOG_IF_ENABLED(LogLevel::Info, "Read analog value : %u in channel %u", static_cast<uint32_t>(analog),
             static_cast<uint32_t>(i));
         } else {
+            // Don't keep the worker busy with retries
+            co_await sleepFor(500ms);
             continue;
         }
 
         instance->mAnalogReadings[i].putSample(std::bit_cast<uint16_t>(analog));
 
         const auto duration = std::chrono::steady_clock::now() - beforeReading;
-        std::this_thread::sleep_for(duration < 5s ? 5s - duration : 500ms);
+        co_await sleepFor(duration < 5s ? std::chrono::duration_cast<std::chrono::milliseconds>(5s - duration) : 500ms);
     }
-    Logger::log(LogLevel::Info, "Exiting updateAnalogThread");
+    Logger::log(LogLevel::Info, "Exiting updateAnalogTask");
 }
 
 bool Ads111xDriver::addAddress(Ads111xAddress address) {
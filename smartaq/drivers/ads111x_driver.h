@@ -6,7 +6,7 @@
 #include <string_view>
 #include <optional>
 #include <memory>
-#include <thread>
+#include <stop_token>
 #include <cstdint>
 #include <shared_mutex>
 
@@ -75,7 +75,7 @@ class Ads111xDriver final {
                                                         std::shared_ptr<GpioResource> sdaPin,
                                                         std::shared_ptr<GpioResource> sclPin);
 
-        static void updateAnalogThread(std::stop_token token, Ads111xDriver *instance);
+        static MainCoroutineTask updateAnalogTask(std::stop_token token);
 
         static bool addAddress(Ads111xAddress address);
         static bool removeAddress(Ads111xAddress address);
@@ -85,7 +85,7 @@ class Ads111xDriver final {
         mutable i2c_dev_t mDevice;
         std::shared_ptr<GpioResource> mSdaPin{nullptr};
         std::shared_ptr<GpioResource> mSclPin{nullptr};
-        std::jthread mAnalogReadingsThread;
+        MainCoroutineTask mAnalogReadingsTask;
         std::array<SampleContainer<uint16_t, uint16_t, 10>, MaxChannels> mAnalogReadings;
 
         static inline FixedSizeOptionalArray<Ads111xAddress, 4> _device_addresses;
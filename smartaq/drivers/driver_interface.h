@@ -151,13 +151,17 @@ DeviceOperationResult SensorDriverInterface<Driver>::update_runtime_data()
 {
     if (!mTrackedTask.isActive())
     {
-        mTrackedTask = MainTaskPool::postTask(TaskDescription{
+        mTrackedTask = mainTaskPool.postTask(TaskDescription{
             .single_shot = false,
             .func_ptr = updateThread,
             .interval = std::chrono::seconds(5),
             .argument = this,
             .description = "Reading from sensor",
-            .last_executed = std::chrono::steady_clock::now()
+            .last_executed = std::chrono::steady_clock::now(),
+            .priority = TaskPriority::sensing,
+            .rate_mode = TaskRateMode::fixedRate,
+            .catch_up = TaskCatchUpPolicy::skipMissed,
+            .slack = std::chrono::seconds(1)
         });
     }
     return DeviceOperationResult::ok;
@@ -3,7 +3,7 @@
 #include <chrono>
 #include <cstddef>
 #include <cstring>
-#include <thread>
+#include <stop_token>
 
 #include "driver/rmt_encoder.h"
 #include "drivers/device_types.h"
@@ -102,13 +102,17 @@ DeviceOperationResult DRV8825Driver::call_device_action(DeviceConfig*conf, const
     return DeviceOperationResult::ok;
 }
 
-void DRV8825Driver::updatePumpThread(std::stop_token token, DRV8825Driver *instance) {
+MainCoroutineTask DRV8825Driver::updatePumpTask(std::stop_token token) {
+    using namespace std::chrono_literals;
+
+    const auto instance = co_await currentOwner<DRV8825Driver>();
+
     UniformStepperMovement mov{.resolution = 1'000'000 };
     rmt_encoder_handle_t encoder = nullptr;
 
     if(auto result = createNewRmtUniformEncoder(mov, &encoder); result != ESP_OK) {
         Logger::log(LogLevel::Error, "Couldn't create Rmt Uniform Encoder");
-        return;
+        co_return;
     }
 
     rmt_transmit_config_t tx_config{
@@ -117,7 +121,7 @@ void DRV8825Driver::updatePumpThread(std::stop_token token, DRV8825Driver *insta
 
     auto stepperConfig = instance->mConf->accessConfig<DRV8825DriverConfig>();
 
-    Logger::log(LogLevel::Info, "Starting Stepper dosing thread");
+    Logger::log(LogLevel::Info, "Starting Stepper dosing task");
     auto result = gpio_set_level(static_cast<gpio_num_t>(stepperConfig->enGPIONum), 1);
     Logger::log(LogLevel::Info, "Result setting enable to 1 %d", result);
 
@@ -134,7 +138,11 @@ void DRV8825Driver::updatePumpThread(std::stop_token token, DRV8825Driver *insta
                 // return DeviceOperationResult::failure;
             }
 
-            if (auto result = rmt_tx_wait_all_done(instance->mRmtHandles.channel_handle, 200); result != ESP_OK) {
+            const bool transmitted = co_await untilReady([instance]() {
+                return rmt_tx_wait_all_done(instance->mRmtHandles.channel_handle, 0) == ESP_OK;
+            }, 10ms, 200ms);
+
+            if (!transmitted) {
                 Logger::log(LogLevel::Error, "Couldn't wait for transmit of data");
                 // return DeviceOperationResult::failure;
             }
@@ -144,20 +152,16 @@ void DRV8825Driver::updatePumpThread(std::stop_token token, DRV8825Driver *insta
             instance->mStepsLeft.fetch_add(currentStepsLeft - 1);
         } else {
             // Logger::log(LogLevel::Info, "Waiting for different value");
-            using namespace std::chrono_literals;
-            std::this_thread::sleep_for(100ms);
+            co_await sleepFor(100ms);
         }
 
     }
-    Logger::log(LogLevel::Info, "Exiting pump thread");
+    Logger::log(LogLevel::Info, "Exiting pump task");
 }
 
 DRV8825Driver::~DRV8825Driver() {
     Logger::log(LogLevel::Info, "Deleting instance of stepperdosingpumpdriver");
-    if (mPumpThread.joinable()) {
-        mPumpThread.request_stop();
-        mPumpThread.join();
-    }
+    mPumpTask.join();
 }
 
 DRV8825Driver::DRV8825Driver(const DeviceConfig*conf, std::shared_ptr<GpioResource> stepGPIO, const RmtHandles &rmtHandle) :
@@ -166,41 +170,32 @@ DRV8825Driver::DRV8825Driver(const DeviceConfig*conf, std::shared_ptr<GpioResour
     mStepGPIO(std::move(stepGPIO)),
     mStepsLeft(0)
 { 
-    mPumpThread = std::jthread(&DRV8825Driver::updatePumpThread, this);
+    mPumpTask = MainCoroutineTask::spawnFor(this, mainTaskPool, "DRV8825 pump", TaskPriority::control,
+                                            &DRV8825Driver::updatePumpTask);
 }
 
-
-DRV8825Driver::DRV8825Driver(DRV8825Driver &&other) noexcept :
-    mRmtHandles(other.mRmtHandles),
-    mConf(other.mConf),
-    mStepGPIO(std::move(other.mStepGPIO)),
-    mStepsLeft(0)
+// The running pump task is handed over, so a move doesn't wait for the pool
+DRV8825Driver::DRV8825Driver(DRV8825Driver &&other) noexcept : mPumpTask(std::move(other.mPumpTask))
 {
-    other.mPumpThread.request_stop();
-    if (other.mPumpThread.joinable()) {
-        other.mPumpThread.join();
-    }
-    
-    mPumpThread = std::jthread(&DRV8825Driver::updatePumpThread, this);
+    mPumpTask.handOver(this, [this, &other]() {
+        mRmtHandles = other.mRmtHandles;
+        mConf = other.mConf;
+        mStepGPIO = std::move(other.mStepGPIO);
+        mStepsLeft = other.mStepsLeft.exchange(0);
+    });
 }
 
 DRV8825Driver &DRV8825Driver::operator=(DRV8825Driver &&other) noexcept {
-    Logger::log(LogLevel::Info, "Waiting for other thread to join move op");
-    other.mStepsLeft = 1;
-    other.mPumpThread.request_stop();
-    if (other.mPumpThread.joinable()) {
-        other.mPumpThread.join();
-    }
-    Logger::log(LogLevel::Info, "Done");
-
     using std::swap;
-    swap(mRmtHandles, other.mRmtHandles);
-    swap(mConf, other.mConf);
-    swap(mStepGPIO, other.mStepGPIO);
-    Logger::log(LogLevel::Info, "Done");
-    mStepsLeft = 0;
 
-    mPumpThread = std::jthread(&DRV8825Driver::updatePumpThread, this);
+    // Stops the pump task of this driver
+    mPumpTask = std::move(other.mPumpTask);
+    mPumpTask.handOver(this, [this, &other]() {
+        swap(mRmtHandles, other.mRmtHandles);
+        swap(mConf, other.mConf);
+        swap(mStepGPIO, other.mStepGPIO);
+        mStepsLeft = other.mStepsLeft.exchange(0);
+    });
 
     return *this; 
 }
@@ -2,7 +2,7 @@
 
 #include <cstdint>
 #include <memory>
-#include <thread>
+#include <stop_token>
 #include <string_view>
 
 #include "build_config.h"
@@ -41,7 +41,7 @@ class DRV8825Driver final {
         DeviceOperationResult update_runtime_data() { return DeviceOperationResult::not_supported; }
 
     private:
-        static void updatePumpThread(std::stop_token token, DRV8825Driver *instance);
+        static MainCoroutineTask updatePumpTask(std::stop_token token);
 
         struct RmtHandles {
             rmt_channel_handle_t channel_handle;
@@ -53,5 +53,5 @@ class DRV8825Driver final {
 
         std::shared_ptr<GpioResource> mStepGPIO = nullptr;
         std::atomic_uint16_t mStepsLeft = 0;
-        std::jthread mPumpThread;
+        MainCoroutineTask mPumpTask;
 };
\ No newline at end of file
@@ -5,7 +5,7 @@
 
 #include <algorithm>
 #include <chrono>
-#include <thread>
+#include <stop_token>
 #include <utility>
 #include <string_view>
 #include <optional>
@@ -103,32 +103,33 @@ std::optional<Pcf8575Driver> Pcf8575Driver::create_driver(const std::string_view
 
 Pcf8575Driver::Pcf8575Driver(const DeviceConfig*conf, i2c_dev_t device) 
     : m_conf(conf), m_device(std::move(device)) { 
+    mReadingTask = MainCoroutineTask::spawnFor(this, mainTaskPool, "Pcf8575 readings", TaskPriority::sensing,
+                                               &Pcf8575Driver::updatePinsTask);
 }
 
-Pcf8575Driver::Pcf8575Driver(Pcf8575Driver &&other) noexcept : m_conf(other.m_conf), m_device(other.m_device) {
-    other.mReadingThread.request_stop();
-    if (other.mReadingThread.joinable()) {
-        other.mReadingThread.join();
-    }
-
-    other.m_conf = nullptr;
-    std::memset(&other.m_device, 0, sizeof(i2c_dev_t));
+// The running reading task is handed over, so a move doesn't wait for the pool
+Pcf8575Driver::Pcf8575Driver(Pcf8575Driver &&other) noexcept : mReadingTask(std::move(other.mReadingTask)) {
+    mReadingTask.handOver(this, [this, &other]() {
+        m_conf = std::exchange(other.m_conf, nullptr);
+        m_device = other.m_device;
+        readValue = other.readValue.load();
+        writtenValue = other.writtenValue;
 
-    mReadingThread = std::jthread(&Pcf8575Driver::updatePinsThread, this);
+        std::memset(&other.m_device, 0, sizeof(i2c_dev_t));
+    });
  }
 
  Pcf8575Driver &Pcf8575Driver::operator=(Pcf8575Driver &&other) noexcept {
     using std::swap;
 
-    other.mReadingThread.request_stop();
-    if (other.mReadingThread.joinable()) {
-        other.mReadingThread.join();
-    }
-
-    swap(m_conf, other.m_conf);
-    swap(m_device, other.m_device);
-
-    mReadingThread = std::jthread(&Pcf8575Driver::updatePinsThread, this);
+    // Stops the reading task of this driver, other cleans up the old device
+    mReadingTask = std::move(other.mReadingTask);
+    mReadingTask.handOver(this, [this, &other]() {
+        swap(m_conf, other.m_conf);
+        swap(m_device, other.m_device);
+        readValue = other.readValue.load();
+        writtenValue = other.writtenValue;
+    });
 
     return *this;
 }
@@ -138,10 +139,7 @@ Pcf8575Driver::~Pcf8575Driver() {
         return;
     }
 
-    mReadingThread.request_stop();
-    if (mReadingThread.joinable()) {
-        mReadingThread.join();
-    }
+    mReadingTask.join();
     remove_address(m_conf->accessConfig<Pcf8575DriverData>()->addr);
 }
 
@@ -179,7 +177,7 @@ DeviceOperationResult Pcf8575Driver::write_value(std::string_view what, const De
 
 DeviceOperationResult Pcf8575Driver::read_value(std::string_view what, DeviceValues &value) const {
     auto config  = m_conf->accessConfig<const Pcf8575DriverData>();
-    Logger::log(LogLevel::Info, "Reading address : %u value to read : %.*s", 
+    LOG_IF_ENABLED(LogLevel::Info, "Reading address : %u value to read : %.*s",
         static_cast<uint32_t>(config->addr), what.size(), what.data());
 
     uint8_t pin = 0xff;
@@ -210,26 +208,30 @@ DeviceOperationResult Pcf8575Driver::update_runtime_data() {
     return DeviceOperationResult::not_supported;
 }
 
-void Pcf8575Driver::updatePinsThread(std::stop_token token, Pcf8575Driver *instance) {
+MainCoroutineTask Pcf8575Driver::updatePinsTask(std::stop_token token) {
     using namespace std::chrono_literals;
 
+    const auto instance = co_await currentOwner<Pcf8575Driver>();
+
     while(!token.stop_requested()) {
         auto beforeReading = std::chrono::steady_clock::now();
         
         uint16_t readValue = 0;
         auto result = pcf8575_port_read(&instance->m_device, &readValue);
         if (result == ESP_OK) {
-            Logger::log(LogLevel::Info, "Read value : %u for pcf8575", static_cast<uint32_t>(readValue));
+            LOG_IF_ENABLED(LogLevel::Info, "Read value : %u for pcf8575", static_cast<uint32_t>(readValue));
         } else {
+            // Don't keep the worker busy with retries
+            co_await sleepFor(500ms);
             continue;
         }
 
         instance->readValue.exchange(readValue);
 
         const auto duration = std::chrono::steady_clock::now() - beforeReading;
-        std::this_thread::sleep_for(duration < 5s ? 5s - duration : 500ms);
+        co_await sleepFor(duration < 5s ? std::chrono::duration_cast<std::chrono::milliseconds>(5s - duration) : 500ms);
     }
-    Logger::log(LogLevel::Info, "Exiting updatePinsThread");
+    Logger::log(LogLevel::Info, "Exiting updatePinsTask");
 }
 
 bool Pcf8575Driver::add_address(Pcf8575Address address) {
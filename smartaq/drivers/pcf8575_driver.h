@@ -5,7 +5,7 @@
 #include <atomic>
 #include <cstdint>
 #include <charconv>
-#include <thread>
+#include <stop_token>
 #include <limits>
 #include <string_view>
 #include <type_traits>
@@ -75,7 +75,7 @@ class Pcf8575Driver final {
         DeviceOperationResult update_runtime_data();
     private:
         Pcf8575Driver(const DeviceConfig*conf, i2c_dev_t device);
-        static void updatePinsThread(std::stop_token token, Pcf8575Driver *instance);
+        static MainCoroutineTask updatePinsTask(std::stop_token token);
 
         static bool add_address(Pcf8575Address address);
         static bool remove_address(Pcf8575Address address);
@@ -85,7 +85,7 @@ class Pcf8575Driver final {
         mutable i2c_dev_t m_device;
         std::atomic_uint16_t readValue;
         uint16_t writtenValue = std::numeric_limits<uint16_t>::max();
-        std::jthread mReadingThread;
+        MainCoroutineTask mReadingTask;
 
         static inline FixedSizeOptionalArray<Pcf8575Address, 4> _device_addresses;
         static inline std::shared_mutex _instance_mutex;
@@ -190,7 +190,11 @@ DeviceOperationResult PicoDeviceDriver::write_value(std::string_view what, const
     // Format is 12FPWM
     // index -> 12
     // tag -> FPWM
-    auto copyString = SmallerBufferPoolType::get_free_buffer();
+    auto copyString = BufferPoolType::wait_for_free_buffer(small_buffer_size, buffer_wait_timeout);
+
+    if (!copyString.has_value()) {
+        return DeviceOperationResult::failure;
+    }
 
     if (what.size() >= copyString->size()) {
         // Shouldn't really happen
@@ -258,7 +262,11 @@ DeviceOperationResult PicoDeviceDriver::read_value(std::string_view what, Device
     // Format is 12FPWM
     // index -> 12
     // tag -> FPWM
-    auto copyString = SmallerBufferPoolType::get_free_buffer();
+    auto copyString = BufferPoolType::wait_for_free_buffer(small_buffer_size, buffer_wait_timeout);
+
+    if (!copyString.has_value()) {
+        return DeviceOperationResult::failure;
+    }
 
     if (what.size() >= copyString->size()) {
         // Shouldn't really happen
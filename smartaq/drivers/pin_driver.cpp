@@ -77,13 +77,14 @@ bool PinDriver::adjustTimedValue(const DeviceValues& value, const PinConfig *pin
         static_cast<int>(!pinConf->invert));
     gpio_set_level(static_cast<gpio_num_t>(pinConf->gpio_num), !pinConf->invert);
 
-    auto timedTask = MainTaskPool::postTask(TaskDescription{
+    auto timedTask = mainTaskPool.postTask(TaskDescription{
         .single_shot = true,
         .func_ptr = &resetPinTimed,
         .interval = secondsTillReset,
         .argument = this,
         .description = "Reset gpio to previous value",
-        .last_executed = steady_clock::now()
+        .last_executed = steady_clock::now(),
+        .priority = TaskPriority::control
     });
 
     if (timedTask.id() == TaskId::invalid) {
@@ -224,7 +224,7 @@ std::optional<ScheduleDriver> ScheduleDriver::create_driver(const DeviceConfig *
     }
 
     auto createdConf = device_conf_out->accessConfig<ScheduleDriverData>();
-    auto buffer = LargeBufferPoolType::get_free_buffer();
+    auto buffer = BufferPoolType::get_free_buffer(large_buffer_size);
 
     if (!buffer.has_value()) {
         Logger::log(LogLevel::Warning, "Couldn't get a free buffer");
@@ -345,7 +345,7 @@ DeviceOperationResult ScheduleDriver::updateValues() {
         return DeviceOperationResult::failure;
     }
 
-    Logger::log(LogLevel::Debug, "ScheduleDriver::updateValues @ %d:%d:%d", currentDate->tm_hour, currentDate->tm_min, currentDate->tm_sec);
+    LOG_IF_ENABLED(LogLevel::Debug, "ScheduleDriver::updateValues @ %d:%d:%d", currentDate->tm_hour, currentDate->tm_min, currentDate->tm_sec);
 
     const auto newValues = scheduleTracker.getCurrentChannelValues(*currentDate);
 
@@ -363,7 +363,7 @@ DeviceOperationResult ScheduleDriver::updateValues() {
 
         const auto currentDeviceIndex = *scheduleDriverConf->deviceIndices[i];
 
-        Logger::log(LogLevel::Info, "Creating with channel_unit %d", (int) scheduleDriverConf->channelUnit[i]);
+        LOG_IF_ENABLED(LogLevel::Info, "Creating with channel_unit %d", (int) scheduleDriverConf->channelUnit[i]);
         const auto newValue = DeviceValues::create_from_unit(scheduleDriverConf->channelUnit[i], currentValue);
 
         if (newValue.getUnit() == DeviceValueUnit::none)
@@ -374,8 +374,8 @@ DeviceOperationResult ScheduleDriver::updateValues() {
 
         const auto setResult = writeDeviceValue(currentDeviceIndex, scheduleDriverConf->deviceArguments[i].getStringView(), newValue, true);
 
-        Logger::log(LogLevel::Debug, "Writing to device %s(%d)/%s -> %f", scheduleDriverConf->channelNames[i].data(),
-                    currentDeviceIndex, scheduleDriverConf->deviceArguments[i].data(), currentValue);
+        LOG_IF_ENABLED(LogLevel::Debug, "Writing to device %s(%d)/%s -> %f", scheduleDriverConf->channelNames[i].data(),
+                       currentDeviceIndex, scheduleDriverConf->deviceArguments[i].data(), currentValue);
 
         if (!setResult)
         {
@@ -82,6 +82,7 @@ class StatsDriver final {
         };
 
         static inline std::once_flag _task_initialized{};
+        static inline MainTaskPool::TaskResourceType _stats_task{};
         static inline std::shared_mutex _instance_mutex{};
         static inline StatsData _data;
 };
@@ -173,12 +174,16 @@ template<size_t N>
 void StatsDriver<N>::init_task() {
     std::call_once(_task_initialized, []{
         Logger::log(LogLevel::Info, "Adding stats_task to TaskPool");
-        TaskPool<max_task_pool_size>::postTask(TaskDescription{
+        _stats_task = mainTaskPool.postTask(TaskDescription{
                 .single_shot = false,
                 .func_ptr = StatsDriver<N>::stats_driver_task,
                 .interval = std::chrono::minutes{1},
                 .argument = nullptr,
-                .description = "Stats updater thread"
+                .description = "Stats updater thread",
+                .priority = TaskPriority::housekeeping,
+                .rate_mode = TaskRateMode::fixedRate,
+                .catch_up = TaskCatchUpPolicy::skipMissed,
+                .slack = std::chrono::seconds{10}
         });
     });
 }
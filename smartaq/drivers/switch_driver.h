@@ -248,13 +248,13 @@ template <typename C>
 
     if (std::fabs(*maxAllowedDifference) > std::fabs(*differenceAsFloat))
     {
-        Logger::log(LogLevel::Debug, "Difference is small enough switch to do the neutral action [%f, %f] < %f",
-                    -*maxAllowedDifference, *maxAllowedDifference, *differenceAsFloat);
+        LOG_IF_ENABLED(LogLevel::Debug, "Difference is small enough switch to do the neutral action [%f, %f] < %f",
+                       -*maxAllowedDifference, *maxAllowedDifference, *differenceAsFloat);
         return { switchConfig->neutralValueArgument };
     }
 
-    Logger::log(LogLevel::Debug, "Difference is large enough for this switch to do a low or high action %f < %f",
-                *maxAllowedDifference, *differenceAsFloat);
+    LOG_IF_ENABLED(LogLevel::Debug, "Difference is large enough for this switch to do a low or high action %f < %f",
+                   *maxAllowedDifference, *differenceAsFloat);
     // targetValue > currentValue => lowValue
     if (differenceAsFloat < 0) {
         return { switchConfig->lowValueArgument };
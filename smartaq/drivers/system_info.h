@@ -1,9 +1,14 @@
 #pragma once
 
 #include "esp_heap_caps.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "sdkconfig.h"
 
 #include <cstdio>
 
+#include "build_config.h"
+
 enum struct DeviceKind {
     ESPDevice
 };
@@ -16,6 +21,7 @@ class SystemInfo<DeviceKind::ESPDevice> {
     public:
         static inline int printSystemHealthToString(char *out, size_t len);
         static inline int printHeapInfoToString(char *out, size_t len);
+        static inline int printTaskInfoToString(char *out, size_t len);
     private:
 };
 
@@ -27,6 +33,13 @@ inline int SystemInfo<DeviceKind::ESPDevice>::printSystemHealthToString(char *ou
         return -1;
     }
 
+    const size_t remainingLen = len - (startForNextOutput - out);
+    if (auto bytesWritten = printTaskInfoToString(startForNextOutput, remainingLen); bytesWritten < remainingLen && bytesWritten >= 0) {
+        startForNextOutput += bytesWritten;
+    } else {
+        return -1;
+    }
+
     return startForNextOutput - out;
 }
 
@@ -44,4 +57,23 @@ inline int SystemInfo<DeviceKind::ESPDevice>::printHeapInfoToString(char *out, s
                             );
 }
 
+// Every coroutine task replaces a thread with the default pthread stack
+inline int SystemInfo<DeviceKind::ESPDevice>::printTaskInfoToString(char *out, size_t len) {
+    const auto coroutines = CoroutineTaskCounters::statistics();
+    const auto replacedStackBytes = static_cast<int>(coroutines.runningTasks) * CONFIG_PTHREAD_TASK_STACK_SIZE_DEFAULT;
+
+    return std::snprintf(out, len,
+                            "[Begin Report Tasks]\n"
+                            "Threads                        : %10u\n"
+                            "Coroutine tasks                : %10u\n"
+                            "Coroutine frame bytes          : %10u\n"
+                            "Saved stack bytes              : %10d\n"
+                            "[End Report Tasks]\n",
+                            static_cast<unsigned int>(uxTaskGetNumberOfTasks()),
+                            static_cast<unsigned int>(coroutines.runningTasks),
+                            static_cast<unsigned int>(coroutines.frameBytes),
+                            replacedStackBytes - static_cast<int>(coroutines.frameBytes)
+                            );
+}
+
 using CurrentSystem = SystemInfo<DeviceKind::ESPDevice>;
\ No newline at end of file
@@ -10,6 +10,8 @@
 #include "network/webserver.h"
 #include "rest/devices_rest.h"
 #include "rest/settings_rest.h"
+#include "rest/tasks_rest.h"
+#include "rest/logs_rest.h"
 #include "utils/logger.h"
 #include "utils/esp/idf_utils.h"
 
@@ -22,6 +24,7 @@
 #include "utils/memory_helper.h"
 
 std::unique_ptr<GlobalStoreType, SPIRAMDeleter<GlobalStoreType> > globalStore;
+MainTaskPool mainTaskPool;
 
 void init_timezone() {
     setenv("TZ", "CET-1CEST,M3.5.0,M10.5.0/3", true);
@@ -29,7 +32,27 @@ void init_timezone() {
 }
 
 void print_health(void *) {
-    auto buffer = LargeBufferPoolType::get_free_buffer();
+    // Reported before a buffer is borrowed, so an exhausted pool is reported as well
+    BufferPoolType::forEachSizeClassMetrics([](const BufferSizeClassMetrics &metrics) {
+        Logger::log(LogLevel::Info, "Buffers of %u bytes : %u of %u borrowed, high water mark %u, failed %u, "
+                    "waited <1ms %u, <10ms %u, <100ms %u, <1s %u, longer %u",
+                    static_cast<unsigned int>(metrics.bufferSize),
+                    static_cast<unsigned int>(metrics.borrowedBuffers),
+                    static_cast<unsigned int>(metrics.numBuffers),
+                    static_cast<unsigned int>(metrics.highWaterMark),
+                    static_cast<unsigned int>(metrics.failedAcquisitions),
+                    static_cast<unsigned int>(metrics.waitTimeHistogram[0]),
+                    static_cast<unsigned int>(metrics.waitTimeHistogram[1]),
+                    static_cast<unsigned int>(metrics.waitTimeHistogram[2]),
+                    static_cast<unsigned int>(metrics.waitTimeHistogram[3]),
+                    static_cast<unsigned int>(metrics.waitTimeHistogram[4]));
+    });
+
+    auto buffer = BufferPoolType::get_free_buffer(large_buffer_size);
+
+    if (!buffer.has_value()) {
+        return;
+    }
 
     std::time_t now;
     std::tm timeinfo{};
@@ -42,19 +65,27 @@ void print_health(void *) {
 
     Logger::log(LogLevel::Warning, "%s", buffer->data());
     Logger::log(LogLevel::Warning, "%s", timeout.data());
+
+    const auto logStatistics = Logger::statistics();
+
+    if (logStatistics.droppedRecords > 0) {
+        Logger::log(LogLevel::Warning, "Dropped %u log records", static_cast<unsigned int>(logStatistics.droppedRecords));
+    }
+
+    if (logStatistics.suppressedRecords > 0) {
+        Logger::log(LogLevel::Warning, "Suppressed %u log records",
+                    static_cast<unsigned int>(logStatistics.suppressedRecords));
+    }
 }
 
-void *doWork(void *)
+// The worker index is passed as the thread argument
+void *doWork(void *arg)
 {
-    auto resource = MainTaskPool::postTask(TaskDescription{
-         .single_shot = false,
-         .func_ptr = print_health,
-         .interval = std::chrono::seconds(10),
-         .argument = nullptr,
-         .description = "Heartbeat Thread"
-     });
+    const auto workerIndex = reinterpret_cast<uintptr_t>(arg);
+
+    mainTaskPool.doWork(workerIndex);
 
-    MainTaskPool::doWork();
+    return nullptr;
 }
 
 void *doWorkThread(void *arg)
@@ -65,13 +96,13 @@ void *doWorkThread(void *arg)
 }
 
 
-std::optional<pthread_t> addThread(pthread_attr_t& attributes)
+std::optional<pthread_t> addThread(pthread_attr_t& attributes, uintptr_t workerIndex)
 {
     pthread_t handle;
 
     //pthread_attr_setstack(&attributes, pthreadStack.get(), stackSize);
     // Only stack size can be set on esp-idf
-    int result = pthread_create(&handle, &attributes, doWorkThread, nullptr);
+    int result = pthread_create(&handle, &attributes, doWorkThread, reinterpret_cast<void *>(workerIndex));
     if (result != 0) {
         ESP_LOGE("Main", "Couldn't start main thread");
         return {};
@@ -118,7 +149,11 @@ void *mainTask(void *) {
     api_server.registerHandler("/api/v1/devices",
                                CombinedFlagsAtPos<uint32_t,
                                    HTTP_GET, HTTP_POST, HTTP_PUT, HTTP_DELETE, HTTP_PATCH>,
-                               do_devices);
+                               do_devices, WebServerHandlerMemory::requestArena);
+    api_server.registerHandler("/api/v1/tasks", CombinedFlagsAtPos<uint32_t, HTTP_GET>, do_tasks,
+                               WebServerHandlerMemory::requestArena);
+    api_server.registerHandler("/api/v1/logs", CombinedFlagsAtPos<uint32_t, HTTP_GET>, do_logs,
+                               WebServerHandlerMemory::requestArena);
     api_server.registerHandler("api/v1/settings", CombinedFlagsAtPos<uint32_t, HTTP_GET, HTTP_POST, HTTP_PUT>,
                                do_settings);
 
@@ -130,13 +165,42 @@ void *mainTask(void *) {
     pthread_attr_init(&attributes);
     pthread_attr_setstacksize(&attributes, stack_size);
 
-    constexpr size_t additionalNumThreads = 2;
+    auto heartbeat = mainTaskPool.postTask(TaskDescription{
+         .single_shot = false,
+         .func_ptr = print_health,
+         .interval = std::chrono::seconds(10),
+         .argument = nullptr,
+         .description = "Heartbeat Thread",
+         .priority = TaskPriority::housekeeping,
+         .slack = std::chrono::seconds(5)
+     });
+
+    // Drivers and workers only queue their records, this task writes them to the sinks
+    auto logDrain = mainTaskPool.postTask(TaskDescription{
+         .single_shot = false,
+         .func_ptr = Logger::drainTask,
+         .interval = std::chrono::milliseconds(100),
+         .argument = nullptr,
+         .description = "Log drain",
+         .priority = TaskPriority::housekeeping,
+         .slack = std::chrono::milliseconds(100)
+     });
+
+    if (logDrain.isActive()) {
+        Logger::enableAsync(LogOverflowPolicy::dropOldest, LogEncoding::binary);
+    }
+
+    // Failing sensors and busses would otherwise log the same warnings forever
+    Logger::enableRateLimit();
+
+    // This thread is the first worker of the pool
+    constexpr size_t additionalNumThreads = MainTaskPool::numWorkers() - 1;
 
     std::array<std::optional<pthread_t>, additionalNumThreads> handles;
 
-    for (auto &currentHandle : handles)
+    for (size_t i = 0; i < handles.size(); ++i)
     {
-        currentHandle = addThread(attributes);
+        handles[i] = addThread(attributes, i + 1);
     }
 
     doWork(nullptr);
@@ -25,10 +25,17 @@
 
 #include "utils/esp/web_utils.h"
 #include "utils/large_buffer_pool.h"
+#include "utils/request_arena.h"
 #include "utils/ssl_credentials.h"
 #include "utils/logger.h"
 #include "build_config.h"
 
+// Handlers, which use RequestArena::current(), get a pooled buffer for every request, the others don't
+enum struct WebServerHandlerMemory {
+    none,
+    requestArena
+};
+
 enum struct WebServerSecurityLevel {
     unsecured,
     #ifdef ENABLE_HTTPS
@@ -151,6 +158,7 @@ class WebServer final {
         std::string_view prefix = "";
         uint64_t methods = 0;
         esp_err_t (*handler)(httpd_req *req);
+        WebServerHandlerMemory memory = WebServerHandlerMemory::none;
     };
 
    public:
@@ -164,7 +172,8 @@ class WebServer final {
     WebServer &operator=(const WebServer &other) = delete;
     WebServer &operator=(WebServer &&other) = delete;
 
-    void registerHandler(std::string_view prefix, uint32_t methods, esp_err_t (*handler)(httpd_req *req)) {
+    void registerHandler(std::string_view prefix, uint32_t methods, esp_err_t (*handler)(httpd_req *req),
+                         WebServerHandlerMemory memory = WebServerHandlerMemory::none) {
         if (prefix.empty()) {
             return;
         }
@@ -181,7 +190,8 @@ class WebServer final {
         *firstFreeSlot = Handler{
                 .prefix = prefix,
                 .methods = methods,
-                .handler = handler
+                .handler = handler,
+                .memory = memory
         };
     }
 
@@ -192,7 +202,8 @@ class WebServer final {
         m_handler[m_handler.size() - 1] = Handler{
             .prefix = "",
             .methods = 1 << static_cast<uint8_t>(HTTP_GET),
-            .handler = &getFile
+            .handler = &getFile,
+            .memory = WebServerHandlerMemory::requestArena
         };
     } 
 
@@ -240,7 +251,24 @@ class WebServer final {
             return ESP_FAIL;
         }
 
-        Logger::log(LogLevel::Info, "Found handler with prefix : %s", (*foundHandler)->prefix.data());
+        LOG_IF_ENABLED(LogLevel::Debug, "Found handler with prefix : %s", (*foundHandler)->prefix.data());
+
+        if ((*foundHandler)->memory == WebServerHandlerMemory::none) {
+            return (*foundHandler)->handler(req);
+        }
+
+        // Everything the handler needs for this request is carved out of one pooled buffer,
+        // which is given back at once, when the handler returns
+        auto arenaBuffer = BufferPoolType::wait_for_free_buffer(large_buffer_size, buffer_wait_timeout);
+
+        if (!arenaBuffer) {
+            Logger::log(LogLevel::Error, "Failed to get buffer for the request");
+            httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "Out of memory");
+            return ESP_OK;
+        }
+
+        RequestArena arena(arenaBuffer->data(), arenaBuffer->size());
+        RequestArenaScope arenaScope(arena);
 
         return (*foundHandler)->handler(req);
     }
@@ -316,36 +344,46 @@ esp_err_t WebServer<level>::getFile(httpd_req_t *req) {
     }
 
     struct stat tmp_stat{};
-    auto filepath = SmallerBufferPoolType::get_free_buffer();
+    auto *arena = RequestArena::current();
+    auto filepath = arena != nullptr ? arena->allocateArray<char>(small_buffer_size) : std::span<char>{};
     std::string_view selected_path;
     std::string_view request_uri{req->uri};
 
+    if (filepath.empty()) {
+        Logger::log(LogLevel::Error, "Failed to get buffer");
+        /* Respond with 500 Internal Server Error */
+        httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR,
+                            "Failed to read existing file");
+        return ESP_FAIL;
+    }
+
     httpd_resp_set_hdr(req, "Access-Control-Allow-Origin", "*");
     httpd_resp_set_hdr(req, "Connection", "Keep-Alive");
     httpd_resp_set_hdr(req, "Keep-Alive", "timeout=1, max=1000");
 
-    std::strncpy(filepath->data(), base_path, filepath->size() - 1);
+    std::strncpy(filepath.data(), base_path, filepath.size() - 1);
 
     // TODO: Remove trailing /
     if (request_uri == "/") {
-        strncat(filepath->data(), "/index.html", filepath->size() - 1);
+        strncat(filepath.data(), "/index.html", filepath.size() - 1);
     } else {
-        strncat(filepath->data(), request_uri.data(), filepath->size() - 1);
+        strncat(filepath.data(), request_uri.data(), filepath.size() - 1);
     }
 
-    if (stat(filepath->data(), &tmp_stat) < 0) {
-        Logger::log(LogLevel::Error, "Failed to open file or directory : %s", filepath->data());
+    if (stat(filepath.data(), &tmp_stat) < 0) {
+        Logger::log(LogLevel::Error, "Failed to open file or directory : %s", filepath.data());
         /* Respond with 500 Internal Server Error */
         httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR,
                             "Path doesn't exist");
         return ESP_FAIL;
     }
 
-    selected_path = filepath->data();
+    selected_path = filepath.data();
 
-    auto buffer = LargeBufferPoolType::get_free_buffer();
+    // The file is sent in chunks of the rest of the arena
+    auto buffer = arena->allocateRemaining();
 
-    if (!buffer.has_value()) {
+    if (buffer.empty()) {
         Logger::log(LogLevel::Error, "Failed to get buffer");
         /* Respond with 500 Internal Server Error */
         httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR,
@@ -389,10 +427,10 @@ esp_err_t WebServer<level>::getFile(httpd_req_t *req) {
             return true;
         };
 
-        int written_bytes = generate_link_list_website(buffer->data(), buffer->size(), gen_link);
+        int written_bytes = generate_link_list_website(buffer.data(), buffer.size(), gen_link);
 
         if (written_bytes != -1) {
-            send_in_chunks(req, buffer->data(), written_bytes);
+            send_in_chunks(req, buffer.data(), written_bytes);
         } else {
             Logger::log(LogLevel::Error, "Buffer was too small for website");
             /* Respond with 500 Internal Server Error */
@@ -410,29 +448,29 @@ esp_err_t WebServer<level>::getFile(httpd_req_t *req) {
         });
 
         if (fd == -1) {
-            Logger::log(LogLevel::Warning, "Failed to open file : %s", filepath->data());
+            Logger::log(LogLevel::Warning, "Failed to open file : %s", filepath.data());
             /* Respond with 500 Internal Server Error */
             httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR,
                                 "Failed to read existing file");
             return ESP_FAIL;
         }
 
-        setContentTypeFromFile(req, filepath->data());
+        setContentTypeFromFile(req, filepath.data());
 
         ssize_t read_bytes;
         // TODO: make configurable
-        auto max_chunk_size = std::min<size_t>(buffer->size(), 4096);
+        auto max_chunk_size = std::min<size_t>(buffer.size(), 4096);
         do {
             /* Read file in chunks into the scratch buffer */
-            read_bytes = read(fd, buffer->data(), max_chunk_size);
+            read_bytes = read(fd, buffer.data(), max_chunk_size);
             if (read_bytes == -1) {
-                Logger::log(LogLevel::Warning, "Failed to read file : %s", filepath->data());
+                Logger::log(LogLevel::Warning, "Failed to read file : %s", filepath.data());
             } else if (read_bytes > 0) {
                 /* Send the buffer contents as HTTP response chunk */
-                esp_err_t last_result = httpd_resp_send_chunk(req, buffer->data(), read_bytes);
+                esp_err_t last_result = httpd_resp_send_chunk(req, buffer.data(), read_bytes);
 
                 if (last_result != ESP_OK) {
-                    Logger::log(LogLevel::Warning, "File sending failed! %s", filepath->data());
+                    Logger::log(LogLevel::Warning, "File sending failed! %s", filepath.data());
                     /* Abort sending file */
                     httpd_resp_send_chunk(req, nullptr, 0);
                     /* Respond with 500 Internal Server Error */
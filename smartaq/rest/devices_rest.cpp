@@ -13,6 +13,7 @@
 #include "utils/esp/esp_filesystem_utils.h"
 #include "utils/logger.h"
 #include "utils/esp/web_utils.h"
+#include "utils/request_arena.h"
 #include "build_config.h"
 
 #include "runtime_access.h"
@@ -30,9 +31,14 @@ static constexpr ctll::fixed_string pattern{R"(\/api\/v1\/devices\/(?<index>[0-9
 esp_err_t do_devices(httpd_req *req) {
     Logger::log(LogLevel::Info, "This thread id %d", std::this_thread::get_id());
     Logger::log(LogLevel::Info, "Handle uri %s", req->uri);
-    auto buffer = LargeBufferPoolType::get_free_buffer();
-
-    if (!buffer) {
+    // The input and the answer get a whole large buffer, the header values are short,
+    // so the actions take the rest of the arena for their temporaries
+    auto *arena = RequestArena::current();
+    auto headerParamBuffer = arena != nullptr ? arena->allocateArray<char>(small_buffer_size) : std::span<char>{};
+    auto answerBuffer = BufferPoolType::wait_for_free_buffer(large_buffer_size, buffer_wait_timeout);
+    auto buffer = answerBuffer.has_value() ? std::span<char>(answerBuffer->data(), answerBuffer->size()) : std::span<char>{};
+
+    if (headerParamBuffer.empty() || buffer.empty()) {
         httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "Out of memory");
         return ESP_OK;
     }
@@ -41,36 +47,35 @@ esp_err_t do_devices(httpd_req *req) {
     auto [complete_match, index, what] = ctre::match<pattern>(req->uri);
 
     Logger::log(LogLevel::Debug, "Receiving input for device");
-    if (req->content_len < buffer->size()) {
-        httpd_req_recv(req, buffer->data(), req->content_len);
+    if (req->content_len < buffer.size()) {
+        httpd_req_recv(req, buffer.data(), req->content_len);
     } else {
         // This is too large for the buffer, this has to be received chunk-wise
         Logger::log(LogLevel::Info, "Has to be received chunk-wise");
         // httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "Input too long, not handled yet ...");
     }
 
-    auto headerParamBuffer = LargeBufferPoolType::get_free_buffer();
-    auto acceptLen = getHeaderValue<char *>(req, "Accept", headerParamBuffer->data(), headerParamBuffer->size());
+    auto acceptLen = getHeaderValue<char *>(req, "Accept", headerParamBuffer.data(), headerParamBuffer.size());
     auto acceptType = ContentType::Default;
 
     if (acceptLen) {
         // TODO: improve this somehow 
-        if (std::string_view acceptTypeStr(headerParamBuffer->data(), acceptLen); 
+        if (std::string_view acceptTypeStr(headerParamBuffer.data(), acceptLen); 
                 acceptTypeStr.compare("application/octet-stream") == 0) {
             acceptType = ContentType::Binary;
         } 
-        Logger::log(LogLevel::Info, "Accept : %.*s ", acceptLen, headerParamBuffer->data());
+        Logger::log(LogLevel::Info, "Accept : %.*s ", acceptLen, headerParamBuffer.data());
     }
 
-    auto contentLen = getHeaderValue<char *>(req, "Content-Type", headerParamBuffer->data(), headerParamBuffer->size());
+    auto contentLen = getHeaderValue<char *>(req, "Content-Type", headerParamBuffer.data(), headerParamBuffer.size());
     auto contentType = ContentType::Default; 
 
     if (contentLen) {
-        if (std::string_view contentTypeStr(headerParamBuffer->data(), contentLen);
+        if (std::string_view contentTypeStr(headerParamBuffer.data(), contentLen);
                 contentTypeStr.compare("application/octet-stream") == 0) {
             contentType = ContentType::Binary;
         }
-        Logger::log(LogLevel::Info, "Content-Type : %.*s ", contentLen, headerParamBuffer->data());
+        Logger::log(LogLevel::Info, "Content-Type : %.*s ", contentLen, headerParamBuffer.data());
     }
 
     unsigned int contentLength = 0;
@@ -86,22 +91,22 @@ esp_err_t do_devices(httpd_req *req) {
             const std::string_view whatView = what.to_view();
             if (whatView.starts_with("/info")) {
                 result = get_device_info(index_value, whatView.data(), whatView.size(),
-                                         buffer->data(), buffer->size());
+                                         buffer.data(), buffer.size());
             } else {
                 result = get_devices_action(index_value, whatView.data(), whatView.size(),
-                buffer->data(), buffer->size());
+                buffer.data(), buffer.size());
             }
         } else if (req->method == HTTP_PUT && !what) {
-            result = add_device_action(index_value, buffer->data(), req->content_len, buffer->data(), buffer->size());
+            result = add_device_action(index_value, buffer.data(), req->content_len, buffer.data(), buffer.size());
         } else if (req->method == HTTP_PUT && what) {
-            result = write_device_options_action(index_value, what.to_view().data(), buffer->data(), req->content_len, buffer->data(), buffer->size());
+            result = write_device_options_action(index_value, what.to_view().data(), buffer.data(), req->content_len, buffer.data(), buffer.size());
         } else if (req->method == HTTP_DELETE) {
-            result = remove_device_action(index_value, buffer->data(), req->content_len, buffer->data(), buffer->size());
+            result = remove_device_action(index_value, buffer.data(), req->content_len, buffer.data(), buffer.size());
         } else if (req->method == HTTP_PATCH) {
             if (what) {
-                result = set_device_action(index_value, what.to_view().data(), buffer->data(), req->content_len, buffer->data(), buffer->size());
+                result = set_device_action(index_value, what.to_view().data(), buffer.data(), req->content_len, buffer.data(), buffer.size());
             } else {
-                result = set_device_action(index_value, std::string_view("", 0), buffer->data(), req->content_len, buffer->data(), buffer->size());
+                result = set_device_action(index_value, std::string_view("", 0), buffer.data(), req->content_len, buffer.data(), buffer.size());
             }
         }
 
@@ -120,7 +125,7 @@ esp_err_t do_devices(httpd_req *req) {
                 return ESP_OK;
             }
 
-            result = get_devices_action(std::nullopt, buffer->data(), req->content_len, buffer->data(), buffer->size());
+            result = get_devices_action(std::nullopt, buffer.data(), req->content_len, buffer.data(), buffer.size());
         } else if (req->method == HTTP_POST) {
             if (contentType == ContentType::Binary) {
                 Logger::log(LogLevel::Info, "Getting partition backup");
@@ -150,14 +155,14 @@ esp_err_t do_devices(httpd_req *req) {
                 Logger::log(LogLevel::Info, "Content-Type is non binary");
             }
 
-            result = add_device_action(std::nullopt, buffer->data(), req->content_len, buffer->data(), buffer->size());
+            result = add_device_action(std::nullopt, buffer.data(), req->content_len, buffer.data(), buffer.size());
         }
     }
 
     Logger::log(LogLevel::Debug, "Sending response from device");
-    if (result.answer_len && buffer->data()[0] != '\0') {
+    if (result.answer_len && buffer.data()[0] != '\0') {
         httpd_resp_set_type(req, "application/json");
-        send_in_chunks(req, buffer->data(), result.answer_len);
+        send_in_chunks(req, buffer.data(), result.answer_len);
     } else if (result.answer_len == 0 && result.result == JsonActionResultStatus::success) {
         httpd_resp_set_status(req, HTTPD_204);
         httpd_resp_send(req, "", 0);
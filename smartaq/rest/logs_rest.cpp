@@ -0,0 +1,54 @@
+#include "logs_rest.h"
+
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+
+#include "actions/log_actions.h"
+#include "utils/esp/web_utils.h"
+#include "utils/logger.h"
+#include "utils/request_arena.h"
+#include "build_config.h"
+
+// GET /api/v1/logs?since=<seq> returns the kept records after seq, all of them without since
+// Doesn't log the request, otherwise every poll of a client would add a record
+esp_err_t do_logs(httpd_req *req) {
+    if (req->method != HTTP_GET) {
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Only GET is supported");
+        return ESP_OK;
+    }
+
+    uint32_t since = 0;
+    std::array<char, 64> query{};
+    std::array<char, 16> sinceValue{};
+
+    if (httpd_req_get_url_query_str(req, query.data(), query.size()) == ESP_OK
+        && httpd_query_key_value(query.data(), "since", sinceValue.data(), sinceValue.size()) == ESP_OK) {
+        char *end = nullptr;
+        since = static_cast<uint32_t>(std::strtoul(sinceValue.data(), &end, 10));
+
+        if (end == sinceValue.data() || *end != '\0') {
+            httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "since has to be a sequence number");
+            return ESP_OK;
+        }
+    }
+
+    auto *arena = RequestArena::current();
+    auto buffer = arena != nullptr ? arena->allocateRemaining() : std::span<char>{};
+
+    if (buffer.empty()) {
+        httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "Out of memory");
+        return ESP_OK;
+    }
+
+    const auto result = get_logs_action(since, buffer.data(), buffer.size());
+
+    if (result.result == JsonActionResultStatus::success && result.answer_len > 0) {
+        httpd_resp_set_type(req, "application/json");
+        send_in_chunks(req, buffer.data(), result.answer_len);
+    } else {
+        httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "An error happened");
+    }
+
+    return ESP_OK;
+}
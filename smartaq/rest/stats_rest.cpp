@@ -2,23 +2,42 @@
 
 #include <array>
 #include <cstdint>
+#include <optional>
+#include <span>
 
 #include "ctre.hpp"
 #include "frozen.h"
 
 #include "utils/esp/web_utils.h"
 #include "utils/logger.h"
+#include "utils/request_arena.h"
 #include "actions/stats_actions.h"
 #include "build_config.h"
 
 static constexpr ctll::fixed_string pattern{R"(\/api\/v1\/stats\/(?<index>[0-9]+)(?:\/(?<what>\w+)|\/)?)"};
+static constexpr size_t stats_buffer_size = 2048;
 
 esp_err_t do_stats(httpd_req *req) {
     Logger::log(LogLevel::Info, "Handle uri %s", req->uri);
-    std::array<char, 2048> buf;
+    // Keeps the input and the answer off the stack of the http server task,
+    // without a request arena the buffer is borrowed from the pool
+    auto *arena = RequestArena::current();
+    std::optional<BufferPoolType::LargeBufferBorrowerType> pooledBuffer;
+    std::span<char> buf;
+
+    if (arena != nullptr) {
+        buf = arena->allocateArray<char>(stats_buffer_size);
+    } else if (pooledBuffer = BufferPoolType::wait_for_free_buffer(stats_buffer_size, buffer_wait_timeout); pooledBuffer) {
+        buf = std::span<char>(pooledBuffer->data(), stats_buffer_size);
+    }
     JsonActionResult result{};
     auto [complete_match, index, what] = ctre::match<pattern>(req->uri);
 
+    if (buf.empty()) {
+        httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "Out of memory");
+        return ESP_OK;
+    }
+
     if (req->content_len > buf.size()) {
             httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "Input too long");
     }
@@ -47,7 +66,7 @@ esp_err_t do_stats(httpd_req *req) {
     }
 
     if (result.answer_len) {
-        send_in_chunks(req, buf, result.answer_len);
+        send_in_chunks(req, buf.data(), result.answer_len);
     } else {
         httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "An error happened");
     }
@@ -0,0 +1,35 @@
+#include "tasks_rest.h"
+
+#include "actions/task_actions.h"
+#include "utils/esp/web_utils.h"
+#include "utils/logger.h"
+#include "utils/request_arena.h"
+#include "build_config.h"
+
+esp_err_t do_tasks(httpd_req *req) {
+    Logger::log(LogLevel::Info, "Handle uri %s", req->uri);
+
+    if (req->method != HTTP_GET) {
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Only GET is supported");
+        return ESP_OK;
+    }
+
+    auto *arena = RequestArena::current();
+    auto buffer = arena != nullptr ? arena->allocateRemaining() : std::span<char>{};
+
+    if (buffer.empty()) {
+        httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "Out of memory");
+        return ESP_OK;
+    }
+
+    const auto result = get_tasks_action(buffer.data(), buffer.size());
+
+    if (result.result == JsonActionResultStatus::success && result.answer_len > 0) {
+        httpd_resp_set_type(req, "application/json");
+        send_in_chunks(req, buffer.data(), result.answer_len);
+    } else {
+        httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "An error happened");
+    }
+
+    return ESP_OK;
+}
@@ -0,0 +1,5 @@
+#pragma once
+
+#include "esp_http_server.h"
+
+esp_err_t do_tasks(httpd_req *req);
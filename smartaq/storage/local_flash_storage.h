@@ -59,7 +59,7 @@ class LocalFlashStorage {
             return false;
         }
 
-        auto buffer = SmallerBufferPoolType::get_free_buffer();
+        auto buffer = BufferPoolType::get_free_buffer(small_buffer_size);
         using LambdaReturnType = decltype(dataSource(buffer));
         static_assert(std::is_integral_v<LambdaReturnType>, "DataSource Return type has to be integral");
         LambdaReturnType toWrite = 0;
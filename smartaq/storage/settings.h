@@ -172,7 +172,7 @@ class FilesystemSetting final {
         }
 
         FILE *openTmpFile(bool createIfNotExists = true) {
-            auto filename = SmallerBufferPoolType::get_free_buffer();
+            auto filename = BufferPoolType::get_free_buffer(small_buffer_size);
             copyFilenameToBuffer(filename, ".tmp");
 
             Logger::log(LogLevel::Info, "Trying to open tmp file : %s", filename->data());
@@ -222,7 +222,7 @@ class FilesystemSetting final {
             }
 
             Logger::log(LogLevel::Info, "Loading from filesystem");
-            auto filename = SmallerBufferPoolType::get_free_buffer();
+            auto filename = BufferPoolType::get_free_buffer(small_buffer_size);
             copyFilenameToBuffer(filename);
 
             Logger::log(LogLevel::Debug, "Trying to open file : %s", filename->data());
@@ -289,8 +289,8 @@ class FilesystemSetting final {
 
             int rename_result = -1;
             if (written_size == 1) {
-                auto filename = SmallerBufferPoolType::get_free_buffer();
-                auto tmp_filename = SmallerBufferPoolType::get_free_buffer();
+                auto filename = BufferPoolType::get_free_buffer(small_buffer_size);
+                auto tmp_filename = BufferPoolType::get_free_buffer(small_buffer_size);
                 // TODO: check results of both methods
                 copyFilenameToBuffer(tmp_filename, ".tmp");
                 copyFilenameToBuffer(filename);
@@ -0,0 +1,209 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string_view>
+
+#include "utils/logger.h"
+
+struct BatchingLogSinkStatistics {
+    uint32_t sentBatches = 0;
+    uint32_t failedBatches = 0;
+    // Didn't fit into the batch, while the remote host was unavailable
+    uint32_t droppedRecords = 0;
+};
+
+/**
+ * \brief A log sink, which collects the records in a buffer and sends them as one JSON array.
+ *
+ * The batch is sent, once it is filled to the flush threshold or the oldest record waited for the flush interval.
+ * Sending is left to the Transport, which has to provide
+ *  - bool send(const char *data, size_t length), which may keep its connection open between calls
+ *  - void disconnect()
+ *  - const char *deviceId()
+ * If sending fails, the records are kept and the next attempt is delayed, the delay doubles with every failed
+ * attempt up to maxBackoff. Records, which don't fit into the buffer in the meantime, are dropped.
+ * Like all sinks, it is only used with the sink mutex of the logger held.
+ */
+template<typename Transport, size_t BatchSize = 1024, typename Clock = std::chrono::steady_clock>
+class BatchingLogSink final {
+    public:
+        static constexpr std::chrono::milliseconds flushInterval{5000};
+        static constexpr std::chrono::milliseconds minBackoff{1000};
+        static constexpr std::chrono::milliseconds maxBackoff{60000};
+        static constexpr size_t flushThreshold = BatchSize * 3 / 4;
+
+        bool install() { return true; }
+
+        bool uninstall() {
+            (void) flush();
+            mTransport.disconnect();
+            return true;
+        }
+
+        template<typename ... Arguments>
+        bool log(LogLevel level, const char *fmt, Arguments && ... args);
+
+        // Sends the batch, if it is due, so records are sent, even if nothing is logged afterwards
+        void poll();
+
+        // Sends the batch right away, unless the remote host is backed off
+        bool flush();
+
+        [[nodiscard]] size_t pendingRecords() const { return mRecords; }
+        [[nodiscard]] BatchingLogSinkStatistics statistics() const { return mStatistics; }
+        Transport &transport() { return mTransport; }
+
+    private:
+        bool appendRecord(LogLevel level, std::string_view message);
+        bool append(std::string_view text);
+        bool appendEscaped(std::string_view text);
+        [[nodiscard]] bool isDue(typename Clock::time_point now) const;
+
+        Transport mTransport;
+        // Always holds the opening bracket, the records separated by commas, but not the closing bracket
+        std::array<char, BatchSize> mBatch{};
+        size_t mLength = 0;
+        size_t mRecords = 0;
+        typename Clock::time_point mFirstRecordAt{};
+        typename Clock::time_point mNextAttemptAt{};
+        std::chrono::milliseconds mBackoff = minBackoff;
+        BatchingLogSinkStatistics mStatistics{};
+};
+
+template<typename Transport, size_t BatchSize, typename Clock>
+template<typename ... Arguments>
+bool BatchingLogSink<Transport, BatchSize, Clock>::log(LogLevel level, const char *fmt, Arguments && ... args) {
+    std::array<char, 256> message{};
+    const auto written = snprintf(message.data(), message.size(), fmt, args ...);
+
+    if (written < 0) {
+        return false;
+    }
+
+    const std::string_view messageView(message.data(), std::min(static_cast<size_t>(written), message.size() - 1));
+
+    if (!appendRecord(level, messageView)) {
+        // The batch is full, make room and try again
+        if (!flush() || !appendRecord(level, messageView)) {
+            ++mStatistics.droppedRecords;
+            return false;
+        }
+    }
+
+    poll();
+    return true;
+}
+
+template<typename Transport, size_t BatchSize, typename Clock>
+void BatchingLogSink<Transport, BatchSize, Clock>::poll() {
+    if (mRecords > 0 && isDue(Clock::now())) {
+        (void) flush();
+    }
+}
+
+template<typename Transport, size_t BatchSize, typename Clock>
+bool BatchingLogSink<Transport, BatchSize, Clock>::isDue(typename Clock::time_point now) const {
+    return mLength >= flushThreshold || now - mFirstRecordAt >= flushInterval;
+}
+
+template<typename Transport, size_t BatchSize, typename Clock>
+bool BatchingLogSink<Transport, BatchSize, Clock>::flush() {
+    const auto now = Clock::now();
+
+    if (mRecords == 0) {
+        return true;
+    }
+
+    if (now < mNextAttemptAt) {
+        return false;
+    }
+
+    // There is always room for the closing bracket
+    mBatch[mLength] = ']';
+
+    if (!mTransport.send(mBatch.data(), mLength + 1)) {
+        ++mStatistics.failedBatches;
+        mNextAttemptAt = now + mBackoff;
+        mBackoff = std::min(mBackoff * 2, maxBackoff);
+        return false;
+    }
+
+    ++mStatistics.sentBatches;
+    mLength = 0;
+    mRecords = 0;
+    mBackoff = minBackoff;
+    mNextAttemptAt = {};
+    return true;
+}
+
+// Appends the whole record or nothing
+template<typename Transport, size_t BatchSize, typename Clock>
+bool BatchingLogSink<Transport, BatchSize, Clock>::appendRecord(LogLevel level, std::string_view message) {
+    const auto previousLength = mLength;
+
+    const bool appended = append(mRecords == 0 ? "[" : ",")
+        && append(R"({"device_id":")") && appendEscaped(mTransport.deviceId())
+        && append(R"(","level":")") && append(to_string(level))
+        && append(R"(","msg":")") && appendEscaped(message)
+        && append(R"("})");
+
+    if (!appended) {
+        mLength = previousLength;
+        return false;
+    }
+
+    if (mRecords == 0) {
+        mFirstRecordAt = Clock::now();
+    }
+
+    ++mRecords;
+    return true;
+}
+
+// Keeps one byte for the closing bracket
+template<typename Transport, size_t BatchSize, typename Clock>
+bool BatchingLogSink<Transport, BatchSize, Clock>::append(std::string_view text) {
+    if (mLength + text.size() >= mBatch.size()) {
+        return false;
+    }
+
+    std::memcpy(mBatch.data() + mLength, text.data(), text.size());
+    mLength += text.size();
+    return true;
+}
+
+template<typename Transport, size_t BatchSize, typename Clock>
+bool BatchingLogSink<Transport, BatchSize, Clock>::appendEscaped(std::string_view text) {
+    for (const char current : text) {
+        std::array<char, 8> escaped{};
+        size_t escapedLength = 2;
+        escaped[0] = '\\';
+
+        switch (current) {
+            case '"': escaped[1] = '"'; break;
+            case '\\': escaped[1] = '\\'; break;
+            case '\n': escaped[1] = 'n'; break;
+            case '\r': escaped[1] = 'r'; break;
+            case '\t': escaped[1] = 't'; break;
+            default:
+                if (static_cast<unsigned char>(current) < 0x20) {
+                    escapedLength = snprintf(escaped.data(), escaped.size(), "\\u%04x", static_cast<unsigned int>(current));
+                } else {
+                    escaped[0] = current;
+                    escapedLength = 1;
+                }
+        }
+
+        if (!append(std::string_view(escaped.data(), escapedLength))) {
+            return false;
+        }
+    }
+
+    return true;
+}
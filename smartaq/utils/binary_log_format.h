@@ -0,0 +1,296 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <optional>
+#include <string_view>
+#include <type_traits>
+
+// Tags every encoded argument, so the arguments can be formatted without the types of the call site
+enum struct LogArgumentType : uint8_t {
+    signed32, signed64, unsigned32, unsigned64, floatingPoint, pointer
+};
+
+// Strings may not outlive the log call, so only calls with these arguments are encoded
+template<typename T>
+concept BinaryLogArgument = std::is_arithmetic_v<std::remove_cvref_t<T>>
+    || (std::is_pointer_v<std::remove_cvref_t<T>>
+        && !std::is_same_v<std::remove_cv_t<std::remove_pointer_t<std::remove_cvref_t<T>>>, char>);
+
+namespace Detail {
+    template<typename T>
+    constexpr LogArgumentType logArgumentTypeOf() {
+        using ValueType = std::remove_cvref_t<T>;
+
+        if constexpr (std::is_pointer_v<ValueType>) {
+            return LogArgumentType::pointer;
+        } else if constexpr (std::is_floating_point_v<ValueType>) {
+            return LogArgumentType::floatingPoint;
+        } else if constexpr (std::is_signed_v<ValueType>) {
+            return sizeof(ValueType) <= 4 ? LogArgumentType::signed32 : LogArgumentType::signed64;
+        } else {
+            return sizeof(ValueType) <= 4 ? LogArgumentType::unsigned32 : LogArgumentType::unsigned64;
+        }
+    }
+
+    constexpr size_t encodedSizeOf(LogArgumentType type) {
+        switch (type) {
+            case LogArgumentType::signed32:
+            case LogArgumentType::unsigned32:
+                return 4;
+            case LogArgumentType::signed64:
+            case LogArgumentType::unsigned64:
+            case LogArgumentType::floatingPoint:
+                return 8;
+            case LogArgumentType::pointer:
+                return sizeof(uintptr_t);
+        }
+        return 0;
+    }
+
+    template<typename T>
+    void encodeLogArgument(char *dst, const T &value) {
+        using ValueType = std::remove_cvref_t<T>;
+        constexpr auto type = logArgumentTypeOf<T>();
+
+        dst[0] = static_cast<char>(type);
+
+        if constexpr (type == LogArgumentType::pointer) {
+            const auto asInteger = reinterpret_cast<uintptr_t>(value);
+            std::memcpy(dst + 1, &asInteger, sizeof(asInteger));
+        } else if constexpr (type == LogArgumentType::floatingPoint) {
+            const auto asDouble = static_cast<double>(value);
+            std::memcpy(dst + 1, &asDouble, sizeof(asDouble));
+        } else if constexpr (type == LogArgumentType::signed32) {
+            const auto asInteger = static_cast<int32_t>(value);
+            std::memcpy(dst + 1, &asInteger, sizeof(asInteger));
+        } else if constexpr (type == LogArgumentType::signed64) {
+            const auto asInteger = static_cast<int64_t>(value);
+            std::memcpy(dst + 1, &asInteger, sizeof(asInteger));
+        } else if constexpr (type == LogArgumentType::unsigned32) {
+            const auto asInteger = static_cast<uint32_t>(value);
+            std::memcpy(dst + 1, &asInteger, sizeof(asInteger));
+        } else {
+            static_assert(sizeof(ValueType) <= 8, "Integers wider than 64 bit can't be logged");
+            const auto asInteger = static_cast<uint64_t>(value);
+            std::memcpy(dst + 1, &asInteger, sizeof(asInteger));
+        }
+    }
+
+    struct DecodedLogArgument {
+        LogArgumentType type;
+        int64_t asSigned = 0;
+        uint64_t asUnsigned = 0;
+        double asDouble = 0.0;
+    };
+
+    inline std::optional<DecodedLogArgument> decodeLogArgument(const char *arguments, size_t length, size_t &offset) {
+        if (offset >= length) {
+            return std::nullopt;
+        }
+
+        const auto type = static_cast<LogArgumentType>(arguments[offset]);
+        const auto size = encodedSizeOf(type);
+
+        if (size == 0 || offset + 1 + size > length) {
+            return std::nullopt;
+        }
+
+        DecodedLogArgument decoded{ .type = type };
+        const char *value = arguments + offset + 1;
+        offset += 1 + size;
+
+        switch (type) {
+            case LogArgumentType::signed32: {
+                int32_t asInteger = 0;
+                std::memcpy(&asInteger, value, sizeof(asInteger));
+                decoded.asSigned = asInteger;
+                break;
+            }
+            case LogArgumentType::signed64:
+                std::memcpy(&decoded.asSigned, value, sizeof(decoded.asSigned));
+                break;
+            case LogArgumentType::unsigned32: {
+                uint32_t asInteger = 0;
+                std::memcpy(&asInteger, value, sizeof(asInteger));
+                decoded.asUnsigned = asInteger;
+                break;
+            }
+            case LogArgumentType::unsigned64:
+                std::memcpy(&decoded.asUnsigned, value, sizeof(decoded.asUnsigned));
+                break;
+            case LogArgumentType::floatingPoint:
+                std::memcpy(&decoded.asDouble, value, sizeof(decoded.asDouble));
+                decoded.asSigned = static_cast<int64_t>(decoded.asDouble);
+                decoded.asUnsigned = static_cast<uint64_t>(decoded.asSigned);
+                return decoded;
+            case LogArgumentType::pointer: {
+                uintptr_t asInteger = 0;
+                std::memcpy(&asInteger, value, sizeof(asInteger));
+                decoded.asUnsigned = asInteger;
+                break;
+            }
+        }
+
+        // Like printf, %x of a negative int only shows 32 bits
+        if (type == LogArgumentType::signed32) {
+            decoded.asUnsigned = static_cast<uint32_t>(decoded.asSigned);
+        } else if (type == LogArgumentType::signed64) {
+            decoded.asUnsigned = static_cast<uint64_t>(decoded.asSigned);
+        } else {
+            decoded.asSigned = static_cast<int64_t>(decoded.asUnsigned);
+        }
+        decoded.asDouble = type == LogArgumentType::signed32 || type == LogArgumentType::signed64
+            ? static_cast<double>(decoded.asSigned) : static_cast<double>(decoded.asUnsigned);
+
+        return decoded;
+    }
+
+    // Formats a single conversion, the length modifiers of the format string are replaced by the ones of the
+    // encoded type, so the value is always passed to snprintf with a matching type
+    inline int formatLogConversion(char *dst, size_t size, std::string_view spec, char conversion,
+                                   const DecodedLogArgument &argument) {
+        std::array<char, 32> format{};
+
+        if (spec.size() + 4 > format.size()) {
+            return 0;
+        }
+
+        std::memcpy(format.data(), spec.data(), spec.size());
+        size_t formatLength = spec.size();
+
+        switch (conversion) {
+            case 'd': case 'i':
+                format[formatLength++] = 'l';
+                format[formatLength++] = 'l';
+                format[formatLength++] = conversion;
+                return snprintf(dst, size, format.data(), static_cast<long long>(argument.asSigned));
+            case 'o': case 'u': case 'x': case 'X':
+                format[formatLength++] = 'l';
+                format[formatLength++] = 'l';
+                format[formatLength++] = conversion;
+                return snprintf(dst, size, format.data(), static_cast<unsigned long long>(argument.asUnsigned));
+            case 'c':
+                format[formatLength++] = conversion;
+                return snprintf(dst, size, format.data(), static_cast<int>(argument.asSigned));
+            case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+                format[formatLength++] = conversion;
+                return snprintf(dst, size, format.data(), argument.asDouble);
+            case 'p':
+                format[formatLength++] = conversion;
+                return snprintf(dst, size, format.data(),
+                                reinterpret_cast<void *>(static_cast<uintptr_t>(argument.asUnsigned)));
+            default:
+                return snprintf(dst, size, "?");
+        }
+    }
+}
+
+/**
+ * \brief Encodes the arguments of a log call, so they can be formatted later with formatBinaryLogRecord.
+ *
+ * Every argument takes one byte for its type and four or eight bytes for its value.
+ * Returns the number of written bytes or std::nullopt, if the arguments don't fit.
+ */
+template<typename ... Arguments>
+requires (BinaryLogArgument<Arguments> && ...)
+std::optional<size_t> encodeBinaryLogArguments(char *dst, size_t size, const Arguments & ... arguments) {
+    constexpr size_t encodedSize = (size_t{0} + ... + (1 + Detail::encodedSizeOf(Detail::logArgumentTypeOf<Arguments>())));
+
+    if (encodedSize > size) {
+        return std::nullopt;
+    }
+
+    size_t offset = 0;
+    ((Detail::encodeLogArgument(dst + offset, arguments),
+      offset += 1 + Detail::encodedSizeOf(Detail::logArgumentTypeOf<Arguments>())), ...);
+
+    return offset;
+}
+
+/**
+ * \brief Formats a format string with arguments encoded by encodeBinaryLogArguments, like snprintf would.
+ *
+ * Conversions, for which no argument is left, or which need a string, are written as '?'.
+ * Doesn't depend on the device, so the records can also be formatted on the host.
+ * Returns the length of the formatted text without the terminating zero, the text may be truncated.
+ */
+inline size_t formatBinaryLogRecord(char *dst, size_t size, const char *format, const char *arguments,
+                                    size_t argumentsLength) {
+    static constexpr std::string_view flagsAndDigits = "-+ #0123456789.";
+    static constexpr std::string_view lengthModifiers = "hljztL";
+
+    if (size == 0) {
+        return 0;
+    }
+
+    size_t written = 0;
+    size_t argumentOffset = 0;
+
+    auto append = [&](const char *text, size_t length) {
+        const auto copied = written < size - 1 ? std::min(length, size - 1 - written) : 0;
+        std::memcpy(dst + written, text, copied);
+        written += length;
+    };
+
+    for (const char *current = format; *current != '\0'; ++current) {
+        if (*current != '%') {
+            append(current, 1);
+            continue;
+        }
+
+        if (current[1] == '%') {
+            append("%", 1);
+            ++current;
+            continue;
+        }
+
+        // Collects flags, width and precision, '*' takes its value from the next argument
+        std::array<char, 24> spec{'%'};
+        size_t specLength = 1;
+        const char *specEnd = current + 1;
+
+        while (*specEnd != '\0' && specLength < spec.size() - 1
+               && (flagsAndDigits.find(*specEnd) != std::string_view::npos || *specEnd == '*')) {
+            if (*specEnd == '*') {
+                const auto width = Detail::decodeLogArgument(arguments, argumentsLength, argumentOffset);
+                specLength += snprintf(spec.data() + specLength, spec.size() - specLength, "%d",
+                                       width ? static_cast<int>(width->asSigned) : 0);
+                specLength = std::min(specLength, spec.size() - 1);
+            } else {
+                spec[specLength++] = *specEnd;
+            }
+            ++specEnd;
+        }
+
+        while (*specEnd != '\0' && lengthModifiers.find(*specEnd) != std::string_view::npos) {
+            ++specEnd;
+        }
+
+        if (*specEnd == '\0') {
+            break;
+        }
+
+        const auto argument = Detail::decodeLogArgument(arguments, argumentsLength, argumentOffset);
+        std::array<char, 64> converted{};
+        int convertedLength = 1;
+
+        if (argument.has_value()) {
+            convertedLength = Detail::formatLogConversion(converted.data(), converted.size(),
+                                                          std::string_view(spec.data(), specLength), *specEnd,
+                                                          *argument);
+        } else {
+            converted[0] = '?';
+        }
+
+        append(converted.data(), std::min(static_cast<size_t>(std::max(convertedLength, 0)), converted.size() - 1));
+        current = specEnd;
+    }
+
+    dst[std::min(written, size - 1)] = '\0';
+    return written;
+}
@@ -4,6 +4,7 @@
 #include <optional>
 #include <ranges>
 #include <shared_mutex>
+#include <utility>
 
 template<typename T, std::size_t Size>
 /**
@@ -73,6 +74,15 @@ public:
         mData[index] = value;
     }
 
+    /**
+     * \brief Insert an element at the specified index, move-only types are supported as well.
+     * \param index The index at which to insert the element.
+     * \param value The value to move into the array.
+     */
+    void insert(std::size_t index, T &&value) {
+        mData[index] = std::move(value);
+    }
+
     /**
      * \brief Erase an element at the specified index.
      * \param index The index of the element to erase.
@@ -0,0 +1,186 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <utility>
+
+template<size_t Capacity>
+using HeapHandleType = std::conditional_t<Capacity <= std::numeric_limits<uint16_t>::max(), uint16_t, uint32_t>;
+
+/**
+ * \brief A fixed-capacity binary min-heap, whose elements are addressed by a handle in [0, Capacity).
+ *
+ * Every handle can be in the heap at most once. The heap keeps track of the position of each handle,
+ * so a single element can be removed or rescheduled in O(log n) without searching for it.
+ * Inserting and popping the smallest element are O(log n), peeking at it is O(1).
+ */
+template<typename KeyType, size_t Capacity, typename Compare = std::less<KeyType>>
+requires (Capacity > 0)
+class IndexedMinHeap {
+public:
+    using HandleType = HeapHandleType<Capacity>;
+
+    IndexedMinHeap() {
+        mPositions.fill(npos);
+    }
+
+    /**
+     * \brief Insert a handle with the given key.
+     * \return False if the handle is out of range or already in the heap.
+     */
+    [[nodiscard]] bool push(size_t handle, KeyType key) {
+        if (handle >= Capacity || contains(handle)) {
+            return false;
+        }
+
+        mKeys[handle] = std::move(key);
+        mHeap[mSize] = static_cast<HandleType>(handle);
+        mPositions[handle] = static_cast<HandleType>(mSize);
+        siftUp(mSize);
+        ++mSize;
+
+        return true;
+    }
+
+    /**
+     * \brief Remove a handle from the heap, regardless of its position.
+     * \return False if the handle isn't part of the heap.
+     */
+    [[nodiscard]] bool remove(size_t handle) {
+        if (!contains(handle)) {
+            return false;
+        }
+
+        const size_t position = mPositions[handle];
+        --mSize;
+        mPositions[handle] = npos;
+
+        if (position == mSize) {
+            return true;
+        }
+
+        mHeap[position] = mHeap[mSize];
+        mPositions[mHeap[position]] = static_cast<HandleType>(position);
+        restoreAt(position);
+
+        return true;
+    }
+
+    /**
+     * \brief Change the key of a handle, which is already part of the heap.
+     * \return False if the handle isn't part of the heap.
+     */
+    [[nodiscard]] bool update(size_t handle, KeyType key) {
+        if (!contains(handle)) {
+            return false;
+        }
+
+        mKeys[handle] = std::move(key);
+        restoreAt(mPositions[handle]);
+
+        return true;
+    }
+
+    [[nodiscard]] std::optional<size_t> top() const {
+        if (empty()) {
+            return std::nullopt;
+        }
+
+        return mHeap[0];
+    }
+
+    [[nodiscard]] std::optional<size_t> pop() {
+        const auto first = top();
+
+        if (first.has_value()) {
+            (void) remove(*first);
+        }
+
+        return first;
+    }
+
+    [[nodiscard]] const KeyType &key(size_t handle) const {
+        return mKeys[handle];
+    }
+
+    [[nodiscard]] bool contains(size_t handle) const {
+        return handle < Capacity && mPositions[handle] != npos;
+    }
+
+    [[nodiscard]] size_t size() const { return mSize; }
+
+    [[nodiscard]] bool empty() const { return mSize == 0; }
+
+    [[nodiscard]] static constexpr size_t capacity() { return Capacity; }
+
+    void clear() {
+        mPositions.fill(npos);
+        mSize = 0;
+    }
+
+private:
+    static constexpr HandleType npos = std::numeric_limits<HandleType>::max();
+
+    bool isBefore(size_t lhsPosition, size_t rhsPosition) const {
+        return Compare{}(mKeys[mHeap[lhsPosition]], mKeys[mHeap[rhsPosition]]);
+    }
+
+    void swapPositions(size_t lhsPosition, size_t rhsPosition) {
+        std::swap(mHeap[lhsPosition], mHeap[rhsPosition]);
+        mPositions[mHeap[lhsPosition]] = static_cast<HandleType>(lhsPosition);
+        mPositions[mHeap[rhsPosition]] = static_cast<HandleType>(rhsPosition);
+    }
+
+    size_t siftUp(size_t position) {
+        while (position > 0) {
+            const size_t parent = (position - 1) / 2;
+
+            if (!isBefore(position, parent)) {
+                break;
+            }
+
+            swapPositions(position, parent);
+            position = parent;
+        }
+
+        return position;
+    }
+
+    void siftDown(size_t position) {
+        while (true) {
+            const size_t left = 2 * position + 1;
+            const size_t right = left + 1;
+            size_t smallest = position;
+
+            if (left < mSize && isBefore(left, smallest)) {
+                smallest = left;
+            }
+
+            if (right < mSize && isBefore(right, smallest)) {
+                smallest = right;
+            }
+
+            if (smallest == position) {
+                return;
+            }
+
+            swapPositions(position, smallest);
+            position = smallest;
+        }
+    }
+
+    void restoreAt(size_t position) {
+        if (siftUp(position) == position) {
+            siftDown(position);
+        }
+    }
+
+    std::array<HandleType, Capacity> mHeap{};
+    std::array<HandleType, Capacity> mPositions{};
+    std::array<KeyType, Capacity> mKeys{};
+    size_t mSize = 0;
+};
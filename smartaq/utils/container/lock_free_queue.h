@@ -0,0 +1,110 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <type_traits>
+
+/**
+ * \brief A bounded lock-free queue for multiple producers and consumers.
+ *
+ * Every cell carries a sequence number, which tells producers and consumers, whether the cell is free or
+ * filled in the current round. Neither push nor pop ever block, they fail, if the queue is full or empty.
+ * Capacity has to be a power of two.
+ */
+template<typename T, size_t Capacity>
+requires (Capacity >= 2 && (Capacity & (Capacity - 1)) == 0 && std::is_trivially_copyable_v<T>)
+class LockFreeQueue {
+public:
+    LockFreeQueue() {
+        for (size_t i = 0; i < Capacity; ++i) {
+            mCells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    LockFreeQueue(const LockFreeQueue &other) = delete;
+    LockFreeQueue &operator=(const LockFreeQueue &other) = delete;
+
+    /**
+     * \brief Append a value at the end of the queue.
+     * \return False if the queue is full.
+     */
+    [[nodiscard]] bool push(const T &value) {
+        size_t position = mEnqueuePosition.load(std::memory_order_relaxed);
+        Cell *cell = nullptr;
+
+        while (true) {
+            cell = &mCells[position & mask];
+            const auto sequence = cell->sequence.load(std::memory_order_acquire);
+            const auto difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+
+            if (difference == 0) {
+                if (mEnqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (difference < 0) {
+                return false;
+            } else {
+                position = mEnqueuePosition.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->value = value;
+        // seq_cst, so a consumer checking empty() and a producer checking for a consumer afterwards can't both miss
+        cell->sequence.store(position + 1, std::memory_order_seq_cst);
+        return true;
+    }
+
+    /**
+     * \brief Take the value at the front of the queue.
+     * \return The value or std::nullopt, if the queue is empty.
+     */
+    [[nodiscard]] std::optional<T> pop() {
+        size_t position = mDequeuePosition.load(std::memory_order_relaxed);
+        Cell *cell = nullptr;
+
+        while (true) {
+            cell = &mCells[position & mask];
+            const auto sequence = cell->sequence.load(std::memory_order_acquire);
+            const auto difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position + 1);
+
+            if (difference == 0) {
+                if (mDequeuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (difference < 0) {
+                return std::nullopt;
+            } else {
+                position = mDequeuePosition.load(std::memory_order_relaxed);
+            }
+        }
+
+        T value = cell->value;
+        cell->sequence.store(position + Capacity, std::memory_order_release);
+        return value;
+    }
+
+    /**
+     * \brief Check, whether there is a value, which can be taken right now.
+     */
+    [[nodiscard]] bool empty() const {
+        const size_t position = mDequeuePosition.load(std::memory_order_seq_cst);
+        return mCells[position & mask].sequence.load(std::memory_order_seq_cst) != position + 1;
+    }
+
+    [[nodiscard]] static constexpr size_t capacity() { return Capacity; }
+
+private:
+    static constexpr size_t mask = Capacity - 1;
+
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    std::array<Cell, Capacity> mCells;
+    alignas(64) std::atomic<size_t> mEnqueuePosition = 0;
+    alignas(64) std::atomic<size_t> mDequeuePosition = 0;
+};
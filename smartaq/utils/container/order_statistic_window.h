@@ -0,0 +1,229 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+/**
+ * \brief Keeps the last WindowSize values sorted, so order statistics of the window can be read in O(log n).
+ *
+ * The values are nodes of a treap, every node knows the size and the sum of its subtree, so the k-th smallest
+ * value and the sum of the k smallest values can be found on the way down. The node of a value is its slot
+ * in the window, adding a value to a full window replaces the oldest one. Equal values are ordered by their slot,
+ * so every node has a unique position in the tree. Adding a value is O(log n) in the expected case.
+ */
+template<typename T, size_t WindowSize>
+requires (WindowSize > 0 && WindowSize < std::numeric_limits<uint16_t>::max() && std::is_arithmetic_v<T>)
+class OrderStatisticWindow final {
+    public:
+        void push(T value) {
+            if (mSize == WindowSize) {
+                erase(mNext);
+            } else {
+                ++mSize;
+            }
+
+            auto &node = mNodes[mNext];
+            node = Node{ .value = value, .priority = nextPriority() };
+            node.size = 1;
+            node.sum = static_cast<double>(value);
+            mRoot = insert(mRoot, mNext);
+
+            mNext = static_cast<HandleType>((mNext + 1) % WindowSize);
+        }
+
+        void clear() {
+            mRoot = npos;
+            mSize = 0;
+            mNext = 0;
+        }
+
+        [[nodiscard]] size_t size() const { return mSize; }
+        [[nodiscard]] bool empty() const { return mSize == 0; }
+        [[nodiscard]] static constexpr size_t capacity() { return WindowSize; }
+
+        // The k-th smallest value, starting with zero, k has to be smaller than size()
+        [[nodiscard]] T select(size_t k) const {
+            HandleType current = mRoot;
+
+            while (true) {
+                const auto leftSize = sizeOf(mNodes[current].left);
+
+                if (k < leftSize) {
+                    current = mNodes[current].left;
+                } else if (k == leftSize) {
+                    return mNodes[current].value;
+                } else {
+                    k -= leftSize + 1;
+                    current = mNodes[current].right;
+                }
+            }
+        }
+
+        // The sum of the k smallest values
+        [[nodiscard]] double sumOfSmallest(size_t k) const {
+            HandleType current = mRoot;
+            double sum = 0.0;
+
+            while (current != npos && k > 0) {
+                const auto &node = mNodes[current];
+                const auto leftSize = sizeOf(node.left);
+
+                if (k <= leftSize) {
+                    current = node.left;
+                    continue;
+                }
+
+                sum += sumOf(node.left) + static_cast<double>(node.value);
+                k -= leftSize + 1;
+                current = node.right;
+            }
+
+            return sum;
+        }
+
+        // The value at the quantile q in [0, 1], linearly interpolated between the neighbouring values
+        [[nodiscard]] double quantile(double q) const {
+            const auto position = q * static_cast<double>(mSize - 1);
+            const auto lower = static_cast<size_t>(position);
+            const auto lowerValue = static_cast<double>(select(lower));
+
+            if (lower + 1 >= mSize) {
+                return lowerValue;
+            }
+
+            return lowerValue + (position - static_cast<double>(lower)) * (static_cast<double>(select(lower + 1)) - lowerValue);
+        }
+
+        [[nodiscard]] double median() const {
+            return quantile(0.5);
+        }
+
+    private:
+        using HandleType = uint16_t;
+        static constexpr HandleType npos = std::numeric_limits<HandleType>::max();
+
+        struct Node {
+            T value{};
+            uint32_t priority = 0;
+            HandleType left = npos;
+            HandleType right = npos;
+            HandleType size = 0;
+            double sum = 0.0;
+        };
+
+        [[nodiscard]] HandleType sizeOf(HandleType handle) const {
+            return handle == npos ? 0 : mNodes[handle].size;
+        }
+
+        [[nodiscard]] double sumOf(HandleType handle) const {
+            return handle == npos ? 0.0 : mNodes[handle].sum;
+        }
+
+        [[nodiscard]] bool isBefore(HandleType lhs, HandleType rhs) const {
+            return mNodes[lhs].value < mNodes[rhs].value || (mNodes[lhs].value == mNodes[rhs].value && lhs < rhs);
+        }
+
+        void update(HandleType handle) {
+            auto &node = mNodes[handle];
+            node.size = static_cast<HandleType>(1 + sizeOf(node.left) + sizeOf(node.right));
+            node.sum = static_cast<double>(node.value) + sumOf(node.left) + sumOf(node.right);
+        }
+
+        HandleType rotateRight(HandleType handle) {
+            const auto left = mNodes[handle].left;
+            mNodes[handle].left = mNodes[left].right;
+            mNodes[left].right = handle;
+            update(handle);
+            update(left);
+            return left;
+        }
+
+        HandleType rotateLeft(HandleType handle) {
+            const auto right = mNodes[handle].right;
+            mNodes[handle].right = mNodes[right].left;
+            mNodes[right].left = handle;
+            update(handle);
+            update(right);
+            return right;
+        }
+
+        HandleType insert(HandleType subtree, HandleType handle) {
+            if (subtree == npos) {
+                return handle;
+            }
+
+            if (isBefore(handle, subtree)) {
+                mNodes[subtree].left = insert(mNodes[subtree].left, handle);
+
+                if (mNodes[mNodes[subtree].left].priority > mNodes[subtree].priority) {
+                    return rotateRight(subtree);
+                }
+            } else {
+                mNodes[subtree].right = insert(mNodes[subtree].right, handle);
+
+                if (mNodes[mNodes[subtree].right].priority > mNodes[subtree].priority) {
+                    return rotateLeft(subtree);
+                }
+            }
+
+            update(subtree);
+            return subtree;
+        }
+
+        // Merges two subtrees, every value of lhs is before every value of rhs
+        HandleType merge(HandleType lhs, HandleType rhs) {
+            if (lhs == npos) {
+                return rhs;
+            }
+
+            if (rhs == npos) {
+                return lhs;
+            }
+
+            if (mNodes[lhs].priority > mNodes[rhs].priority) {
+                mNodes[lhs].right = merge(mNodes[lhs].right, rhs);
+                update(lhs);
+                return lhs;
+            }
+
+            mNodes[rhs].left = merge(lhs, mNodes[rhs].left);
+            update(rhs);
+            return rhs;
+        }
+
+        HandleType eraseFrom(HandleType subtree, HandleType handle) {
+            if (subtree == handle) {
+                return merge(mNodes[handle].left, mNodes[handle].right);
+            }
+
+            if (isBefore(handle, subtree)) {
+                mNodes[subtree].left = eraseFrom(mNodes[subtree].left, handle);
+            } else {
+                mNodes[subtree].right = eraseFrom(mNodes[subtree].right, handle);
+            }
+
+            update(subtree);
+            return subtree;
+        }
+
+        void erase(HandleType handle) {
+            mRoot = eraseFrom(mRoot, handle);
+        }
+
+        // xorshift, the priorities only have to be spread evenly
+        uint32_t nextPriority() {
+            mRandomState ^= mRandomState << 13;
+            mRandomState ^= mRandomState >> 17;
+            mRandomState ^= mRandomState << 5;
+            return mRandomState;
+        }
+
+        std::array<Node, WindowSize> mNodes{};
+        HandleType mRoot = npos;
+        HandleType mNext = 0;
+        HandleType mSize = 0;
+        uint32_t mRandomState = 2463534242u;
+};
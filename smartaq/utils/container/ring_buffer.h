@@ -1,16 +1,26 @@
 #pragma once
 
+#include <algorithm>
 #include <array>
+#include <compare>
 #include <cstddef>
+#include <cstring>
 #include <iterator>
 #include <optional>
+#include <span>
 #include <type_traits>
 
+template<typename BufferType, typename ValueType>
+class RingBufferIterator;
+
 template <typename T, size_t N>
 requires (N > 1)
 class RingBuffer {
    public:
     using SizeType = decltype(N);
+    using value_type = T;
+    using iterator = RingBufferIterator<RingBuffer, T>;
+    using const_iterator = RingBufferIterator<const RingBuffer, const T>;
 
     T &operator[](SizeType index) {
         return m_data[calculateRealIndex(index)];
@@ -32,6 +42,58 @@ class RingBuffer {
         return *this;
     }
 
+    // Appends all values, only the last N are kept, if there are more
+    RingBuffer &append(std::span<const T> values) {
+        if (values.size() >= m_data.size()) {
+            copyValues(m_data.data(), values.data() + values.size() - m_data.size(), m_data.size());
+            m_offset = 0;
+            m_size = m_data.size();
+            return *this;
+        }
+
+        const auto end = calculateRealIndex(m_size);
+        const auto untilWrap = std::min<SizeType>(values.size(), m_data.size() - end);
+        copyValues(m_data.data() + end, values.data(), untilWrap);
+        copyValues(m_data.data(), values.data() + untilWrap, values.size() - untilWrap);
+
+        const auto overwritten = (m_size + values.size() > m_data.size()) ? m_size + values.size() - m_data.size() : 0;
+        m_offset = (m_offset + overwritten) % m_data.size();
+        m_size = m_size + values.size() - overwritten;
+        return *this;
+    }
+
+    // Copies the oldest values into dst, until it is full, and returns the number of copied values
+    SizeType copyOut(std::span<T> dst) const {
+        SizeType copied = 0;
+
+        for (const auto &currentSpan : asSpans()) {
+            const auto toCopy = std::min<SizeType>(currentSpan.size(), dst.size() - copied);
+            copyValues(dst.data() + copied, currentSpan.data(), toCopy);
+            copied += toCopy;
+        }
+
+        return copied;
+    }
+
+    // The values, oldest first, in at most two contiguous parts, the second one is empty, if they don't wrap around
+    std::array<std::span<T>, 2> asSpans() {
+        const auto untilWrap = std::min<SizeType>(m_size, m_data.size() - m_offset);
+        return { std::span<T>(m_data.data() + m_offset, untilWrap), std::span<T>(m_data.data(), m_size - untilWrap) };
+    }
+
+    std::array<std::span<const T>, 2> asSpans() const {
+        const auto untilWrap = std::min<SizeType>(m_size, m_data.size() - m_offset);
+        return { std::span<const T>(m_data.data() + m_offset, untilWrap),
+                 std::span<const T>(m_data.data(), m_size - untilWrap) };
+    }
+
+    iterator begin() { return iterator(this, 0); }
+    iterator end() { return iterator(this, m_size); }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, m_size); }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+
     [[nodiscard]] bool empty() const {
         return m_size == 0;
     }
@@ -80,6 +142,18 @@ class RingBuffer {
     SizeType size() const { return m_size; }
 
    private:
+    static void copyValues(T *dst, const T *src, SizeType count) {
+        if (count == 0) {
+            return;
+        }
+
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            std::memcpy(dst, src, count * sizeof(T));
+        } else {
+            std::copy_n(src, count, dst);
+        }
+    }
+
     SizeType calculateRealIndex(SizeType n) const {
         return (m_offset + n) % m_data.size();
     }
@@ -89,59 +163,54 @@ class RingBuffer {
     SizeType m_size = 0;
 };
 
-template<typename T, size_t N>
-requires (N > 1)
+/**
+ * \brief A random access iterator over the values of a RingBuffer, oldest first.
+ *
+ * It keeps the logical position, so it stays valid, while the buffer wraps around.
+ * Algorithms, which only need contiguous memory, are faster with RingBuffer::asSpans.
+ */
+template<typename BufferType, typename ValueType>
 class RingBufferIterator {
-    using difference_type = ptrdiff_t;
-    using value_type = T;
-    using pointer = std::add_pointer_t<T>;
-    using reference = std::add_lvalue_reference_t<T>;
-    using iterator_category = std::forward_iterator_tag;
-    using iterator_concept = std::forward_iterator_tag;
+   public:
+    using difference_type = std::ptrdiff_t;
+    using value_type = std::remove_cv_t<ValueType>;
+    using pointer = ValueType *;
+    using reference = ValueType &;
+    using iterator_category = std::random_access_iterator_tag;
+    using iterator_concept = std::random_access_iterator_tag;
 
     RingBufferIterator() = default;
-    RingBufferIterator(T *base, size_t pos, size_t offset, size_t size) : size(size), pos(pos), offset(offset), base(base) {}
-    RingBufferIterator(const RingBufferIterator &other) = default;
-    RingBufferIterator(RingBufferIterator &&other) = default;
-    ~RingBufferIterator() = default;
-
-    RingBufferIterator &operator=(const RingBufferIterator &other) = default;
-    RingBufferIterator &operator=(RingBufferIterator &&other) = default;
-
-    const T &operator *() const {
-        return *(base + offset);
-    }
-
-    T &operator *() {
-        return *(base + offset);
-    }
-
-    RingBufferIterator &operator++() {
-        pos = (pos + 1) % size;
-
-        return *this;
+    RingBufferIterator(BufferType *buffer, std::size_t position) : m_buffer(buffer),
+        m_position(static_cast<difference_type>(position)) {}
+
+    reference operator*() const { return (*m_buffer)[static_cast<std::size_t>(m_position)]; }
+    pointer operator->() const { return &**this; }
+    reference operator[](difference_type n) const { return *(*this + n); }
+
+    RingBufferIterator &operator++() { ++m_position; return *this; }
+    RingBufferIterator operator++(int) { auto old = *this; ++m_position; return old; }
+    RingBufferIterator &operator--() { --m_position; return *this; }
+    RingBufferIterator operator--(int) { auto old = *this; --m_position; return old; }
+
+    RingBufferIterator &operator+=(difference_type n) { m_position += n; return *this; }
+    RingBufferIterator &operator-=(difference_type n) { m_position -= n; return *this; }
+
+    friend RingBufferIterator operator+(RingBufferIterator it, difference_type n) { return it += n; }
+    friend RingBufferIterator operator+(difference_type n, RingBufferIterator it) { return it += n; }
+    friend RingBufferIterator operator-(RingBufferIterator it, difference_type n) { return it -= n; }
+    friend difference_type operator-(const RingBufferIterator &lhs, const RingBufferIterator &rhs) {
+        return lhs.m_position - rhs.m_position;
     }
 
-    RingBufferIterator &operator++(int) {
-        auto old = *this;
-        ++*this;
-
-        return old;
-    }
-
-    bool operator==(const RingBufferIterator<T, N> &other) {
-        return pos == other.pos 
-            && base == other.base
-            && size == other.size
-            && offset == other.offset;
+    friend bool operator==(const RingBufferIterator &lhs, const RingBufferIterator &rhs) {
+        return lhs.m_position == rhs.m_position;
     }
 
-    bool operator!=(const RingBuffer<T, N> &other) {
-        return !this->operator==(other);
+    friend auto operator<=>(const RingBufferIterator &lhs, const RingBufferIterator &rhs) {
+        return lhs.m_position <=> rhs.m_position;
     }
 
-    size_t size = 0;
-    size_t pos = 0;
-    size_t offset = 0;
-    T *base = nullptr;
-};
\ No newline at end of file
+   private:
+    BufferType *m_buffer = nullptr;
+    difference_type m_position = 0;
+};
@@ -0,0 +1,153 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+#include "ring_buffer.h"
+
+enum struct RollupResolution {
+    oneMinute, fifteenMinutes, oneHour
+};
+
+struct RollupSeriesConfig {
+    // The defaults keep the last hour, day and week
+    size_t numMinuteBuckets = 60;
+    size_t numFifteenMinuteBuckets = 96;
+    size_t numHourBuckets = 168;
+};
+
+template<typename T>
+struct RollupBucket {
+    std::chrono::steady_clock::time_point start{};
+    T min{};
+    T max{};
+    float mean = 0.0f;
+    uint32_t count = 0;
+};
+
+namespace Detail {
+    // The closed buckets of one resolution and the one, which is still filled
+    template<typename T, typename Duration, size_t NumBuckets>
+    class RollupLevel final {
+        public:
+            using BucketType = RollupBucket<T>;
+            using TimePoint = std::chrono::steady_clock::time_point;
+
+            static constexpr auto bucketDuration = std::chrono::duration_cast<TimePoint::duration>(Duration(1));
+
+            void put(T value, TimePoint timeStamp) {
+                const auto bucketStart = TimePoint(
+                    (timeStamp.time_since_epoch() / bucketDuration) * bucketDuration);
+
+                if (mOpen.count != 0 && bucketStart > mOpen.start) {
+                    mClosed.append(mOpen);
+                    mOpen = BucketType{};
+                }
+
+                // Samples, which are older than the open bucket, are counted in it as well
+                if (mOpen.count == 0) {
+                    mOpen = BucketType{ .start = bucketStart, .min = value, .max = value };
+                    mSum = 0.0;
+                }
+
+                mOpen.min = std::min(mOpen.min, value);
+                mOpen.max = std::max(mOpen.max, value);
+                mSum += static_cast<double>(value);
+                ++mOpen.count;
+                mOpen.mean = static_cast<float>(mSum / mOpen.count);
+            }
+
+            // Visits the buckets, which end after from, the oldest first
+            template<typename Visitor>
+            void forEachBucketSince(TimePoint from, Visitor &visitor) const {
+                for (const auto &currentBucket : mClosed) {
+                    if (currentBucket.start + bucketDuration > from) {
+                        visitor(currentBucket);
+                    }
+                }
+
+                if (mOpen.count != 0 && mOpen.start + bucketDuration > from) {
+                    visitor(mOpen);
+                }
+            }
+
+        private:
+            RingBuffer<BucketType, NumBuckets> mClosed;
+            BucketType mOpen{};
+            double mSum = 0.0;
+    };
+}
+
+/**
+ * \brief Keeps the min, max, mean and count of a series in buckets of one minute, fifteen minutes and one hour.
+ *
+ * Every sample updates the open bucket of each resolution, so putting a sample doesn't depend on the number
+ * of kept buckets. Once a sample belongs to a later bucket, the open one is moved into a ring buffer,
+ * which drops the oldest bucket, when it is full. Intervals without samples don't get a bucket.
+ * A range query picks the finest resolution, which still covers the requested window.
+ */
+template<typename T, RollupSeriesConfig Config = RollupSeriesConfig{}, typename Clock = std::chrono::steady_clock>
+class RollupSeries final {
+    public:
+        using BucketType = RollupBucket<T>;
+
+        void put(T value) {
+            put(value, Clock::now());
+        }
+
+        void put(T value, std::chrono::steady_clock::time_point timeStamp) {
+            std::unique_lock guard{mMutex};
+            mMinutes.put(value, timeStamp);
+            mFifteenMinutes.put(value, timeStamp);
+            mHours.put(value, timeStamp);
+        }
+
+        // Calls visitor with every bucket of the last window, the oldest first, and returns the used resolution.
+        // The buckets are locked meanwhile, so the visitor shouldn't take long.
+        template<typename Visitor>
+        RollupResolution forEachBucket(std::chrono::seconds window, Visitor &&visitor) const;
+
+        static constexpr RollupResolution resolutionFor(std::chrono::seconds window) {
+            if (window <= std::chrono::minutes(Config.numMinuteBuckets)) {
+                return RollupResolution::oneMinute;
+            }
+
+            if (window <= std::chrono::minutes(15 * Config.numFifteenMinuteBuckets)) {
+                return RollupResolution::fifteenMinutes;
+            }
+
+            return RollupResolution::oneHour;
+        }
+
+    private:
+        mutable std::mutex mMutex;
+        Detail::RollupLevel<T, std::chrono::minutes, Config.numMinuteBuckets> mMinutes;
+        Detail::RollupLevel<T, std::chrono::duration<int64_t, std::ratio<900>>, Config.numFifteenMinuteBuckets>
+            mFifteenMinutes;
+        Detail::RollupLevel<T, std::chrono::hours, Config.numHourBuckets> mHours;
+};
+
+template<typename T, RollupSeriesConfig Config, typename Clock>
+template<typename Visitor>
+RollupResolution RollupSeries<T, Config, Clock>::forEachBucket(std::chrono::seconds window, Visitor &&visitor) const {
+    const auto resolution = resolutionFor(window);
+    const auto from = Clock::now() - window;
+
+    std::unique_lock guard{mMutex};
+    switch (resolution) {
+        case RollupResolution::oneMinute:
+            mMinutes.forEachBucketSince(from, visitor);
+            break;
+        case RollupResolution::fifteenMinutes:
+            mFifteenMinutes.forEachBucketSince(from, visitor);
+            break;
+        case RollupResolution::oneHour:
+            mHours.forEachBucketSince(from, visitor);
+            break;
+    }
+
+    return resolution;
+}
@@ -1,13 +1,17 @@
 #pragma once
 
 #include <mutex>
-#include <shared_mutex>
 #include <type_traits>
 #include <optional>
+#include <algorithm>
+#include <chrono>
 #include <cmath>
+#include <limits>
 #include <ranges>
 
 #include "ring_buffer.h"
+#include "sample_filter.h"
+#include "seqlock_snapshot.h"
 
 // TODO: Check for Stale values idea?
 template<typename T>
@@ -20,6 +24,18 @@ template<typename T>
 struct SampleContainerSettings
 {
     float maxRateOfChange = 0.0f;
+    // Replaces the rate of change check, if a filter is selected
+    SampleFilterSettings filter{};
+};
+
+// What the readers of a SampleContainer see, all values belong to the same sample
+template<typename T, typename AvgType>
+struct SampleAggregates {
+    AvgType average{};
+    float variance = 0.0f;
+    float stdDerivation = 0.0f;
+    T last{};
+    uint32_t size = 0;
 };
 
 template <typename T, typename AvgType = T, uint32_t n_samples = 10u>
@@ -33,6 +49,7 @@ class SampleContainer final {
 
     explicit SampleContainer(SampleContainerSettings<T> settings) : SampleContainer(settings.maxRateOfChange)
     {
+        mFilter = SampleFilter<T, n_samples>(settings.filter);
     }
 
     SampleContainer(const SampleContainer &other) {
@@ -78,44 +95,46 @@ class SampleContainer final {
     bool putSample(T value, std::chrono::time_point<std::chrono::steady_clock> timeStamp) {
         std::unique_lock _instance_lock{mResourceMutex};
 
-        if (!checkSampleViability(value, timeStamp)) {
+        if (mFilter.kind() != SampleFilterKind::none) {
+            const auto filtered = mFilter.filter(value);
+
+            if (!filtered.has_value()) {
+                return false;
+            }
+
+            value = *filtered;
+        } else if (!checkSampleViability(value, timeStamp)) {
             return false;
         }
 
-        mSamples.append({value, timeStamp});
-        recalculateInternalValues(_instance_lock);
+        addToInternalValues(_instance_lock, {value, timeStamp});
 
         return true;
     }
 
-    AvgType average() const {
-        std::shared_lock _instance_lock{mResourceMutex};
+    // The readers don't take a lock, they read the aggregates, which were published by the last putSample
+    SampleAggregates<T, AvgType> aggregates() const {
+        return mAggregates.load();
+    }
 
-        return mAvg;
+    AvgType average() const {
+        return aggregates().average;
     }
 
     AvgType last() const {
-        std::shared_lock _instance_lock{mResourceMutex};
-
-        return mSamples.back().value;
+        return aggregates().last;
     }
 
     auto stdVariance() const {
-        std::shared_lock _instance_lock{mResourceMutex};
-
-        return mStdDerivation;
+        return aggregates().stdDerivation;
     }
 
     auto variance() const {
-        std::shared_lock _instance_lock{mResourceMutex};
-
-        return mVariance;
+        return aggregates().variance;
     }
 
     auto size() const {
-        std::shared_lock _instance_lock{mResourceMutex};
-
-        return mSamples.size();
+        return aggregates().size;
     }
 
    private:
@@ -125,57 +144,77 @@ class SampleContainer final {
         return std::max<decltype(timeDiffInSeconds)>(std::abs(timeDiffInSeconds), 1l);
     }
 
-    // TODO: maybe don't recalculate complete new average
+    static float rateOfChange(const Sample<T> &from, const Sample<T> &to) {
+        const auto timeDiff = calculateTimeDifference(to.timeStamp, from.timeStamp);
+        const float difference(std::abs(to.value) - std::abs(from.value));
+        return std::abs(difference) / timeDiff;
+    }
+
+    // Updates the running statistics with the new sample and the evicted one in constant time,
+    // the mean and the sum of squared differences are updated like Welford does
     template<typename MutexType>
-    SampleContainer &recalculateInternalValues(std::unique_lock<MutexType> &lock) {
-        using SizeType = decltype(mSamples)::SizeType;
+    SampleContainer &addToInternalValues(std::unique_lock<MutexType> &lock, const Sample<T> &sample) {
         if (!lock.owns_lock()) {
             return *this;
         }
 
-        if (mSamples.empty()) {
-            return *this;
-        }
+        const auto value = static_cast<double>(sample.value);
 
-        const auto divisor = 1.0f / mSamples.size();
-        float summed_up_values = 0;
+        if (mSamples.size() == n_samples) {
+            // The oldest sample is overwritten by the new one, so the window keeps its size
+            const auto evicted = static_cast<double>(mSamples.front().value);
+            const auto previousMean = mMean;
 
-        for (SizeType i = 0; i < mSamples.size(); ++i) {
-            summed_up_values += mSamples[i].value * divisor;
+            mMean += (value - evicted) / n_samples;
+            mSquaredDifferences += (value - evicted) * (value - mMean + evicted - previousMean);
+            mRateOfChangeSum -= rateOfChange(mSamples[0], mSamples[1]);
+        } else {
+            const auto delta = value - mMean;
+
+            mMean += delta / (mSamples.size() + 1);
+            mSquaredDifferences += delta * (value - mMean);
         }
 
-        if constexpr (std::is_integral_v<AvgType>) {
-            mAvg = static_cast<AvgType>(std::lround(summed_up_values));
-        } else {
-            mAvg = summed_up_values;
+        if (!mSamples.empty()) {
+            mRateOfChangeSum += rateOfChange(mSamples.back(), sample);
         }
 
-        float ss = 0;
-        for (SizeType i = 0; i < mSamples.size(); ++i) {
-            ss += (mSamples[i].value - mAvg) * (mSamples[i].value - mAvg);
+        mSamples.append(sample);
+
+        // Rounding errors mustn't make the variance negative
+        mSquaredDifferences = std::max(mSquaredDifferences, 0.0);
+        mRateOfChangeSum = std::max(mRateOfChangeSum, 0.0);
+
+        if constexpr (std::is_integral_v<AvgType>) {
+            mAvg = static_cast<AvgType>(std::lround(mMean));
+        } else {
+            mAvg = static_cast<AvgType>(mMean);
         }
 
         if (mSamples.size() <= 1) {
             mAvgRateOfChange = 0.0f;
-            return *this;
-        }
-
-        const auto sampleDivisor = mSamples.size() - 1;
-        mVariance = ss / sampleDivisor;
-        mStdDerivation = std::sqrt(mVariance);
-
-        // Calculate average rate of change
-        float totalRateOfChange = 0.0f;
-        for (SizeType i = 1; i < mSamples.size(); ++i) {
-            const auto timeDiff = calculateTimeDifference(mSamples[i].timeStamp, mSamples[i - 1].timeStamp);
-            const float difference(std::abs(mSamples[i].value) - std::abs(mSamples[i - 1].value));
-            totalRateOfChange += std::abs(difference) / timeDiff;
+        } else {
+            const auto sampleDivisor = mSamples.size() - 1;
+            mVariance = static_cast<float>(mSquaredDifferences / sampleDivisor);
+            mStdDerivation = std::sqrt(mVariance);
+            mAvgRateOfChange = static_cast<float>(mRateOfChangeSum / sampleDivisor);
         }
-        mAvgRateOfChange = totalRateOfChange / (mSamples.size() - 1);
 
+        publishAggregates();
         return *this;
     }
 
+    // Is only called by the owner of the lock, so there is one writer at a time
+    void publishAggregates() {
+        mAggregates.store(SampleAggregates<T, AvgType>{
+            .average = mAvg,
+            .variance = mVariance,
+            .stdDerivation = mStdDerivation,
+            .last = mSamples.empty() ? T{} : mSamples.back().value,
+            .size = static_cast<uint32_t>(mSamples.size())
+        });
+    }
+
     bool checkSampleViability(T value, std::chrono::time_point<std::chrono::steady_clock> timeStamp) {
         if (mSamples.size() < n_samples / 2 || mSamples.size() < 2) {
             // Allow early samples to pass without restrictions.
@@ -206,26 +245,43 @@ class SampleContainer final {
     void copyFrom(const SampleContainer& other) {
         mAvg = other.mAvg;
         mAvgRateOfChange = other.mAvgRateOfChange;
+        mMean = other.mMean;
+        mSquaredDifferences = other.mSquaredDifferences;
+        mRateOfChangeSum = other.mRateOfChangeSum;
         mSamples = other.mSamples;
         mStdDerivation = other.mStdDerivation;
         mVariance = other.mVariance;
         mMaxRateOfChange = other.mMaxRateOfChange;
+        mFilter = other.mFilter;
+        publishAggregates();
     }
 
     void moveFrom(SampleContainer&& other) noexcept {
         mSamples = std::move(other.mSamples);
         mAvg = other.mAvg;
+        mMean = other.mMean;
+        mSquaredDifferences = other.mSquaredDifferences;
+        mRateOfChangeSum = other.mRateOfChangeSum;
         mAvgRateOfChange = other.mAvgRateOfChange;
         mStdDerivation = other.mStdDerivation;
         mVariance = other.mVariance;
         mMaxRateOfChange = other.mMaxRateOfChange;
+        mFilter = other.mFilter;
+        publishAggregates();
     }
 
-    mutable std::shared_mutex mResourceMutex;
-    AvgType mAvg;
-    float mVariance;
-    float mStdDerivation;
-    float mAvgRateOfChange;
+    // Serializes the writers, the readers use mAggregates
+    mutable std::mutex mResourceMutex;
+    AvgType mAvg{};
+    float mVariance = 0.0f;
+    float mStdDerivation = 0.0f;
+    float mAvgRateOfChange = 0.0f;
+    // Running statistics of the samples in the window, they are kept in double, so they don't drift
+    double mMean = 0.0;
+    double mSquaredDifferences = 0.0;
+    double mRateOfChangeSum = 0.0;
     float mMaxRateOfChange = std::numeric_limits<float>::infinity();
+    SampleFilter<T, n_samples> mFilter;
     RingBuffer<Sample<T>, n_samples> mSamples;
+    SeqLockSnapshot<SampleAggregates<T, AvgType>> mAggregates;
 };
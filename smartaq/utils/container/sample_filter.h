@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <type_traits>
+
+#include "order_statistic_window.h"
+
+enum struct SampleFilterKind : uint8_t {
+    // Only the rate of change is checked
+    none,
+    // The median of the window is put instead of the sample
+    median,
+    // Samples, which are further away from the median than hampelThreshold times the robust deviation, are dropped
+    hampel,
+    // The mean of the window without the trimFraction smallest and largest values is put instead of the sample
+    trimmedMean
+};
+
+struct SampleFilterSettings {
+    SampleFilterKind kind = SampleFilterKind::none;
+    float hampelThreshold = 3.0f;
+    float trimFraction = 0.2f;
+};
+
+/**
+ * \brief A filter stage in front of a SampleContainer, which works on the order statistics of the last
+ * WindowSize raw samples.
+ *
+ * Every raw sample is added to the window, also the ones the hampel filter drops, so a real step change
+ * is accepted, once it makes up half of the window. The hampel filter uses the interquartile range
+ * as robust deviation, it stays valid while the window changes, unlike the median absolute deviation,
+ * which would have to be recalculated for the whole window. Filtering a sample is O(log n).
+ */
+template<typename T, size_t WindowSize>
+class SampleFilter final {
+    public:
+        // The hampel filter accepts every sample, until the window holds that many
+        static constexpr size_t minimumHampelSamples = WindowSize < 5 ? WindowSize : 5;
+        // Interquartile range of a normal distribution in standard deviations
+        static constexpr double interquartileRangeToDeviation = 1.349;
+
+        SampleFilter() = default;
+        explicit SampleFilter(SampleFilterSettings settings) : mSettings(settings) {}
+
+        // Returns the value, which should be put into the container, or nothing, if the sample is dropped
+        std::optional<T> filter(T value);
+
+        [[nodiscard]] SampleFilterKind kind() const { return mSettings.kind; }
+
+    private:
+        static T toSampleType(double value) {
+            if constexpr (std::is_integral_v<T>) {
+                return static_cast<T>(std::lround(value));
+            } else {
+                return static_cast<T>(value);
+            }
+        }
+
+        SampleFilterSettings mSettings{};
+        OrderStatisticWindow<T, WindowSize> mWindow;
+};
+
+template<typename T, size_t WindowSize>
+std::optional<T> SampleFilter<T, WindowSize>::filter(T value) {
+    if (mSettings.kind == SampleFilterKind::none) {
+        return value;
+    }
+
+    mWindow.push(value);
+
+    switch (mSettings.kind) {
+        case SampleFilterKind::median:
+            return toSampleType(mWindow.median());
+        case SampleFilterKind::hampel: {
+            if (mWindow.size() < minimumHampelSamples) {
+                return value;
+            }
+
+            const auto deviation = (mWindow.quantile(0.75) - mWindow.quantile(0.25)) / interquartileRangeToDeviation;
+
+            if (std::abs(static_cast<double>(value) - mWindow.median()) > mSettings.hampelThreshold * deviation) {
+                return std::nullopt;
+            }
+
+            return value;
+        }
+        case SampleFilterKind::trimmedMean: {
+            const auto size = mWindow.size();
+            auto trimmed = static_cast<size_t>(static_cast<double>(size) * mSettings.trimFraction);
+
+            if (2 * trimmed >= size) {
+                trimmed = (size - 1) / 2;
+            }
+
+            const auto sum = mWindow.sumOfSmallest(size - trimmed) - mWindow.sumOfSmallest(trimmed);
+            return toSampleType(sum / static_cast<double>(size - 2 * trimmed));
+        }
+        default:
+            return value;
+    }
+}
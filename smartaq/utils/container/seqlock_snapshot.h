@@ -0,0 +1,74 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+/**
+ * \brief A value, which one writer publishes and any number of readers read without a lock.
+ *
+ * The value is kept twice, the sequence tells the readers, which copy isn't written at the moment.
+ * A writer bumps the sequence, so the readers switch to the other copy, before it writes a copy,
+ * a reader only retries, if the copy it read was written meanwhile, so it never waits for a writer,
+ * which was preempted. The copies consist of atomic words, so reading a torn value isn't a data race,
+ * it is detected by the sequence and thrown away.
+ * Only one thread may call store at a time.
+ */
+template<typename T>
+requires (std::is_trivially_copyable_v<T> && std::is_default_constructible_v<T>)
+class SeqLockSnapshot {
+public:
+    SeqLockSnapshot() : SeqLockSnapshot(T{}) {}
+    explicit SeqLockSnapshot(const T &value) { store(value); }
+
+    SeqLockSnapshot(const SeqLockSnapshot &other) = delete;
+    SeqLockSnapshot &operator=(const SeqLockSnapshot &other) = delete;
+
+    void store(const T &value) {
+        Words words{};
+        std::memcpy(words.data(), &value, sizeof(T));
+
+        for (auto &currentCopy : mCopies) {
+            // The readers use the other copy, until this one is written,
+            // the release also publishes the copy, which was written before
+            mSequence.fetch_add(1, std::memory_order_release);
+            std::atomic_thread_fence(std::memory_order_release);
+
+            for (size_t i = 0; i < numWords; ++i) {
+                currentCopy[i].store(words[i], std::memory_order_relaxed);
+            }
+        }
+    }
+
+    [[nodiscard]] T load() const {
+        Words words{};
+        uint32_t sequenceBefore = 0;
+        uint32_t sequenceAfter = 0;
+
+        do {
+            sequenceBefore = mSequence.load(std::memory_order_acquire);
+            const auto &currentCopy = mCopies[sequenceBefore & 1];
+
+            for (size_t i = 0; i < numWords; ++i) {
+                words[i] = currentCopy[i].load(std::memory_order_relaxed);
+            }
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            sequenceAfter = mSequence.load(std::memory_order_relaxed);
+        } while (sequenceBefore != sequenceAfter);
+
+        T value;
+        std::memcpy(static_cast<void *>(&value), words.data(), sizeof(T));
+        return value;
+    }
+
+private:
+    static constexpr size_t numWords = (sizeof(T) + sizeof(uint32_t) - 1) / sizeof(uint32_t);
+    using Words = std::array<uint32_t, numWords>;
+
+    std::atomic<uint32_t> mSequence{0};
+    std::array<std::array<std::atomic<uint32_t>, numWords>, 2> mCopies{};
+};
@@ -0,0 +1,442 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <new>
+#include <stop_token>
+#include <thread>
+#include <utility>
+
+#include "utils/task_pool.h"
+
+struct CoroutineTaskStatistics {
+    uint32_t runningTasks = 0;
+    size_t frameBytes = 0;
+};
+
+// Counts the frames of all coroutine tasks, so they can be compared to the stacks of the threads they replace
+class CoroutineTaskCounters {
+public:
+    static void frameAllocated(size_t size) {
+        ++sRunningTasks;
+        sFrameBytes += size;
+    }
+
+    static void frameReleased(size_t size) {
+        --sRunningTasks;
+        sFrameBytes -= size;
+    }
+
+    static CoroutineTaskStatistics statistics() {
+        return CoroutineTaskStatistics{ .runningTasks = sRunningTasks.load(), .frameBytes = sFrameBytes.load() };
+    }
+
+private:
+    static inline std::atomic<uint32_t> sRunningTasks = 0;
+    static inline std::atomic<size_t> sFrameBytes = 0;
+};
+
+// Every callback of the pool runs the coroutine with its step lock held, the lock is released at the next suspension.
+// A coroutine, whose task was destroyed meanwhile, is destroyed instead of resumed.
+template<typename Promise>
+void resumeCoroutine(void *frame) {
+    auto handle = std::coroutine_handle<Promise>::from_address(frame);
+
+    if (!handle.promise().enterStep()) {
+        handle.destroy();
+        return;
+    }
+
+    handle.resume();
+}
+
+/**
+ * \brief A coroutine, which is resumed by the workers of a TaskPool instead of running on a thread of its own.
+ *
+ * The coroutine gets a std::stop_token as its first argument, like the function of a std::jthread, and is started
+ * with spawn. While it waits in co_await sleepFor or co_await untilReady, it neither occupies a worker nor a stack,
+ * only its frame is kept. There is at most one resume of the coroutine pending in the pool at any time.
+ *
+ * A coroutine, which is started with spawnFor, gets its owner with co_await currentOwner<Owner>(). Moving the owner
+ * hands the running coroutine over with handOver, so a move neither waits for the pool nor starts a new coroutine.
+ * Destroying the task requests a stop, the coroutine isn't resumed anymore and its frame is released
+ * by the pool, instead of waiting for it like a std::jthread does.
+ */
+template<typename PoolType>
+class CoroutineTask {
+public:
+    struct promise_type;
+    using HandleType = std::coroutine_handle<promise_type>;
+
+    struct FinalAwaiter {
+        bool await_ready() const noexcept { return false; }
+
+        // The owner destroys the frame, as soon as the step is left, so nothing may touch the frame afterwards
+        void await_suspend(HandleType handle) const noexcept {
+            auto &promise = handle.promise();
+            promise.finished = true;
+            promise.leaveStep();
+        }
+
+        void await_resume() const noexcept { }
+    };
+
+    struct promise_type {
+        using ClockType = typename PoolType::ClockType;
+
+        static void *operator new(size_t size) {
+            CoroutineTaskCounters::frameAllocated(size);
+            return ::operator new(size);
+        }
+
+        static void operator delete(void *frame, size_t size) {
+            CoroutineTaskCounters::frameReleased(size);
+            ::operator delete(frame);
+        }
+
+        CoroutineTask get_return_object() { return CoroutineTask{HandleType::from_promise(*this)}; }
+        std::suspend_always initial_suspend() const noexcept { return {}; }
+        FinalAwaiter final_suspend() const noexcept { return {}; }
+        void return_void() const { }
+        // Exceptions are disabled on the targets
+        void unhandled_exception() const { std::abort(); }
+
+        // The function may run on another worker, before this returns
+        bool schedule(TaskFuncType function, void *argument, std::chrono::milliseconds delay) {
+            auto resume = pool->postTask(TaskDescription{
+                .single_shot = true,
+                .func_ptr = function,
+                .interval = delay,
+                .argument = argument,
+                .description = description,
+                .last_executed = ClockType::now(),
+                .priority = priority
+            });
+
+            if (!resume.isActive()) {
+                return false;
+            }
+
+            (void) resume.release();
+            return true;
+        }
+
+        // Waits for a step of the coroutine, which runs right now, but never for the pool.
+        // Returns false, if the task was destroyed meanwhile, the caller has to destroy the frame then.
+        bool enterStep() {
+            lockStep();
+
+            if (detached) {
+                leaveStep();
+                return false;
+            }
+
+            return true;
+        }
+
+        void lockStep() {
+            while (stepLock.test_and_set(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+        }
+
+        // A single store, so the frame may be destroyed right afterwards
+        void leaveStep() {
+            stepLock.clear(std::memory_order_release);
+        }
+
+        PoolType *pool = nullptr;
+        const char *description = "Coroutine task";
+        TaskPriority priority = TaskPriority::sensing;
+        std::atomic_bool finished = false;
+        // Is only changed while the step lock is held, so the coroutine never sees a half moved owner
+        std::atomic<void *> owner = nullptr;
+        // Held, while the coroutine or one of its polls runs, or while its owner is handed over
+        std::atomic_flag stepLock;
+        // Guarded by the step lock, the task was destroyed, while a resume was pending
+        bool detached = false;
+    };
+
+    CoroutineTask() = default;
+
+    CoroutineTask(const CoroutineTask &other) = delete;
+    CoroutineTask(CoroutineTask &&other) noexcept
+        : mHandle(std::exchange(other.mHandle, nullptr))
+        , mStopSource(std::move(other.mStopSource))
+        , mStarted(std::exchange(other.mStarted, false)) { }
+
+    ~CoroutineTask() {
+        join();
+    }
+
+    CoroutineTask &operator=(const CoroutineTask &other) = delete;
+    CoroutineTask &operator=(CoroutineTask &&other) noexcept {
+        if (this != &other) {
+            join();
+
+            mHandle = std::exchange(other.mHandle, nullptr);
+            mStopSource = std::move(other.mStopSource);
+            mStarted = std::exchange(other.mStarted, false);
+        }
+
+        return *this;
+    }
+
+    template<typename Function, typename ... Arguments>
+    static CoroutineTask spawn(PoolType &pool, const char *description, TaskPriority priority,
+                               Function &&function, Arguments && ... arguments) {
+        return spawnWithOwner(nullptr, pool, description, priority, std::forward<Function>(function),
+                              std::forward<Arguments>(arguments) ...);
+    }
+
+    // The coroutine follows owner, when it is moved and handOver is called
+    template<typename Owner, typename Function, typename ... Arguments>
+    static CoroutineTask spawnFor(Owner *owner, PoolType &pool, const char *description, TaskPriority priority,
+                                  Function &&function, Arguments && ... arguments) {
+        return spawnWithOwner(owner, pool, description, priority, std::forward<Function>(function),
+                              std::forward<Arguments>(arguments) ...);
+    }
+
+    bool requestStop() {
+        return mStopSource.request_stop();
+    }
+
+    // Calls moveState, while the coroutine doesn't run, afterwards the coroutine uses newOwner
+    template<typename Owner, typename MoveState>
+    void handOver(Owner *newOwner, MoveState &&moveState) {
+        if (!mHandle) {
+            moveState();
+            return;
+        }
+
+        auto &promise = mHandle.promise();
+        promise.lockStep();
+
+        moveState();
+        promise.owner.store(newOwner, std::memory_order_relaxed);
+        promise.leaveStep();
+    }
+
+    // Requests a stop and waits for a step, which runs right now, but never for the pool, so it can be called
+    // before the workers run and on a worker as well. Afterwards the coroutine doesn't run anymore,
+    // a pending resume destroys the frame instead. It must not be called from the coroutine itself.
+    void join() {
+        if (!mHandle) {
+            return;
+        }
+
+        mStopSource.request_stop();
+
+        auto &promise = mHandle.promise();
+        promise.lockStep();
+
+        if (mStarted && !promise.finished) {
+            promise.detached = true;
+            promise.leaveStep();
+        } else {
+            promise.leaveStep();
+            mHandle.destroy();
+        }
+
+        mHandle = nullptr;
+        mStarted = false;
+    }
+
+    [[nodiscard]] bool isRunning() const {
+        return mHandle && mStarted && !mHandle.promise().finished;
+    }
+
+private:
+    explicit CoroutineTask(HandleType handle) : mHandle(handle) { }
+
+    template<typename Function, typename ... Arguments>
+    static CoroutineTask spawnWithOwner(void *owner, PoolType &pool, const char *description, TaskPriority priority,
+                                        Function &&function, Arguments && ... arguments) {
+        using namespace std::chrono_literals;
+
+        std::stop_source stopSource;
+        CoroutineTask task = std::invoke(std::forward<Function>(function), stopSource.get_token(),
+                                         std::forward<Arguments>(arguments) ...);
+
+        auto &promise = task.mHandle.promise();
+        promise.pool = &pool;
+        promise.description = description;
+        promise.priority = priority;
+        promise.owner = owner;
+
+        task.mStopSource = std::move(stopSource);
+        task.mStarted = promise.schedule(resumeCoroutine<promise_type>, task.mHandle.address(), 0ms);
+
+        if (!task.mStarted) {
+            Logger::log(LogLevel::Warning, "Couldn't start coroutine task %s", description);
+        }
+
+        return task;
+    }
+
+    HandleType mHandle = nullptr;
+    std::stop_source mStopSource{std::nostopstate};
+    bool mStarted = false;
+};
+
+// Resumes the coroutine after the delay, the worker executes other tasks in the meantime
+class SleepAwaiter {
+public:
+    explicit SleepAwaiter(std::chrono::milliseconds delay) : mDelay(delay) { }
+
+    bool await_ready() const noexcept { return false; }
+
+    template<typename Promise>
+    bool await_suspend(std::coroutine_handle<Promise> handle) const {
+        auto &promise = handle.promise();
+        promise.leaveStep();
+
+        if (promise.schedule(resumeCoroutine<Promise>, handle.address(), mDelay)) {
+            return true;
+        }
+
+        // The pool is full, so the worker has to sleep instead
+        std::this_thread::sleep_for(mDelay);
+
+        if (!promise.enterStep()) {
+            handle.destroy();
+            return true;
+        }
+
+        return false;
+    }
+
+    void await_resume() const noexcept { }
+
+private:
+    std::chrono::milliseconds mDelay;
+};
+
+/**
+ * \brief Polls the predicate on a worker every pollInterval, without resuming the coroutine in between.
+ *
+ * Resumes the coroutine, once the predicate returns true or the timeout expired.
+ * co_await returns the last result of the predicate.
+ */
+template<typename Predicate>
+class ReadyAwaiter {
+public:
+    ReadyAwaiter(Predicate predicate, std::chrono::milliseconds pollInterval, std::chrono::milliseconds timeout)
+        : mPredicate(std::move(predicate)), mPollInterval(pollInterval), mTimeout(timeout) { }
+
+    bool await_ready() {
+        mReady = mPredicate();
+        return mReady;
+    }
+
+    template<typename Promise>
+    bool await_suspend(std::coroutine_handle<Promise> handle) {
+        auto &promise = handle.promise();
+        mFrame = handle.address();
+        mDeadline = Promise::ClockType::now() + mTimeout;
+        promise.leaveStep();
+
+        if (promise.schedule(poll<Promise>, this, mPollInterval)) {
+            return true;
+        }
+
+        if (!promise.enterStep()) {
+            handle.destroy();
+            return true;
+        }
+
+        return false;
+    }
+
+    bool await_resume() const noexcept { return mReady; }
+
+private:
+    template<typename Promise>
+    static void poll(void *argument) {
+        auto *self = static_cast<ReadyAwaiter *>(argument);
+        auto handle = std::coroutine_handle<Promise>::from_address(self->mFrame);
+        auto &promise = handle.promise();
+
+        // The awaiter is part of the frame, so it is gone, once the frame is destroyed
+        if (!promise.enterStep()) {
+            handle.destroy();
+            return;
+        }
+
+        self->mReady = self->mPredicate();
+
+        if (!self->mReady && Promise::ClockType::now() < self->mDeadline) {
+            promise.leaveStep();
+
+            if (promise.schedule(poll<Promise>, self, self->mPollInterval)) {
+                return;
+            }
+
+            if (!promise.enterStep()) {
+                handle.destroy();
+                return;
+            }
+        }
+
+        handle.resume();
+    }
+
+    Predicate mPredicate;
+    std::chrono::milliseconds mPollInterval;
+    std::chrono::milliseconds mTimeout;
+    std::chrono::steady_clock::time_point mDeadline{};
+    void *mFrame = nullptr;
+    bool mReady = false;
+};
+
+// Points to the current owner of the coroutine, it follows the owner, when it is handed over
+template<typename Owner>
+class CoroutineOwner {
+public:
+    explicit CoroutineOwner(const std::atomic<void *> *owner) : mOwner(owner) { }
+
+    // The step lock orders the hand over, so a relaxed load is enough
+    Owner *get() const { return static_cast<Owner *>(mOwner->load(std::memory_order_relaxed)); }
+    Owner *operator->() const { return get(); }
+
+private:
+    const std::atomic<void *> *mOwner;
+};
+
+// Returns the owner of the coroutine without suspending it
+template<typename Owner>
+class OwnerAwaiter {
+public:
+    bool await_ready() const noexcept { return false; }
+
+    template<typename Promise>
+    bool await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+        mOwner = &handle.promise().owner;
+        return false;
+    }
+
+    CoroutineOwner<Owner> await_resume() const noexcept { return CoroutineOwner<Owner>{mOwner}; }
+
+private:
+    const std::atomic<void *> *mOwner = nullptr;
+};
+
+template<typename Owner>
+OwnerAwaiter<Owner> currentOwner() {
+    return OwnerAwaiter<Owner>{};
+}
+
+inline SleepAwaiter sleepFor(std::chrono::milliseconds delay) {
+    return SleepAwaiter{delay};
+}
+
+template<typename Predicate>
+ReadyAwaiter<Predicate> untilReady(Predicate predicate, std::chrono::milliseconds pollInterval,
+                                   std::chrono::milliseconds timeout) {
+    return ReadyAwaiter<Predicate>{std::move(predicate), pollInterval, timeout};
+}
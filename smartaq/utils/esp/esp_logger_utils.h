@@ -8,6 +8,8 @@
 
 #include "network/network_info.h"
 #include "storage/rest_storage.h"
+#include "utils/batching_log_sink.h"
+#include "utils/file_log_sink.h"
 #include "utils/logger.h"
 
 class EspIdfBackend {
@@ -42,38 +44,33 @@ struct HttpLogSinkPathGenerator {
 
 };
 
+// Posts the batches of the HttpLogSink, the connection is kept open between the batches
 template<ConstexprPath RemoteSettingPath>
-class HttpLogSink final {
+class HttpLogTransport final {
     public:
-        bool install();
-        bool uninstall();
+        HttpLogTransport();
+        ~HttpLogTransport();
 
+        HttpLogTransport(const HttpLogTransport &other) = delete;
+        HttpLogTransport &operator=(const HttpLogTransport &other) = delete;
 
-        template<typename ... Arguments>
-        bool log(LogLevel level, const char *fmt, Arguments && ... args);
-    private:
-        static inline RestStorage<HttpLogSinkPathGenerator<RemoteSettingPath>, RestDataType::Json> logSink;
-};
-
-/*
-class SdCardSink final {
-    public:
-        static inline constexpr char log_path_format [] = "%s/logs";
-        static inline constexpr size_t MAX_LOG_FILESIZE = static_cast<size_t>(1024ul * 1024ul / 2); // 0.5 MB
+        bool send(const char *data, size_t length);
+        void disconnect();
 
-        bool install();
-        bool uninstall();
-
-        template<typename ... Arguments>
-        bool log(LogLevel level, const char *fmt, Arguments && ... args);
+        const char *deviceId();
     private:
-        FILE *open_current_log();
-        void potential_flush(int newly_written);
+        bool connect();
 
-        FILE *_log_output_file = nullptr;
-        std::size_t _since_last_flush = 0;
+        esp_http_client_handle_t mClient = nullptr;
+        std::array<char, 128> mTarget{};
+        std::array<char, 18> mDeviceId{};
 };
-*/
+
+template<ConstexprPath RemoteSettingPath>
+using HttpLogSink = BatchingLogSink<HttpLogTransport<RemoteSettingPath>>;
+
+// Keeps the logs on the sd card, the file I/O is done by the drain task, when the logger runs asynchronously
+using SdCardSink = FileLogSink<FixedLogDirectory<ConstexprPath("/external/logs")>>;
 
 template<ConstexprPath RemoteSettingPath>
 template<size_t DstSize>
@@ -85,80 +82,78 @@ bool HttpLogSinkPathGenerator<RemoteSettingPath>::generateRestTarget(std::array<
 }
 
 template<ConstexprPath RemoteSettingPath>
-bool HttpLogSink<RemoteSettingPath>::install() { return true; }
+HttpLogTransport<RemoteSettingPath>::HttpLogTransport() {
+    (void) HttpLogSinkPathGenerator<RemoteSettingPath>::generateRestTarget(mTarget);
+}
 
 template<ConstexprPath RemoteSettingPath>
-bool HttpLogSink<RemoteSettingPath>::uninstall() { return true; }
+HttpLogTransport<RemoteSettingPath>::~HttpLogTransport() {
+    disconnect();
+}
 
+// The sinks are created during static initialization, so the mac is read, once the first record is logged
 template<ConstexprPath RemoteSettingPath>
-template<typename ... Arguments>
-bool HttpLogSink<RemoteSettingPath>::log(LogLevel level, const char *fmt, Arguments && ... args) {
-    if (!NetworkInfo::canUseNetwork()) {
-        return false;
-    }
+const char *HttpLogTransport<RemoteSettingPath>::deviceId() {
+    if (mDeviceId[0] == '\0') {
+        std::array<uint8_t, 6> mac{};
+        esp_efuse_mac_get_default(mac.data());
 
-    std::once_flag initNameAndSink;
-    static std::array<uint8_t, 6> mac;
+        snprintf(mDeviceId.data(), mDeviceId.size(), "%02x-%02x-%02x-%02x-%02x-%02x",
+                 mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+    }
 
-    std::call_once(initNameAndSink, []() {
-        esp_efuse_mac_get_default(mac.data());
-    });
+    return mDeviceId.data();
+}
 
-    std::array<char, 256> json_buf{0};
+// Don't use the Logger in here, this is called with the sink mutex held
+template<ConstexprPath RemoteSettingPath>
+bool HttpLogTransport<RemoteSettingPath>::connect() {
+    esp_http_client_config_t clientConfig{};
+    clientConfig.url = mTarget.data();
+    clientConfig.method = HTTP_METHOD_POST;
+    clientConfig.keep_alive_enable = true;
 
-    const auto written = snprintf(json_buf.data(), json_buf.size(), R"({ "device_id" : "%02x-%02x-%02x-%02x-%02x-%02x", "level" : "%s", "msg" : ")",
-            mac[0], mac[1], mac[2], mac[3], mac[4], mac[5],
-            to_string(level)
-    );
+    mClient = esp_http_client_init(&clientConfig);
 
-    // 3 bytes for closing `" }` and \0 smallest message is empty string
-    if (written < 0 || written >= json_buf.size() - 4) {
-        ESP_LOGI("HttpLogSink", "Couldn't write initial json message");
+    if (mClient == nullptr) {
+        ESP_LOGI("HttpLogSink", "Couldn't create client with target %s", mTarget.data());
         return false;
     }
 
-    auto complete_length = written;
-    complete_length += snprintf(json_buf.data() + written, json_buf.size() - written, fmt, args ...);
+    esp_http_client_set_header(mClient, "Content-Type", DataTypeToContentType<RestDataType::Json>::ContentType);
+    return true;
+}
 
-    if (complete_length < written || complete_length >= json_buf.size() - 4) {
-        ESP_LOGI("HttpLogSink", "Couldn't write log message");
+template<ConstexprPath RemoteSettingPath>
+bool HttpLogTransport<RemoteSettingPath>::send(const char *data, size_t length) {
+    if (!NetworkInfo::canUseNetwork()) {
         return false;
     }
 
-    auto close_json = complete_length;
-    close_json += snprintf(json_buf.data() + complete_length, json_buf.size() - complete_length, R"(" })");
-
-    if (close_json < complete_length || close_json > json_buf.size() - 1) {
-        ESP_LOGI("HttpLogSink", "Couldn't write rest of json");
+    if (mClient == nullptr && !connect()) {
         return false;
     }
 
-    const auto successful = logSink.template writeData<HTTP_METHOD_POST>(json_buf.data(), close_json + 1);
+    esp_http_client_set_post_field(mClient, data, static_cast<int>(length));
 
-    if (!successful) {
-        ESP_LOGI("HttpLogSink", "Couldn't write to stream");
+    // Reuses the open connection, as long as the remote host keeps it alive
+    if (esp_http_client_perform(mClient) != ESP_OK) {
+        ESP_LOGI("HttpLogSink", "Couldn't send batch");
+        disconnect();
         return false;
     }
 
-    return true;
+    const auto statusCode = esp_http_client_get_status_code(mClient);
+    return statusCode >= 200 && statusCode < 300;
 }
 
-/*
-template<typename ... Arguments>
-bool SdCardSink::log(LogLevel level, const char *fmt, Arguments && ... args) {
-    return false;
-
-    auto current_log_file = open_current_log();
-
-    if (current_log_file == nullptr) {
-        return false;
+template<ConstexprPath RemoteSettingPath>
+void HttpLogTransport<RemoteSettingPath>::disconnect() {
+    if (mClient == nullptr) {
+        return;
     }
 
-    const auto written = fprintf(_log_output_file, fmt, std::forward<Arguments>(args) ...);
-
-    potential_flush(written);
-
-    return true;
-
+    esp_http_client_close(mClient);
+    esp_http_client_cleanup(mClient);
+    mClient = nullptr;
 }
-*/
\ No newline at end of file
@@ -45,10 +45,10 @@ int getHeaderValue(httpd_req *req, const char *field, DestType dest, size_t len)
 
 template<typename DestType>
 bool getHeaderValue(httpd_req *req, const char *field, DestType &dest) {
-    auto headerBuffer = SmallerBufferPoolType::get_free_buffer();
+    auto headerBuffer = BufferPoolType::wait_for_free_buffer(small_buffer_size, buffer_wait_timeout);
     const auto headerValueSize = httpd_req_get_hdr_value_len(req, field);
 
-    if (!headerValueSize) {
+    if (!headerBuffer.has_value() || !headerValueSize) {
         return false;
     }
 
@@ -0,0 +1,277 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string_view>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "utils/filesystem_utils.h"
+#include "utils/logger.h"
+
+struct FileLogSinkConfig {
+    // Has to be a multiple of blockSize, full blocks are written, when the buffer runs full
+    size_t bufferSize = 4096;
+    size_t maxFileSize = static_cast<size_t>(512 * 1024);
+    // Including the current file, the oldest one is removed on rotation
+    size_t maxFiles = 4;
+    uint32_t flushIntervalMs = 10000;
+    // Records with this level or above are written and synced with the next poll
+    LogLevel flushLevel = LogLevel::Warning;
+};
+
+struct FileLogSinkStatistics {
+    uint32_t writtenBlocks = 0;
+    uint32_t rotations = 0;
+    uint32_t failedWrites = 0;
+    uint32_t droppedRecords = 0;
+};
+
+template<ConstexprPath Directory>
+struct FixedLogDirectory {
+    static constexpr const char *Path = Directory.value;
+};
+
+/**
+ * \brief A log sink, which collects the records in a buffer and appends them to log.txt in the directory
+ * of PathProvider::Path.
+ *
+ * The buffer is written, once it is full. The drain task polls the sink, it writes the buffer, once the oldest record
+ * waited for the flush interval, and writes and syncs it, once a record with the flush level was logged.
+ * Once log.txt would exceed maxFileSize, it is renamed to log.1.txt, log.1.txt to log.2.txt and so on,
+ * only maxFiles files are kept, a log.txt, which is already too large, is rotated before it is written.
+ * The records are only copied into the buffer, so the logging thread only waits for the file system,
+ * when the buffer is full, as long as the logger runs asynchronously, that's done by the drain task as well.
+ */
+template<typename PathProvider, FileLogSinkConfig Config = FileLogSinkConfig{},
+         typename Clock = std::chrono::steady_clock>
+class FileLogSink final {
+    public:
+        static constexpr size_t blockSize = 512;
+
+        static_assert(Config.bufferSize >= blockSize && Config.bufferSize % blockSize == 0,
+                      "The buffer has to consist of whole blocks");
+        static_assert(Config.maxFiles >= 1 && Config.maxFiles <= 10, "Between one and ten log files are supported");
+
+        FileLogSink() = default;
+        ~FileLogSink() { (void) uninstall(); }
+
+        FileLogSink(const FileLogSink &other) = delete;
+        FileLogSink &operator=(const FileLogSink &other) = delete;
+
+        bool install() { return true; }
+
+        bool uninstall() {
+            const bool flushed = flush(true);
+            closeFile();
+            return flushed;
+        }
+
+        template<typename ... Arguments>
+        bool log(LogLevel level, const char *fmt, Arguments && ... args);
+
+        // Writes the buffer, once the flush interval passed or a record with the flush level was logged
+        void poll();
+
+        // Writes everything, which is buffered, sync also waits for the file system
+        bool flush(bool sync);
+
+        [[nodiscard]] size_t bufferedBytes() const { return mLength; }
+        [[nodiscard]] FileLogSinkStatistics statistics() const { return mStatistics; }
+
+        template<size_t DstSize>
+        static bool logFilePath(std::array<char, DstSize> &dst, size_t index);
+
+    private:
+        bool writeBuffered(size_t length, bool sync);
+        bool openFile();
+        void closeFile();
+        bool rotate();
+
+        std::array<char, Config.bufferSize> mBuffer{};
+        size_t mLength = 0;
+        typename Clock::time_point mFirstBufferedAt{};
+        bool mSyncRequested = false;
+        FILE *mFile = nullptr;
+        size_t mFileSize = 0;
+        FileLogSinkStatistics mStatistics{};
+};
+
+template<typename PathProvider, FileLogSinkConfig Config, typename Clock>
+template<typename ... Arguments>
+bool FileLogSink<PathProvider, Config, Clock>::log(LogLevel level, const char *fmt, Arguments && ... args) {
+    std::array<char, 256> record{};
+    int written = snprintf(record.data(), record.size(), "[%s] ", to_string(level));
+    written += snprintf(record.data() + written, record.size() - written, fmt, args ...);
+
+    if (written < 0) {
+        return false;
+    }
+
+    auto length = std::min(static_cast<size_t>(written), record.size() - 2);
+    record[length++] = '\n';
+
+    if (mLength == 0) {
+        mFirstBufferedAt = Clock::now();
+    }
+
+    // The record is split, so the full buffer is written, which consists of whole blocks
+    size_t copied = 0;
+    if (mLength + length > mBuffer.size()) {
+        const auto previousLength = mLength;
+        copied = mBuffer.size() - mLength;
+        std::memcpy(mBuffer.data() + mLength, record.data(), copied);
+        mLength = mBuffer.size();
+
+        if (!writeBuffered(mLength, false)) {
+            mLength = previousLength;
+            ++mStatistics.droppedRecords;
+            return false;
+        }
+    }
+
+    std::memcpy(mBuffer.data() + mLength, record.data() + copied, length - copied);
+    mLength += length - copied;
+
+    // Syncing takes long, so it is left to the drain task
+    if (level >= Config.flushLevel) {
+        mSyncRequested = true;
+    }
+
+    return true;
+}
+
+template<typename PathProvider, FileLogSinkConfig Config, typename Clock>
+void FileLogSink<PathProvider, Config, Clock>::poll() {
+    if (mSyncRequested) {
+        mSyncRequested = !flush(true);
+        return;
+    }
+
+    if (mLength > 0 && Clock::now() - mFirstBufferedAt >= std::chrono::milliseconds(Config.flushIntervalMs)) {
+        (void) flush(false);
+    }
+}
+
+template<typename PathProvider, FileLogSinkConfig Config, typename Clock>
+bool FileLogSink<PathProvider, Config, Clock>::flush(bool sync) {
+    if (mLength == 0) {
+        return true;
+    }
+
+    return writeBuffered(mLength, sync);
+}
+
+// Writes the first length bytes of the buffer and keeps the rest
+template<typename PathProvider, FileLogSinkConfig Config, typename Clock>
+bool FileLogSink<PathProvider, Config, Clock>::writeBuffered(size_t length, bool sync) {
+    if (length == 0) {
+        return true;
+    }
+
+    if (mFile == nullptr && !openFile()) {
+        ++mStatistics.failedWrites;
+        return false;
+    }
+
+    // An empty file takes the records, even if they exceed the limit on their own
+    if (mFileSize > 0 && mFileSize + length > Config.maxFileSize && (!rotate() || !openFile())) {
+        ++mStatistics.failedWrites;
+        return false;
+    }
+
+    if (std::fwrite(mBuffer.data(), 1, length, mFile) != length || std::fflush(mFile) != 0) {
+        ++mStatistics.failedWrites;
+        closeFile();
+        return false;
+    }
+
+    if (sync) {
+        fsync(fileno(mFile));
+    }
+
+    mFileSize += length;
+    mStatistics.writtenBlocks += static_cast<uint32_t>((length + blockSize - 1) / blockSize);
+
+    std::memmove(mBuffer.data(), mBuffer.data() + length, mLength - length);
+    mLength -= length;
+    mFirstBufferedAt = Clock::now();
+    return true;
+}
+
+template<typename PathProvider, FileLogSinkConfig Config, typename Clock>
+template<size_t DstSize>
+bool FileLogSink<PathProvider, Config, Clock>::logFilePath(std::array<char, DstSize> &dst, size_t index) {
+    const auto written = index == 0
+        ? snprintf(dst.data(), dst.size(), "%s/log.txt", PathProvider::Path)
+        : snprintf(dst.data(), dst.size(), "%s/log.%u.txt", PathProvider::Path, static_cast<unsigned int>(index));
+
+    return written > 0 && static_cast<size_t>(written) < dst.size();
+}
+
+template<typename PathProvider, FileLogSinkConfig Config, typename Clock>
+bool FileLogSink<PathProvider, Config, Clock>::openFile() {
+    std::array<char, 128> path{};
+
+    if (!logFilePath(path, 0)) {
+        return false;
+    }
+
+    // Fails, if the directory already exists, which is fine
+    mkdir(PathProvider::Path, 0777);
+
+    mFile = std::fopen(path.data(), "ab");
+
+    if (mFile == nullptr) {
+        return false;
+    }
+
+    // The sink does the buffering
+    std::setvbuf(mFile, nullptr, _IONBF, 0);
+
+    // A file of a previous boot counts against the limit as well
+    struct stat fileStatus{};
+    mFileSize = stat(path.data(), &fileStatus) == 0 ? static_cast<size_t>(fileStatus.st_size) : 0;
+
+    return true;
+}
+
+template<typename PathProvider, FileLogSinkConfig Config, typename Clock>
+void FileLogSink<PathProvider, Config, Clock>::closeFile() {
+    if (mFile == nullptr) {
+        return;
+    }
+
+    std::fclose(mFile);
+    mFile = nullptr;
+    mFileSize = 0;
+}
+
+// Shifts every file by one index, the one with the highest index is removed
+template<typename PathProvider, FileLogSinkConfig Config, typename Clock>
+bool FileLogSink<PathProvider, Config, Clock>::rotate() {
+    std::array<char, 128> from{};
+    std::array<char, 128> to{};
+
+    closeFile();
+
+    if (!logFilePath(to, Config.maxFiles - 1)) {
+        return false;
+    }
+    std::remove(to.data());
+
+    for (size_t index = Config.maxFiles - 1; index > 0; --index) {
+        if (!logFilePath(from, index - 1) || !logFilePath(to, index)) {
+            return false;
+        }
+        std::rename(from.data(), to.data());
+    }
+
+    ++mStatistics.rotations;
+    return true;
+}
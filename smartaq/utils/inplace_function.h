@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+template<typename Signature, size_t Capacity>
+class InplaceFunction;
+
+/**
+ * \brief A move-only callable, which is stored in a fixed amount of inline storage and never allocates.
+ *
+ * Every callable, e.g. a lambda with captures, can be stored, as long as it fits into Capacity bytes,
+ * this is checked at compile time. Calling an empty InplaceFunction does nothing and returns a value initialized
+ * result.
+ */
+template<typename ReturnType, typename ... Arguments, size_t Capacity>
+class InplaceFunction<ReturnType(Arguments ...), Capacity> {
+public:
+    InplaceFunction() = default;
+    InplaceFunction(std::nullptr_t) { }
+
+    template<typename Callable>
+    requires (!std::is_same_v<std::remove_cvref_t<Callable>, InplaceFunction>
+              && std::is_invocable_r_v<ReturnType, std::decay_t<Callable> &, Arguments ...>)
+    InplaceFunction(Callable &&callable) {
+        using StoredType = std::decay_t<Callable>;
+
+        static_assert(sizeof(StoredType) <= Capacity, "The callable doesn't fit into the storage of the InplaceFunction");
+        static_assert(alignof(StoredType) <= alignof(std::max_align_t), "The callable is overaligned");
+        static_assert(std::is_nothrow_move_constructible_v<StoredType>, "The callable has to be nothrow movable");
+
+        new (mStorage) StoredType(std::forward<Callable>(callable));
+        mOperations = &operationsOf<StoredType>;
+    }
+
+    InplaceFunction(const InplaceFunction &other) = delete;
+    InplaceFunction(InplaceFunction &&other) noexcept {
+        moveFrom(other);
+    }
+
+    ~InplaceFunction() {
+        reset();
+    }
+
+    InplaceFunction &operator=(const InplaceFunction &other) = delete;
+    InplaceFunction &operator=(InplaceFunction &&other) noexcept {
+        if (this != &other) {
+            reset();
+            moveFrom(other);
+        }
+
+        return *this;
+    }
+
+    InplaceFunction &operator=(std::nullptr_t) {
+        reset();
+        return *this;
+    }
+
+    ReturnType operator()(Arguments ... arguments) {
+        if (mOperations == nullptr) {
+            return ReturnType();
+        }
+
+        return mOperations->invoke(mStorage, std::forward<Arguments>(arguments) ...);
+    }
+
+    explicit operator bool() const {
+        return mOperations != nullptr;
+    }
+
+    void reset() {
+        if (mOperations != nullptr) {
+            mOperations->destroy(mStorage);
+            mOperations = nullptr;
+        }
+    }
+
+    [[nodiscard]] static constexpr size_t capacity() { return Capacity; }
+
+private:
+    struct Operations {
+        ReturnType (*invoke)(void *storage, Arguments && ... arguments);
+        void (*moveTo)(void *from, void *to);
+        void (*destroy)(void *storage);
+    };
+
+    template<typename StoredType>
+    static constexpr Operations operationsOf{
+        .invoke = [](void *storage, Arguments && ... arguments) -> ReturnType {
+            return std::invoke(*std::launder(static_cast<StoredType *>(storage)), std::forward<Arguments>(arguments) ...);
+        },
+        .moveTo = [](void *from, void *to) {
+            auto *source = std::launder(static_cast<StoredType *>(from));
+            new (to) StoredType(std::move(*source));
+            source->~StoredType();
+        },
+        .destroy = [](void *storage) {
+            std::launder(static_cast<StoredType *>(storage))->~StoredType();
+        }
+    };
+
+    void moveFrom(InplaceFunction &other) {
+        if (other.mOperations == nullptr) {
+            return;
+        }
+
+        other.mOperations->moveTo(other.mStorage, mStorage);
+        mOperations = std::exchange(other.mOperations, nullptr);
+    }
+
+    alignas(std::max_align_t) std::byte mStorage[Capacity];
+    const Operations *mOperations = nullptr;
+};
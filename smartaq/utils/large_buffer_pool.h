@@ -1,12 +1,18 @@
 #pragma once
 
+#include <algorithm>
 #include <array>
+#include <cstdlib>
+#include <atomic>
+#include <bit>
 #include <memory>
-#include <mutex>
-#include <shared_mutex>
 #include <cstdint>
 #include <optional>
 #include <chrono>
+#include <condition_variable>
+#include <iterator>
+#include <mutex>
+#include <tuple>
 #include <utility>
 #include <limits>
 
@@ -14,8 +20,9 @@
 #include "utils/logger.h"
 #include "utils/buffer_types.h"
 
+#ifdef USE_PSRAM
 #include "esp_heap_caps_init.h"
-#include "memory_helper.h"
+#endif
 
 template<typename PoolType>
 class LargeBufferBorrower {
@@ -53,161 +60,411 @@ class LargeBufferBorrower {
         friend PoolType;
 };
 
-template<size_t BufferSize, BufferLocation BufferType>
-class AllocatedBuffer;
+template<size_t BufferSize, size_t NumBuffers>
+struct BufferSizeClass final {
+    static constexpr size_t bufferSize = BufferSize;
+    static constexpr size_t numBuffers = NumBuffers;
+};
 
-template<size_t BufferSize>
-class AllocatedBuffer<BufferSize, BufferLocation::heap> {
+// A set bit marks an available buffer, the buffers are taken without a lock
+template<size_t NumBuffers>
+class FreeBufferBitmap final {
     public:
-    using buffer_type = std::unique_ptr<char, CustomDelete>;
-
-    // TODO: specify malloc method later on heap_caps_malloc vs malloc
-    AllocatedBuffer() {
-        #ifdef USE_PSRAM
-        m_buffer.reset(reinterpret_cast<char *>(heap_caps_malloc(BufferSize, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT)));
-        #else
-        m_buffer.reset(reinterpret_cast<char *>(malloc(BufferSize)));
-        #endif
-    }
+        FreeBufferBitmap() {
+            for (size_t i = 0; i < mWords.size(); ++i) {
+                const size_t bitsInWord = std::min(NumBuffers - i * bitsPerWord, bitsPerWord);
+                mWords[i] = bitsInWord == bitsPerWord ? ~uint32_t(0) : (uint32_t(1) << bitsInWord) - 1;
+            }
+        }
 
-    constexpr auto size() const { return BufferSize; }
+        // Finds the first available buffer with count-trailing-zeros
+        std::optional<size_t> take() {
+            for (size_t i = 0; i < mWords.size(); ++i) {
+                auto word = mWords[i].load(std::memory_order_relaxed);
 
-    constexpr auto data() const { return m_buffer.get(); }
+                while (word != 0) {
+                    const auto bit = std::countr_zero(word);
 
-    constexpr auto data() { return m_buffer.get(); }
+                    if (mWords[i].compare_exchange_weak(word, word & ~(uint32_t(1) << bit), std::memory_order_acquire,
+                                                        std::memory_order_relaxed)) {
+                        return i * bitsPerWord + static_cast<size_t>(bit);
+                    }
+                }
+            }
 
-    bool isAvailable() const {
-        return m_status == BufferStatus::available;
-    }
+            return std::nullopt;
+        }
 
-    bool giveBack(char *ptr) {
-        if (ptr != m_buffer.get()) {
-            return false;
+        // Returns false, if the buffer wasn't taken
+        bool giveBack(size_t index) {
+            const auto mask = uint32_t(1) << (index % bitsPerWord);
+            return (mWords[index / bitsPerWord].fetch_or(mask, std::memory_order_release) & mask) == 0;
         }
 
-        m_status = BufferStatus::available;
-        return true;
-    }
+    private:
+        static constexpr size_t bitsPerWord = 32;
 
-    template<typename CreationLambda>
-    std::optional<std::invoke_result_t<CreationLambda, char *, size_t>> borrowBuffer(const CreationLambda &create) {
-        if (!isAvailable()) {
-            return std::nullopt;
+        std::array<std::atomic<uint32_t>, (NumBuffers + bitsPerWord - 1) / bitsPerWord> mWords;
+};
+
+// All buffers of a size class are in one block, so the index of a buffer is calculated from its address
+template<typename SizeClass, BufferLocation location>
+class BufferSlab;
+
+template<typename SizeClass>
+class BufferSlab<SizeClass, BufferLocation::heap> final {
+    public:
+        // TODO: specify malloc method later on heap_caps_malloc vs malloc
+        BufferSlab() {
+            #ifdef USE_PSRAM
+            m_buffers.reset(reinterpret_cast<char *>(
+                heap_caps_malloc(slabSize, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT)));
+            #else
+            m_buffers.reset(reinterpret_cast<char *>(malloc(slabSize)));
+            #endif
         }
 
-        m_status = BufferStatus::borrowed;
-        return create(m_buffer.get(), BufferSize);
-    }
+        char *data() { return m_buffers.get(); }
+
+    private:
+        static constexpr size_t slabSize = SizeClass::bufferSize * SizeClass::numBuffers;
+
+        // heap_caps_malloc memory can be freed with free as well
+        struct SlabDelete {
+            void operator()(char *ptr) const { free(ptr); }
+        };
 
-private:
-    std::unique_ptr<char, CustomDelete> m_buffer = nullptr;
-    BufferStatus m_status = BufferStatus::available;
+        std::unique_ptr<char, SlabDelete> m_buffers = nullptr;
 };
 
-template<size_t BufferSize>
-class AllocatedBuffer<BufferSize, BufferLocation::stack> {
+template<typename SizeClass>
+class BufferSlab<SizeClass, BufferLocation::stack> final {
     public:
-    using buffer_type = std::array<char, BufferSize>;
+        char *data() { return m_buffers.data(); }
 
-    AllocatedBuffer() { }
+    private:
+        std::array<char, SizeClass::bufferSize * SizeClass::numBuffers> m_buffers{};
+};
+
+// Upper bounds of the buckets of the wait time histogram, the last bucket holds the longer waits
+static inline constexpr std::array bufferWaitTimeBucketBounds{
+    std::chrono::milliseconds(1), std::chrono::milliseconds(10), std::chrono::milliseconds(100),
+    std::chrono::milliseconds(1000)
+};
+
+struct BufferSizeClassMetrics {
+    size_t bufferSize = 0;
+    size_t numBuffers = 0;
+    uint32_t borrowedBuffers = 0;
+    // The most buffers, which were borrowed at the same time
+    uint32_t highWaterMark = 0;
+    uint32_t waitingCallers = 0;
+    // Calls, which didn't get a buffer in time
+    uint32_t failedAcquisitions = 0;
+    // How long the successful calls waited for their buffer
+    std::array<uint32_t, bufferWaitTimeBucketBounds.size() + 1> waitTimeHistogram{};
+};
+
+namespace Detail {
+    template<typename SizeClass, BufferLocation location>
+    class SizeClassBuffers final {
+        public:
+            static constexpr size_t bufferSize = SizeClass::bufferSize;
+
+            // Waits up to timeout, the callers get their buffers in the order, they started waiting
+            char *acquire(std::chrono::milliseconds timeout);
+
+            bool contains(const char *ptr) {
+                return m_slab.data() != nullptr && ptr >= m_slab.data()
+                    && ptr < m_slab.data() + bufferSize * SizeClass::numBuffers;
+            }
+
+            // Only the start of a buffer can be given back, the buffer goes to the first waiting caller
+            bool giveBack(const char *ptr);
+
+            BufferSizeClassMetrics metrics() const;
+
+        private:
+            // Lives on the stack of the waiting caller
+            struct BufferWaiter {
+                BufferWaiter *next = nullptr;
+                char *buffer = nullptr;
+            };
+
+            char *take();
+            void handOverToWaiters();
+            void removeWaiter(const BufferWaiter *waiter);
+            void recordWaitTime(std::chrono::steady_clock::duration waitTime);
+
+            BufferSlab<SizeClass, location> m_slab;
+            FreeBufferBitmap<SizeClass::numBuffers> m_available;
+
+            std::mutex m_waitMutex;
+            std::condition_variable m_bufferReturned;
+            BufferWaiter *m_firstWaiter = nullptr;
+            BufferWaiter *m_lastWaiter = nullptr;
+            std::atomic<uint32_t> m_numWaiters = 0;
+
+            std::atomic<uint32_t> m_borrowed = 0;
+            std::atomic<uint32_t> m_highWaterMark = 0;
+            std::atomic<uint32_t> m_failedAcquisitions = 0;
+            std::array<std::atomic<uint32_t>, bufferWaitTimeBucketBounds.size() + 1> m_waitTimeHistogram{};
+    };
+
+    template<typename SizeClass, BufferLocation location>
+    char *SizeClassBuffers<SizeClass, location>::acquire(std::chrono::milliseconds timeout) {
+        const auto startedAt = std::chrono::steady_clock::now();
+
+        // Callers, which are already waiting, come first
+        if (m_numWaiters.load() == 0) {
+            if (char *buffer = take(); buffer != nullptr) {
+                recordWaitTime(std::chrono::steady_clock::duration::zero());
+                return buffer;
+            }
+        }
+
+        if (timeout <= std::chrono::milliseconds::zero()) {
+            ++m_failedAcquisitions;
+            return nullptr;
+        }
 
-    constexpr auto size() const { return BufferSize; }
+        std::unique_lock waitGuard{m_waitMutex};
+        ++m_numWaiters;
+        // Pairs with the fence in giveBack, either this take sees the returned buffer or giveBack sees this waiter
+        std::atomic_thread_fence(std::memory_order_seq_cst);
 
-    constexpr auto data() const { return m_buffer.data(); }
+        if (char *buffer = m_firstWaiter == nullptr ? take() : nullptr; buffer != nullptr) {
+            --m_numWaiters;
+            recordWaitTime(std::chrono::steady_clock::now() - startedAt);
+            return buffer;
+        }
+
+        BufferWaiter waiter{};
+        (m_lastWaiter != nullptr ? m_lastWaiter->next : m_firstWaiter) = &waiter;
+        m_lastWaiter = &waiter;
 
-    constexpr auto data() { return m_buffer.data(); }
+        const bool gotBuffer = m_bufferReturned.wait_until(waitGuard, startedAt + timeout, [&waiter]() {
+            return waiter.buffer != nullptr;
+        });
+        --m_numWaiters;
+
+        if (!gotBuffer) {
+            removeWaiter(&waiter);
+            ++m_failedAcquisitions;
+            return nullptr;
+        }
 
-    bool isAvailable() const {
-        return m_status == BufferStatus::available;
+        recordWaitTime(std::chrono::steady_clock::now() - startedAt);
+        return waiter.buffer;
     }
 
-    bool giveBack(char *ptr) {
-        if (ptr != m_buffer.data()) {
+    template<typename SizeClass, BufferLocation location>
+    bool SizeClassBuffers<SizeClass, location>::giveBack(const char *ptr) {
+        const auto offset = static_cast<size_t>(ptr - m_slab.data());
+
+        if (offset % bufferSize != 0 || !m_available.giveBack(offset / bufferSize)) {
             return false;
         }
 
-        m_status = BufferStatus::available;
+        --m_borrowed;
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        if (m_numWaiters.load() > 0) {
+            handOverToWaiters();
+        }
+
         return true;
     }
 
-    template<typename CreationLambda>
-    std::optional<std::invoke_result_t<CreationLambda, char *, size_t>> borrowBuffer(const CreationLambda &create) {
-        if (!isAvailable()) {
-            return std::nullopt;
+    template<typename SizeClass, BufferLocation location>
+    BufferSizeClassMetrics SizeClassBuffers<SizeClass, location>::metrics() const {
+        BufferSizeClassMetrics result{
+            .bufferSize = bufferSize,
+            .numBuffers = SizeClass::numBuffers,
+            .borrowedBuffers = m_borrowed.load(),
+            .highWaterMark = m_highWaterMark.load(),
+            .waitingCallers = m_numWaiters.load(),
+            .failedAcquisitions = m_failedAcquisitions.load()
+        };
+
+        for (size_t i = 0; i < m_waitTimeHistogram.size(); ++i) {
+            result.waitTimeHistogram[i] = m_waitTimeHistogram[i].load();
         }
 
-        m_status = BufferStatus::borrowed;
-        return create(m_buffer.data(), BufferSize);
+        return result;
     }
 
-    private:
-    std::array<char, BufferSize> m_buffer{};
-    BufferStatus m_status = BufferStatus::available;
-};
+    template<typename SizeClass, BufferLocation location>
+    char *SizeClassBuffers<SizeClass, location>::take() {
+        const auto index = m_available.take();
+
+        if (!index.has_value() || m_slab.data() == nullptr) {
+            if (index.has_value()) {
+                (void) m_available.giveBack(*index);
+            }
+            return nullptr;
+        }
+
+        const auto borrowed = ++m_borrowed;
+        auto highWaterMark = m_highWaterMark.load();
+        while (borrowed > highWaterMark && !m_highWaterMark.compare_exchange_weak(highWaterMark, borrowed)) { }
+
+        return m_slab.data() + *index * bufferSize;
+    }
+
+    template<typename SizeClass, BufferLocation location>
+    void SizeClassBuffers<SizeClass, location>::handOverToWaiters() {
+        std::unique_lock waitGuard{m_waitMutex};
+
+        while (m_firstWaiter != nullptr) {
+            char *buffer = take();
+
+            if (buffer == nullptr) {
+                break;
+            }
+
+            m_firstWaiter->buffer = buffer;
+            m_firstWaiter = m_firstWaiter->next;
+
+            if (m_firstWaiter == nullptr) {
+                m_lastWaiter = nullptr;
+            }
+        }
+
+        m_bufferReturned.notify_all();
+    }
+
+    // Has to be called with m_waitMutex held
+    template<typename SizeClass, BufferLocation location>
+    void SizeClassBuffers<SizeClass, location>::removeWaiter(const BufferWaiter *waiter) {
+        BufferWaiter *previous = nullptr;
+
+        for (auto *current = m_firstWaiter; current != nullptr; previous = current, current = current->next) {
+            if (current != waiter) {
+                continue;
+            }
+
+            (previous != nullptr ? previous->next : m_firstWaiter) = current->next;
+
+            if (m_lastWaiter == current) {
+                m_lastWaiter = previous;
+            }
+            return;
+        }
+    }
 
-// TODO: Add multiple sizes
-template<size_t NumBuffers, size_t BufferSize, BufferLocation location = BufferLocation::heap>
-class LargeBufferPool { 
+    template<typename SizeClass, BufferLocation location>
+    void SizeClassBuffers<SizeClass, location>::recordWaitTime(std::chrono::steady_clock::duration waitTime) {
+        const auto bucket = std::find_if(bufferWaitTimeBucketBounds.begin(), bufferWaitTimeBucketBounds.end(),
+            [waitTime](const auto &currentBound) { return waitTime < currentBound; });
+
+        ++m_waitTimeHistogram[static_cast<size_t>(std::distance(bufferWaitTimeBucketBounds.begin(), bucket))];
+    }
+
+    template<typename ... SizeClasses>
+    constexpr bool areAscendingSizeClasses() {
+        constexpr std::array sizes{SizeClasses::bufferSize ...};
+
+        for (size_t i = 1; i < sizes.size(); ++i) {
+            if (sizes[i - 1] >= sizes[i]) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+}
+
+/**
+ * \brief Lends buffers of several size classes, the size classes have to be sorted by their size.
+ *
+ * Callers ask for the size they need and get a buffer of the smallest size class, which is large enough.
+ * Every size class keeps its buffers in one block and marks the available ones in a bitmap,
+ * so borrowing and giving back a buffer doesn't search the buffers and doesn't take a lock.
+ * A size class, which has no buffers left, doesn't borrow from the larger ones,
+ * so small buffers can't use up the large ones.
+ * Callers of wait_for_free_buffer are queued, returned buffers are handed to them in order.
+ */
+template<BufferLocation location, typename ... SizeClasses>
+requires (sizeof...(SizeClasses) > 0 && Detail::areAscendingSizeClasses<SizeClasses ...>())
+class LargeBufferPool {
     public:
-        using AllocatedBufferType = AllocatedBuffer<BufferSize, location>;
-        using LargeBufferBorrowerType = LargeBufferBorrower<LargeBufferPool<NumBuffers, BufferSize, location>>;
-        
-        LargeBufferPool();
-
-        static std::optional<LargeBufferBorrowerType> get_free_buffer();
-        // TODO: implement
-        static std::optional<LargeBufferBorrowerType> wait_for_free_buffer(std::chrono::milliseconds ms);
+        using LargeBufferBorrowerType = LargeBufferBorrower<LargeBufferPool<location, SizeClasses ...>>;
+
+        static constexpr size_t maxBufferSize = std::max({SizeClasses::bufferSize ...});
+
+        // Doesn't wait, if every buffer of the size class is borrowed
+        static std::optional<LargeBufferBorrowerType> get_free_buffer(size_t minimumSize);
+        static std::optional<LargeBufferBorrowerType> wait_for_free_buffer(size_t minimumSize,
+                                                                          std::chrono::milliseconds timeout);
+
+        // Visits the metrics of every size class, starting with the smallest one
+        template<typename Visitor>
+        static void forEachSizeClassMetrics(Visitor &&visitor);
     private:
         static bool return_buffer(char *ptr);
-        static void initialize_buffers();
 
-        static inline std::array<AllocatedBufferType, NumBuffers> _buffers{};
-        static inline std::shared_mutex _instance_mutex{};
+        static inline std::tuple<Detail::SizeClassBuffers<SizeClasses, location> ...> _size_classes{};
 
         friend LargeBufferBorrowerType;
 };
 
-template<size_t NumBuffers, size_t BufferSize, BufferLocation location>
-auto LargeBufferPool<NumBuffers, BufferSize, location>::get_free_buffer() -> std::optional<LargeBufferBorrowerType> {
-    // Leave this in, otherwise the destructor of large_buffer 
-    // (move constructor because of the variable this will be moved in) will lead to a dead-lock
-    std::unique_lock instance_guard{_instance_mutex};
-    std::optional<LargeBufferBorrowerType> foundBuffer = std::nullopt;
-
-    std::any_of(_buffers.begin(), _buffers.end(), [&foundBuffer](auto &current_buffer) {
-        foundBuffer = current_buffer.borrowBuffer([](char *buffer, size_t size) {
-            return LargeBufferBorrowerType(buffer, size);
-        });
-        return foundBuffer.has_value();
-    });
+template<BufferLocation location, typename ... SizeClasses>
+requires (sizeof...(SizeClasses) > 0 && Detail::areAscendingSizeClasses<SizeClasses ...>())
+auto LargeBufferPool<location, SizeClasses ...>::get_free_buffer(size_t minimumSize)
+    -> std::optional<LargeBufferBorrowerType> {
+    return wait_for_free_buffer(minimumSize, std::chrono::milliseconds::zero());
+}
 
-    if (!foundBuffer.has_value()) {
-        Logger::log(LogLevel::Warning, "Couldn't find free buffer");
+template<BufferLocation location, typename ... SizeClasses>
+requires (sizeof...(SizeClasses) > 0 && Detail::areAscendingSizeClasses<SizeClasses ...>())
+auto LargeBufferPool<location, SizeClasses ...>::wait_for_free_buffer(size_t minimumSize,
+                                                                       std::chrono::milliseconds timeout)
+    -> std::optional<LargeBufferBorrowerType> {
+    char *buffer = nullptr;
+    size_t bufferSize = 0;
+
+    // Only the smallest size class, which fits, is asked
+    std::apply([&](auto & ... currentSizeClass) {
+        (void) ((currentSizeClass.bufferSize >= minimumSize
+            && (buffer = currentSizeClass.acquire(timeout), bufferSize = currentSizeClass.bufferSize, true)) || ...);
+    }, _size_classes);
+
+    if (buffer == nullptr) {
+        Logger::log(LogLevel::Warning, "Couldn't find free buffer of %u bytes", static_cast<unsigned int>(minimumSize));
         return std::nullopt;
     }
 
-    Logger::log(LogLevel::Info, "Gave away free buffer %p", foundBuffer->data());
-    return foundBuffer;
+    LOG_IF_ENABLED(LogLevel::Debug, "Gave away free buffer %p", buffer);
+    return LargeBufferBorrowerType(buffer, bufferSize);
+}
+
+template<BufferLocation location, typename ... SizeClasses>
+requires (sizeof...(SizeClasses) > 0 && Detail::areAscendingSizeClasses<SizeClasses ...>())
+template<typename Visitor>
+void LargeBufferPool<location, SizeClasses ...>::forEachSizeClassMetrics(Visitor &&visitor) {
+    std::apply([&visitor](const auto & ... currentSizeClass) {
+        (visitor(currentSizeClass.metrics()), ...);
+    }, _size_classes);
 }
 
-template<size_t NumBuffers, size_t BufferSize, BufferLocation location>
-bool LargeBufferPool<NumBuffers, BufferSize, location>::return_buffer(char *ptr) {
+template<BufferLocation location, typename ... SizeClasses>
+requires (sizeof...(SizeClasses) > 0 && Detail::areAscendingSizeClasses<SizeClasses ...>())
+bool LargeBufferPool<location, SizeClasses ...>::return_buffer(char *ptr) {
     if (ptr == nullptr) {
         return false;
     }
 
-    std::unique_lock instance_guard{_instance_mutex};
-    auto gaveBackBuffer = std::any_of(_buffers.begin(), _buffers.end(), [ptr](auto &current_buffer) {
-        return current_buffer.giveBack(ptr);
-    });
+    const auto gaveBackBuffer = std::apply([ptr](auto & ... currentSizeClass) {
+        return ((currentSizeClass.contains(ptr) && currentSizeClass.giveBack(ptr)) || ...);
+    }, _size_classes);
 
     if (!gaveBackBuffer) {
         Logger::log(LogLevel::Error, "Couldn't give back buffer %p", ptr);
         return false;
     }
 
-    Logger::log(LogLevel::Info, "Got buffer %p back", ptr);
+    LOG_IF_ENABLED(LogLevel::Debug, "Got buffer %p back", ptr);
 
     return true;
-
-}
\ No newline at end of file
+}
@@ -0,0 +1,271 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+#include "utils/do_finally.h"
+
+enum struct LogLevel;
+
+struct LogRateLimitConfig {
+    // Records every call site may log at once
+    uint16_t burst = 5;
+    // One more record per interval is allowed, until the burst is reached again
+    uint32_t refillIntervalMs = 5000;
+    // Repeated records are summarized after this interval, if they are still repeated
+    uint32_t repeatReportIntervalMs = 60000;
+    // Call sites, that are limited at the same time, the rest isn't limited
+    size_t numCallSites = 32;
+};
+
+// What the logger has to write for a call, the summaries come before the record itself
+struct LogAdmission {
+    bool admitted = false;
+    // Records, which were identical to the last written record of the call site
+    uint32_t repeatedRecords = 0;
+    LogLevel repeatedLevel{};
+    // Records of the call site, which were dropped, because its bucket was empty
+    uint32_t suppressedRecords = 0;
+};
+
+namespace Detail {
+    inline constexpr uint32_t logHashOffset = 2166136261u;
+    inline constexpr uint32_t logHashPrime = 16777619u;
+
+    inline uint32_t hashLogBytes(uint32_t hash, const void *data, size_t length) {
+        const auto *bytes = static_cast<const unsigned char *>(data);
+        for (size_t i = 0; i < length; ++i) {
+            hash = (hash ^ bytes[i]) * logHashPrime;
+        }
+        return hash;
+    }
+
+    template<typename T>
+    uint32_t hashLogArgument(uint32_t hash, const T &value) {
+        using ValueType = std::remove_cvref_t<T>;
+
+        // Strings are compared by their address, they needn't be terminated, e.g. for %.*s
+        if constexpr (std::is_array_v<ValueType>) {
+            const auto *address = static_cast<const void *>(value);
+            return hashLogBytes(hash, &address, sizeof(address));
+        } else if constexpr (std::is_arithmetic_v<ValueType> || std::is_enum_v<ValueType> || std::is_pointer_v<ValueType>) {
+            return hashLogBytes(hash, &value, sizeof(value));
+        } else {
+            // Other arguments aren't compared, records with them only differ by the format
+            return hash;
+        }
+    }
+}
+
+// Is used to find identical records, the contents of strings are never read
+template<typename ... Arguments>
+uint32_t hashLogArguments(const Arguments & ... args) {
+    uint32_t hash = Detail::logHashOffset;
+    ((hash = Detail::hashLogArgument(hash, args)), ...);
+    return hash;
+}
+
+/**
+ * \brief Decides, which records are written, while a call site logs the same record over and over.
+ *
+ * The format string identifies the call site. Every call site has a token bucket with Config.burst tokens,
+ * which is refilled with one token per Config.refillIntervalMs, records are dropped, while it is empty.
+ * A record, which is identical to the last written record of its call site, is only counted,
+ * the count is reported, once the call site writes another record or after Config.repeatReportIntervalMs.
+ * The limiter is asked on every call of the logger, so it doesn't take a lock. The call sites are an open addressing
+ * table keyed by the address of the format, an entry is claimed with a compare and swap, and is never emptied again,
+ * it is only taken over by another call site, once it behaves like a new one. The state of a call site is guarded
+ * by a flag, which is only tried, a record, which finds its call site busy, isn't limited.
+ */
+template<LogRateLimitConfig Config = LogRateLimitConfig{}, typename Clock = std::chrono::steady_clock>
+class LogRateLimiter final {
+    public:
+        static_assert(Config.burst > 0, "Every call site has to be able to log at least one record");
+        static_assert(Config.numCallSites > 0, "There has to be at least one call site");
+
+        static constexpr auto refillInterval = std::chrono::milliseconds(Config.refillIntervalMs);
+        static constexpr auto repeatReportInterval = std::chrono::milliseconds(Config.repeatReportIntervalMs);
+
+        LogAdmission admit(LogLevel level, const char *format, uint32_t argumentsHash);
+
+        // Records, which were collapsed or dropped so far
+        [[nodiscard]] uint32_t suppressedRecords() const {
+            return mSuppressedRecords.load(std::memory_order_relaxed);
+        }
+
+    private:
+        struct CallSite {
+            uint16_t tokens = 0;
+            typename Clock::time_point refilledAt{};
+            uint32_t suppressedRecords = 0;
+            // The last written record
+            bool hasLastRecord = false;
+            uint32_t lastArgumentsHash = 0;
+            LogLevel lastLevel{};
+            uint32_t repeatedRecords = 0;
+            typename Clock::time_point reportedAt{};
+        };
+
+        struct Entry {
+            std::atomic<const char *> format{nullptr};
+            std::atomic_flag busy;
+            CallSite callSite;
+
+            bool tryLock() { return !busy.test_and_set(std::memory_order_acquire); }
+            void unlock() { busy.clear(std::memory_order_release); }
+        };
+
+        static size_t startIndex(const char *format) {
+            // The formats are at least a few bytes apart, the low bits don't tell them apart
+            return static_cast<size_t>((reinterpret_cast<uintptr_t>(format) >> 2) * 2654435761u) % Config.numCallSites;
+        }
+
+        Entry *lockEntry(const char *format, typename Clock::time_point now);
+        Entry *takeOverEntry(const char *format, typename Clock::time_point now);
+        static void refill(CallSite &callSite, typename Clock::time_point now);
+
+        std::array<Entry, Config.numCallSites> mEntries{};
+        std::atomic<uint32_t> mSuppressedRecords = 0;
+};
+
+template<LogRateLimitConfig Config, typename Clock>
+LogAdmission LogRateLimiter<Config, Clock>::admit(LogLevel level, const char *format, uint32_t argumentsHash) {
+    const auto now = Clock::now();
+    Entry *entry = lockEntry(format, now);
+
+    // Every entry is in use or the call site is busy, so this record isn't limited
+    if (entry == nullptr) {
+        return LogAdmission{ .admitted = true };
+    }
+
+    DoFinally unlockOp([entry]() {
+        entry->unlock();
+    });
+    CallSite *callSite = &entry->callSite;
+
+    if (callSite->hasLastRecord && callSite->lastArgumentsHash == argumentsHash && callSite->lastLevel == level) {
+        ++callSite->repeatedRecords;
+        mSuppressedRecords.fetch_add(1, std::memory_order_relaxed);
+
+        if (now - callSite->reportedAt < repeatReportInterval) {
+            return LogAdmission{};
+        }
+
+        callSite->reportedAt = now;
+        return LogAdmission{ .repeatedRecords = std::exchange(callSite->repeatedRecords, 0), .repeatedLevel = level };
+    }
+
+    LogAdmission admission{
+        .repeatedRecords = std::exchange(callSite->repeatedRecords, 0),
+        .repeatedLevel = callSite->lastLevel
+    };
+
+    refill(*callSite, now);
+
+    if (callSite->tokens == 0) {
+        ++callSite->suppressedRecords;
+        mSuppressedRecords.fetch_add(1, std::memory_order_relaxed);
+        return admission;
+    }
+
+    --callSite->tokens;
+    admission.suppressedRecords = std::exchange(callSite->suppressedRecords, 0);
+    admission.admitted = true;
+
+    callSite->hasLastRecord = true;
+    callSite->lastArgumentsHash = argumentsHash;
+    callSite->lastLevel = level;
+    callSite->reportedAt = now;
+    return admission;
+}
+
+// Returns the locked entry of the call site, or nullptr, if it is busy or every entry is in use
+template<LogRateLimitConfig Config, typename Clock>
+auto LogRateLimiter<Config, Clock>::lockEntry(const char *format, typename Clock::time_point now) -> Entry * {
+    const auto start = startIndex(format);
+
+    for (size_t i = 0; i < Config.numCallSites; ++i) {
+        auto &currentEntry = mEntries[(start + i) % Config.numCallSites];
+        const char *currentFormat = currentEntry.format.load(std::memory_order_acquire);
+
+        if (currentFormat != nullptr && currentFormat != format) {
+            continue;
+        }
+
+        // A busy entry isn't waited for
+        if (!currentEntry.tryLock()) {
+            return nullptr;
+        }
+
+        // The format only changes under the flag, so the entry could have been claimed or taken over meanwhile
+        if (currentEntry.format.compare_exchange_strong(currentFormat, format, std::memory_order_acq_rel)) {
+            if (currentFormat == nullptr) {
+                currentEntry.callSite = CallSite{ .tokens = Config.burst, .refilledAt = now };
+            }
+            return &currentEntry;
+        }
+
+        if (currentFormat == format) {
+            return &currentEntry;
+        }
+
+        currentEntry.unlock();
+    }
+
+    return takeOverEntry(format, now);
+}
+
+// Entries are never emptied, so the call site isn't in the table, once every entry was in use
+template<LogRateLimitConfig Config, typename Clock>
+auto LogRateLimiter<Config, Clock>::takeOverEntry(const char *format, typename Clock::time_point now) -> Entry * {
+    const auto start = startIndex(format);
+
+    for (size_t i = 0; i < Config.numCallSites; ++i) {
+        auto &currentEntry = mEntries[(start + i) % Config.numCallSites];
+
+        if (!currentEntry.tryLock()) {
+            continue;
+        }
+
+        // Call sites with a full bucket and nothing to report behave like new ones
+        auto &callSite = currentEntry.callSite;
+        refill(callSite, now);
+        if (callSite.tokens == Config.burst && callSite.suppressedRecords == 0 && callSite.repeatedRecords == 0) {
+            currentEntry.format.store(format, std::memory_order_release);
+            callSite = CallSite{ .tokens = Config.burst, .refilledAt = now };
+            return &currentEntry;
+        }
+
+        currentEntry.unlock();
+    }
+
+    return nullptr;
+}
+
+template<LogRateLimitConfig Config, typename Clock>
+void LogRateLimiter<Config, Clock>::refill(CallSite &callSite, typename Clock::time_point now) {
+    if (callSite.tokens == Config.burst) {
+        callSite.refilledAt = now;
+        return;
+    }
+
+    const auto newTokens = (now - callSite.refilledAt) / refillInterval;
+
+    if (newTokens <= 0) {
+        return;
+    }
+
+    if (newTokens >= Config.burst - callSite.tokens) {
+        callSite.tokens = Config.burst;
+        callSite.refilledAt = now;
+        return;
+    }
+
+    callSite.tokens += static_cast<uint16_t>(newTokens);
+    callSite.refilledAt += newTokens * std::chrono::duration_cast<typename Clock::duration>(refillInterval);
+}
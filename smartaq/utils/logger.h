@@ -1,22 +1,80 @@
 #pragma once
 
 #include <array>
+#include <atomic>
 #include <mutex>
+#include <cstdint>
 #include <cstdio>
+#include <cstring>
 #include <string_view>
+#include <thread>
 #include <tuple>
 #include <cstdarg>
 
 #include "utils/filesystem_utils.h"
 #include "utils/do_finally.h"
+#include "utils/binary_log_format.h"
+#include "utils/container/lock_free_queue.h"
+#include "utils/log_rate_limiter.h"
 
 enum struct LogLevel {
     Debug, Info, Warning, Error
 };
 
-const char *to_string(LogLevel level);
+enum struct LogMode : uint8_t {
+    // The sinks are written on the calling thread
+    synchronous,
+    // The records are queued and written to the sinks by the drain task
+    asynchronous
+};
+
+// How queued records are stored
+enum struct LogEncoding : uint8_t {
+    // Formatted by the thread, that logged it
+    text,
+    // Records with only numbers and pointers as arguments keep the format string and the raw arguments,
+    // they are formatted by the drain task
+    binary
+};
+
+// What happens to a record, which is logged while the queue is full
+enum struct LogOverflowPolicy : uint8_t {
+    dropOldest, dropNew, block
+};
+
+static inline constexpr size_t asyncLogMessageSize = 120;
+static inline constexpr size_t asyncLogQueueSize = 32;
+
+// Binary records have a format, their message holds the encoded arguments instead of the text
+struct LogRecord {
+    LogLevel level;
+    uint8_t argumentsLength = 0;
+    const char *format = nullptr;
+    std::array<char, asyncLogMessageSize> message;
+};
+
+struct LogStatistics {
+    uint32_t droppedRecords = 0;
+    // Didn't fit into a record, so they were truncated
+    uint32_t oversizedRecords = 0;
+    // Were dropped or collapsed by the rate limit
+    uint32_t suppressedRecords = 0;
+};
+
+inline const char *to_string(LogLevel level) {
+    switch (level) {
+        case LogLevel::Debug:
+            return "debug";
+        case LogLevel::Info:
+            return "info";
+        case LogLevel::Warning:
+            return "warn";
+        case LogLevel::Error:
+            return "error";
+    }
+    return "";
+}
 
-// TODO: Create quite backend for unit-tests
 class PrintfBackend {
     public:
         template<typename ... Arguments>
@@ -29,7 +87,35 @@ class PrintfBackend {
         static void uninstall() { }
 };
 
-template<typename Backend, typename ... Sinks>
+// Drops everything, used for unit-tests and benchmarks
+class QuietBackend {
+    public:
+        template<typename ... Arguments>
+        static void log(LogLevel, const char *, Arguments &&...) { }
+
+        static void install() { }
+        static void uninstall() { }
+};
+
+// Checks the level of the Logger, before the arguments are evaluated, Logger::log only filters,
+// once they were built. Meant for hot call sites, whose arguments aren't free.
+#define LOG_IF_ENABLED(level, ...) \
+    do { \
+        if (Logger::isEnabled(level)) { \
+            (void) Logger::log(level, __VA_ARGS__); \
+        } \
+    } while (false)
+
+/**
+ * \brief Writes log records to the backend and all sinks.
+ *
+ * Records below MinimumLevel are removed at compile time, as long as the level is a constant at the call site.
+ * Records below the level set with ignoreLogsBelow are dropped at runtime, before anything is formatted.
+ * Use isEnabled or LOG_IF_ENABLED to skip building expensive arguments.
+ * With the rate limit enabled, call sites, which log the same records over and over, are limited,
+ * the dropped and repeated records are summarized with the next record of the call site, that is written.
+ */
+template<typename Backend, LogLevel MinimumLevel, typename ... Sinks>
 class ApplicationLogger final {
     public:
         ApplicationLogger() = delete;
@@ -42,14 +128,61 @@ class ApplicationLogger final {
 
         static void ignoreLogsBelow(LogLevel level);
 
+        static bool isEnabled(LogLevel level) {
+            return level >= MinimumLevel && level >= _ignoreLogsBelow.load(std::memory_order_relaxed);
+        }
+
+        // Records, which are logged after this, are queued until drain is called.
+        // With the binary encoding the format strings have to be string literals.
+        static void enableAsync(LogOverflowPolicy policy, LogEncoding encoding = LogEncoding::text);
+        // Writes the queued records, then logs synchronously again
+        static void disableAsync();
+
+        // Writes all queued records to the sinks, returns the number of written records
+        static size_t drain();
+        // Can be posted to a TaskPool as drain task
+        static void drainTask(void *);
+
+        // Limits the records per call site and collapses identical records
+        static void enableRateLimit();
+        static void disableRateLimit();
+
+        static LogStatistics statistics();
+
+        // Gives access to sinks, which keep the records, e.g. to serve them
+        template<typename Sink>
+        static Sink &sink() {
+            initSinksAndInstall();
+            return std::get<Sink>(_sinks);
+        }
+
         static int printf_log(const char *fmt, va_list list);
     private:
         static void initSinksAndInstall();
 
+        template<typename ... Arguments>
+        static bool dispatch(LogLevel level, const char *fmt, Arguments &&... args);
+
+        template<typename ... Arguments>
+        static bool logToSinks(LogLevel level, const char *fmt, Arguments &&... args);
+
+        template<typename ... Arguments>
+        static bool enqueue(LogLevel level, const char *fmt, Arguments &&... args);
+
+        static bool push(const LogRecord &record);
+
         static inline std::tuple<Sinks ...> _sinks;
         static inline std::once_flag _initializedSinks;
         static inline std::mutex _sinkMutex;
-        static inline LogLevel _ignoreLogsBelow;
+        static inline std::atomic<LogLevel> _ignoreLogsBelow = LogLevel::Debug;
+        static inline LockFreeQueue<LogRecord, asyncLogQueueSize> _records;
+        static inline std::atomic<LogMode> _mode = LogMode::synchronous;
+        static inline std::atomic<LogOverflowPolicy> _overflowPolicy = LogOverflowPolicy::dropOldest;
+        static inline std::atomic<LogEncoding> _encoding = LogEncoding::text;
+        static inline std::atomic<uint32_t> _droppedRecords = 0;
+        static inline std::atomic<uint32_t> _oversizedRecords = 0;
+        static inline std::atomic_bool _rateLimited = false;
+        static inline LogRateLimiter<> _rateLimiter;
         static inline DoFinally unistallHook{
             []() {
                 std::apply([](auto &&... currentSink) {
@@ -61,8 +194,8 @@ class ApplicationLogger final {
         };
 };
 
-template<typename Backend, typename ... Sinks>
-void ApplicationLogger<Backend, Sinks ...>::initSinksAndInstall() {
+template<typename Backend, LogLevel MinimumLevel, typename ... Sinks>
+void ApplicationLogger<Backend, MinimumLevel, Sinks ...>::initSinksAndInstall() {
     std::unique_lock sinkGuard{_sinkMutex};
     std::call_once(_initializedSinks, []() {
         std::apply([](auto && ...currentSink) {
@@ -73,24 +206,185 @@ void ApplicationLogger<Backend, Sinks ...>::initSinksAndInstall() {
     });
 }
 
-template<typename Backend, typename ... Sinks>
-void ApplicationLogger<Backend, Sinks ...>::install() {
+template<typename Backend, LogLevel MinimumLevel, typename ... Sinks>
+void ApplicationLogger<Backend, MinimumLevel, Sinks ...>::install() {
     initSinksAndInstall();
 }
 
 
-template<typename Backend, typename ... Sinks>
-void ApplicationLogger<Backend, Sinks ...>::ignoreLogsBelow(LogLevel level) {
+template<typename Backend, LogLevel MinimumLevel, typename ... Sinks>
+void ApplicationLogger<Backend, MinimumLevel, Sinks ...>::ignoreLogsBelow(LogLevel level) {
+    _ignoreLogsBelow.store(level, std::memory_order_relaxed);
+}
+
+template<typename Backend, LogLevel MinimumLevel, typename ... Sinks>
+void ApplicationLogger<Backend, MinimumLevel, Sinks ...>::enableAsync(LogOverflowPolicy policy, LogEncoding encoding) {
+    _overflowPolicy = policy;
+    _encoding = encoding;
+    _mode = LogMode::asynchronous;
+}
+
+template<typename Backend, LogLevel MinimumLevel, typename ... Sinks>
+void ApplicationLogger<Backend, MinimumLevel, Sinks ...>::disableAsync() {
+    _mode = LogMode::synchronous;
+    (void) drain();
+}
+
+template<typename Backend, LogLevel MinimumLevel, typename ... Sinks>
+size_t ApplicationLogger<Backend, MinimumLevel, Sinks ...>::drain() {
     std::unique_lock sinkGuard{_sinkMutex};
+    size_t drainedRecords = 0;
+
+    while (const auto record = _records.pop()) {
+        if (record->format != nullptr) {
+            std::array<char, 2 * asyncLogMessageSize> formatted;
+            (void) formatBinaryLogRecord(formatted.data(), formatted.size(), record->format, record->message.data(),
+                                         record->argumentsLength);
+            (void) logToSinks(record->level, "%s", formatted.data());
+        } else {
+            (void) logToSinks(record->level, "%s", record->message.data());
+        }
+        ++drainedRecords;
+    }
+
+    // Sinks, which batch their records, get the chance to send them
+    std::apply([](auto && ... currentSink) {
+        ([&currentSink]() {
+            if constexpr (requires { currentSink.poll(); }) {
+                currentSink.poll();
+            }
+        }(), ...);
+    }, _sinks);
+
+    return drainedRecords;
+}
+
+template<typename Backend, LogLevel MinimumLevel, typename ... Sinks>
+void ApplicationLogger<Backend, MinimumLevel, Sinks ...>::drainTask(void *) {
+    (void) drain();
+}
+
+template<typename Backend, LogLevel MinimumLevel, typename ... Sinks>
+void ApplicationLogger<Backend, MinimumLevel, Sinks ...>::enableRateLimit() {
+    _rateLimited = true;
+}
+
+template<typename Backend, LogLevel MinimumLevel, typename ... Sinks>
+void ApplicationLogger<Backend, MinimumLevel, Sinks ...>::disableRateLimit() {
+    _rateLimited = false;
+}
+
+template<typename Backend, LogLevel MinimumLevel, typename ... Sinks>
+LogStatistics ApplicationLogger<Backend, MinimumLevel, Sinks ...>::statistics() {
+    return LogStatistics{
+        .droppedRecords = _droppedRecords.load(),
+        .oversizedRecords = _oversizedRecords.load(),
+        .suppressedRecords = _rateLimiter.suppressedRecords()
+    };
+}
+
+template<typename Backend, LogLevel MinimumLevel, typename ... Sinks>
+template<typename ... Arguments>
+bool ApplicationLogger<Backend, MinimumLevel, Sinks ...>::log(LogLevel level, const char *fmt, Arguments &&... args) {
+    // Filtered records aren't an error
+    if (!isEnabled(level)) {
+        return true;
+    }
+
+    if (!_rateLimited.load(std::memory_order_relaxed)) {
+        return dispatch(level, fmt, std::forward<Arguments>(args) ...);
+    }
+
+    const auto admission = _rateLimiter.admit(level, fmt, hashLogArguments(args ...));
+
+    if (admission.repeatedRecords > 0) {
+        (void) dispatch(admission.repeatedLevel, "Repeated %u times : \"%s\"",
+                        static_cast<unsigned int>(admission.repeatedRecords), fmt);
+    }
+
+    if (admission.suppressedRecords > 0) {
+        (void) dispatch(level, "Suppressed %u records of \"%s\"",
+                        static_cast<unsigned int>(admission.suppressedRecords), fmt);
+    }
 
-    _ignoreLogsBelow = level;
+    // Suppressed records aren't an error either
+    if (!admission.admitted) {
+        return true;
+    }
+
+    return dispatch(level, fmt, std::forward<Arguments>(args) ...);
 }
 
-template<typename Backend, typename ... Sinks>
+template<typename Backend, LogLevel MinimumLevel, typename ... Sinks>
 template<typename ... Arguments>
-bool ApplicationLogger<Backend, Sinks ...>::log(LogLevel level, const char *fmt, Arguments &&... args) {
+bool ApplicationLogger<Backend, MinimumLevel, Sinks ...>::dispatch(LogLevel level, const char *fmt, Arguments &&... args) {
+    if (_mode == LogMode::asynchronous) {
+        return enqueue(level, fmt, std::forward<Arguments>(args) ...);
+    }
+
     std::unique_lock sinkGuard{_sinkMutex};
 
+    return logToSinks(level, fmt, std::forward<Arguments>(args) ...);
+}
+
+// The record is formatted on the calling thread, no lock is taken, records, which don't fit, are truncated
+template<typename Backend, LogLevel MinimumLevel, typename ... Sinks>
+template<typename ... Arguments>
+bool ApplicationLogger<Backend, MinimumLevel, Sinks ...>::enqueue(LogLevel level, const char *fmt, Arguments &&... args) {
+    LogRecord record{ .level = level };
+
+    // Only copies the arguments, the formatting is left to the drain task
+    if constexpr ((BinaryLogArgument<Arguments> && ...)) {
+        if (_encoding == LogEncoding::binary) {
+            if (const auto encodedLength = encodeBinaryLogArguments(record.message.data(), record.message.size(), args ...)) {
+                record.format = fmt;
+                record.argumentsLength = static_cast<uint8_t>(*encodedLength);
+                return push(record);
+            }
+        }
+    }
+
+    const auto length = snprintf(record.message.data(), record.message.size(), fmt, args ...);
+
+    if (length < 0) {
+        return false;
+    }
+
+    // Writing it synchronously would make the caller wait for the sinks
+    if (static_cast<size_t>(length) >= record.message.size()) {
+        ++_oversizedRecords;
+        std::memcpy(record.message.data() + record.message.size() - 4, "...", 4);
+    }
+
+    return push(record);
+}
+
+template<typename Backend, LogLevel MinimumLevel, typename ... Sinks>
+bool ApplicationLogger<Backend, MinimumLevel, Sinks ...>::push(const LogRecord &record) {
+    // Blocking only makes progress, while the drain task is running
+    while (!_records.push(record)) {
+        switch (_overflowPolicy.load()) {
+            case LogOverflowPolicy::dropNew:
+                ++_droppedRecords;
+                return false;
+            case LogOverflowPolicy::dropOldest:
+                if (_records.pop().has_value()) {
+                    ++_droppedRecords;
+                }
+                break;
+            case LogOverflowPolicy::block:
+                std::this_thread::yield();
+                break;
+        }
+    }
+
+    return true;
+}
+
+// Has to be called with _sinkMutex held
+template<typename Backend, LogLevel MinimumLevel, typename ... Sinks>
+template<typename ... Arguments>
+bool ApplicationLogger<Backend, MinimumLevel, Sinks ...>::logToSinks(LogLevel level, const char *fmt, Arguments &&... args) {
     const auto loggedSuccessfully = std::apply([&](auto && ... currentSink) {
         std::array results{(currentSink.log(level, fmt, args ...), ...)};
 
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+
+#include "utils/container/ring_buffer.h"
+#include "utils/logger.h"
+
+template<size_t MessageSize>
+struct RecentLogRecord {
+    uint32_t sequence = 0;
+    LogLevel level = LogLevel::Debug;
+    uint32_t uptimeMs = 0;
+    std::array<char, MessageSize> message{};
+};
+
+struct RecentLogRange {
+    // Sequence of the last record, which was passed to the visitor, can be used as since of the next call
+    uint32_t lastSequence = 0;
+    // Records after since, which were already overwritten
+    uint32_t missedRecords = 0;
+};
+
+/**
+ * \brief A log sink, which keeps the last NumRecords records in memory, so they can be fetched without a serial
+ * connection or a remote log host.
+ *
+ * Every record gets a sequence number, which starts at one, so readers can fetch only the records,
+ * they haven't seen yet. Messages longer than MessageSize are truncated.
+ */
+template<size_t NumRecords, size_t MessageSize = asyncLogMessageSize, typename Clock = std::chrono::steady_clock>
+class MemoryLogSink final {
+    public:
+        using RecordType = RecentLogRecord<MessageSize>;
+
+        static_assert(NumRecords > 1, "At least two records have to be kept");
+
+        bool install() { return true; }
+        bool uninstall() { return true; }
+
+        template<typename ... Arguments>
+        bool log(LogLevel level, const char *fmt, Arguments && ... args);
+
+        // Calls visitor with every kept record, which is newer than since, until it returns false.
+        // The records are locked meanwhile, so the visitor mustn't log.
+        template<typename Visitor>
+        RecentLogRange forEachRecordSince(uint32_t since, Visitor &&visitor) const;
+
+        [[nodiscard]] uint32_t lastSequence() const {
+            std::unique_lock guard{mMutex};
+            return mLastSequence;
+        }
+
+    private:
+        mutable std::mutex mMutex;
+        RingBuffer<RecordType, NumRecords> mRecords;
+        uint32_t mLastSequence = 0;
+        typename Clock::time_point mStartedAt = Clock::now();
+};
+
+template<size_t NumRecords, size_t MessageSize, typename Clock>
+template<typename ... Arguments>
+bool MemoryLogSink<NumRecords, MessageSize, Clock>::log(LogLevel level, const char *fmt, Arguments && ... args) {
+    RecordType record{
+        .level = level,
+        .uptimeMs = static_cast<uint32_t>(
+            std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - mStartedAt).count())
+    };
+
+    if (snprintf(record.message.data(), record.message.size(), fmt, args ...) < 0) {
+        return false;
+    }
+
+    std::unique_lock guard{mMutex};
+    record.sequence = ++mLastSequence;
+    mRecords.append(record);
+    return true;
+}
+
+template<size_t NumRecords, size_t MessageSize, typename Clock>
+template<typename Visitor>
+RecentLogRange MemoryLogSink<NumRecords, MessageSize, Clock>::forEachRecordSince(uint32_t since,
+                                                                                  Visitor &&visitor) const {
+    std::unique_lock guard{mMutex};
+    RecentLogRange range{ .lastSequence = since };
+
+    // A reader, which is ahead, e.g. after a reboot, gets everything again
+    if (since > mLastSequence) {
+        since = 0;
+        range.lastSequence = 0;
+    }
+
+    if (mRecords.size() == 0) {
+        return range;
+    }
+
+    const auto oldestSequence = mRecords[0].sequence;
+    size_t index = 0;
+
+    if (since + 1 < oldestSequence) {
+        range.missedRecords = oldestSequence - since - 1;
+    } else {
+        index = since + 1 - oldestSequence;
+    }
+
+    for (; index < mRecords.size(); ++index) {
+        if (!visitor(mRecords[index])) {
+            break;
+        }
+        range.lastSequence = mRecords[index].sequence;
+    }
+
+    return range;
+}
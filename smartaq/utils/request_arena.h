@@ -0,0 +1,135 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+/**
+ * \brief A bump pointer allocator over memory, which is borrowed for a single request.
+ *
+ * An allocation only moves the pointer forward, there is no bookkeeping per object and nothing is freed on its own.
+ * The whole arena is released at once, when the request is done and the memory is given back,
+ * therefore only trivially destructible objects can be created in it.
+ * While a RequestArenaScope exists, the handler of the request can get the arena with RequestArena::current().
+ */
+class RequestArena final {
+    public:
+        RequestArena(char *memory, size_t size) : mBegin(memory), mCurrent(memory), mEnd(memory + size) {}
+
+        RequestArena(const RequestArena &other) = delete;
+        RequestArena &operator=(const RequestArena &other) = delete;
+
+        // Returns nullptr, if the allocation doesn't fit into the rest of the arena
+        void *allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+        // The elements are default initialized, so char buffers aren't cleared
+        template<typename T>
+        requires (std::is_trivially_destructible_v<T>)
+        std::span<T> allocateArray(size_t count);
+
+        template<typename T, typename ... Arguments>
+        requires (std::is_trivially_destructible_v<T>)
+        T *create(Arguments && ... args);
+
+        // The copy is zero terminated, so it can be passed to the C apis as well,
+        // a view without data is returned, if it doesn't fit
+        std::string_view copyString(std::string_view value);
+
+        // Hands out everything, which is left, e.g. for the answer of the handler
+        std::span<char> allocateRemaining();
+
+        void reset() { mCurrent = mBegin; }
+
+        [[nodiscard]] size_t capacity() const { return static_cast<size_t>(mEnd - mBegin); }
+        [[nodiscard]] size_t used() const { return static_cast<size_t>(mCurrent - mBegin); }
+        [[nodiscard]] size_t remaining() const { return static_cast<size_t>(mEnd - mCurrent); }
+
+        // The arena of the request, which is handled by this thread, nullptr outside of a request
+        static RequestArena *current() { return _current; }
+
+    private:
+        static inline thread_local RequestArena *_current = nullptr;
+
+        char *mBegin;
+        char *mCurrent;
+        char *mEnd;
+
+        friend class RequestArenaScope;
+};
+
+// Makes the arena the current one of this thread, until the scope ends
+class RequestArenaScope final {
+    public:
+        explicit RequestArenaScope(RequestArena &arena) : mPrevious(std::exchange(RequestArena::_current, &arena)) {}
+        ~RequestArenaScope() { RequestArena::_current = mPrevious; }
+
+        RequestArenaScope(const RequestArenaScope &other) = delete;
+        RequestArenaScope &operator=(const RequestArenaScope &other) = delete;
+
+    private:
+        RequestArena *mPrevious;
+};
+
+inline void *RequestArena::allocate(size_t size, size_t alignment) {
+    const auto address = reinterpret_cast<uintptr_t>(mCurrent);
+    const auto padding = (alignment - address % alignment) % alignment;
+
+    if (padding > remaining() || size > remaining() - padding) {
+        return nullptr;
+    }
+
+    void *allocated = mCurrent + padding;
+    mCurrent += padding + size;
+    return allocated;
+}
+
+template<typename T>
+requires (std::is_trivially_destructible_v<T>)
+std::span<T> RequestArena::allocateArray(size_t count) {
+    if (count > remaining() / sizeof(T)) {
+        return {};
+    }
+
+    auto *elements = static_cast<T *>(allocate(sizeof(T) * count, alignof(T)));
+
+    if (elements == nullptr) {
+        return {};
+    }
+
+    std::uninitialized_default_construct_n(elements, count);
+    return std::span<T>(elements, count);
+}
+
+template<typename T, typename ... Arguments>
+requires (std::is_trivially_destructible_v<T>)
+T *RequestArena::create(Arguments && ... args) {
+    void *memory = allocate(sizeof(T), alignof(T));
+
+    if (memory == nullptr) {
+        return nullptr;
+    }
+
+    return new (memory) T(std::forward<Arguments>(args) ...);
+}
+
+inline std::string_view RequestArena::copyString(std::string_view value) {
+    auto copy = allocateArray<char>(value.size() + 1);
+
+    if (copy.empty()) {
+        return {};
+    }
+
+    std::memcpy(copy.data(), value.data(), value.size());
+    copy[value.size()] = '\0';
+    return std::string_view(copy.data(), value.size());
+}
+
+inline std::span<char> RequestArena::allocateRemaining() {
+    return allocateArray<char>(remaining());
+}
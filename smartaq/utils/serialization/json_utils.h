@@ -50,11 +50,31 @@ struct read_from_json<int> {
     }
 };
 
+template<>
+struct read_from_json<SampleFilterKind> {
+    static void read(const char *str, int len, SampleFilterKind &kind) {
+        std::string_view input(str, len);
+
+        kind = SampleFilterKind::none;
+
+        if (input == "median") {
+            kind = SampleFilterKind::median;
+        } else if (input == "hampel") {
+            kind = SampleFilterKind::hampel;
+        } else if (input == "trimmed_mean") {
+            kind = SampleFilterKind::trimmedMean;
+        }
+    }
+};
+
 template<typename InnerType>
 struct read_from_json<SampleContainerSettings<InnerType>>
 {
     static void read(const char *str, int len, SampleContainerSettings<InnerType> &user_data) {
-        json_scanf(str, len, "{ max_rate_of_change : %f }", &user_data.maxRateOfChange);
+        json_scanf(str, len, "{ max_rate_of_change : %f, filter : %M, hampel_threshold : %f, trim_fraction : %f }",
+                   &user_data.maxRateOfChange,
+                   json_scanf_single<decltype(user_data.filter.kind)>, &user_data.filter.kind,
+                   &user_data.filter.hampelThreshold, &user_data.filter.trimFraction);
     }
 };
 
@@ -2,36 +2,62 @@
 
 #include <array>
 #include <algorithm>
+#include <atomic>
+#include <bit>
 #include <cstdint> 
 #include <limits>
-#include <memory>
 #include <mutex>
-#include <shared_mutex>
 #include <optional>
 #include <thread>
 #include <chrono>
+#include <concepts>
 #include <condition_variable>
 #include <type_traits>
+#include <utility>
 
+#include "utils/inplace_function.h"
 #include "utils/logger.h"
 #include "utils/container/fixed_size_optional_array.h"
+#include "utils/container/indexed_min_heap.h"
+#include "utils/container/lock_free_queue.h"
+#include "utils/container/ring_buffer.h"
 
 using TaskFuncType = void(*)(void *);
+// Lambdas with a few captures can be stored in the task itself, larger captures don't compile
+using TaskFunction = InplaceFunction<void(), 32>;
 
 enum struct TaskId : uint64_t {
     invalid = std::numeric_limits<uint64_t>::max()
 };
 
-template<auto PoolSize>
-concept ValidTaskPoolArgs = (std::is_unsigned_v<decltype(PoolSize)>);
+template<auto PoolSize, auto NumWorkers>
+concept ValidTaskPoolArgs = (std::is_unsigned_v<decltype(PoolSize)> && NumWorkers > 0);
+
+// The time points of the tasks are steady_clock time points, other clocks have to use them as well
+template<typename C>
+concept TaskPoolClock = std::same_as<typename C::time_point, std::chrono::steady_clock::time_point>
+    && requires { { C::now() } -> std::same_as<typename C::time_point>; };
+
+// Clocks, which don't run in real time, provide their own waitUntil
+template<typename C, typename Predicate>
+bool waitUntil(std::condition_variable &condition, std::unique_lock<std::mutex> &lock,
+               typename C::time_point deadline, Predicate predicate) {
+    if constexpr (requires { C::waitUntil(condition, lock, deadline, predicate); }) {
+        return C::waitUntil(condition, lock, deadline, predicate);
+    } else {
+        return condition.wait_until(lock, deadline, predicate);
+    }
+}
 
 template<typename PoolType>
 class TaskResourceTracker {
 public:
-        explicit TaskResourceTracker(void *resource = nullptr, TaskId id = TaskId::invalid) : m_resource(resource), m_id(id) { }
+        TaskResourceTracker() = default;
+        TaskResourceTracker(PoolType *pool, void *resource, TaskId id) : m_pool(pool), m_resource(resource), m_id(id) { }
 
         TaskResourceTracker(const TaskResourceTracker &other) = delete;
-        TaskResourceTracker(TaskResourceTracker &&other) noexcept : m_resource(other.m_resource), m_id(other.m_id) {
+        TaskResourceTracker(TaskResourceTracker &&other) noexcept : m_pool(other.m_pool), m_resource(other.m_resource), m_id(other.m_id) {
+            other.m_pool = nullptr;
             other.m_resource = nullptr;
             other.m_id = TaskId::invalid;
         }
@@ -44,6 +70,7 @@ public:
         TaskResourceTracker &operator=(TaskResourceTracker &&other) noexcept {
             using std::swap;
 
+            swap(m_pool, other.m_pool);
             swap(m_resource, other.m_resource);
             swap(m_id, other.m_id);
 
@@ -52,7 +79,7 @@ public:
 
         bool isActive()
         {
-            return m_id != TaskId::invalid;
+            return m_pool != nullptr && m_id != TaskId::invalid;
         }
 
         void invalidate()
@@ -61,12 +88,21 @@ public:
                 return;
             }
 
-            const auto removed [[maybe_unused]] = PoolType::removeTask(m_id);
+            const auto removed [[maybe_unused]] = m_pool->removeTask(m_id);
+        }
+
+        // The task stays in the pool, a single shot task frees its slot, once it is finished
+        TaskId release()
+        {
+            m_pool = nullptr;
+            m_resource = nullptr;
+            return std::exchange(m_id, TaskId::invalid);
         }
 
         void swap(TaskResourceTracker &other) noexcept {
             using std::swap;
 
+            swap(m_pool, other.m_pool);
             swap(m_resource, other.m_resource);
             swap(m_id, other.m_id);
         }
@@ -76,8 +112,59 @@ public:
         [[nodiscard]] TaskId id() const { return m_id; }
 
     private:
+        PoolType *m_pool = nullptr;
         const void* m_resource = nullptr;
-        TaskId m_id;
+        TaskId m_id = TaskId::invalid;
+};
+
+// Due tasks of a higher class are always dispatched first, inside of a class the task with the earliest deadline wins
+enum struct TaskPriority : uint8_t {
+    control, sensing, housekeeping
+};
+
+static inline constexpr size_t numTaskPriorities = 3;
+
+// A task is considered late, once it starts later than its deadline after it became due
+constexpr std::chrono::milliseconds deadlineOf(TaskPriority priority) {
+    using namespace std::chrono_literals;
+
+    switch (priority) {
+        case TaskPriority::control:
+            return 100ms;
+        case TaskPriority::sensing:
+            return 1000ms;
+        case TaskPriority::housekeeping:
+            return 10000ms;
+    }
+    return 10000ms;
+}
+
+constexpr const char *to_string(TaskPriority priority) {
+    switch (priority) {
+        case TaskPriority::control:
+            return "control";
+        case TaskPriority::sensing:
+            return "sensing";
+        case TaskPriority::housekeeping:
+            return "housekeeping";
+    }
+    return "";
+}
+
+// A fixed delay task is executed again one interval after it finished, so it drifts by its execution time.
+// A fixed rate task is executed one interval after its previous deadline.
+enum struct TaskRateMode : uint8_t {
+    fixedDelay, fixedRate
+};
+
+// What a fixed rate task does, once one or more deadlines passed while it was late
+enum struct TaskCatchUpPolicy : uint8_t {
+    // Continues with the next deadline in the future, the missed ones are skipped
+    skipMissed,
+    // Executes once right away for all missed deadlines, then continues with the next one in the future
+    runOnce,
+    // Executes once for every missed deadline, back to back
+    burst
 };
 
 struct TaskDescription {
@@ -86,215 +173,976 @@ struct TaskDescription {
     std::chrono::milliseconds interval = std::chrono::milliseconds{5};
     void *argument = nullptr;
     const char *description = "No Description";
-    std::chrono::steady_clock::time_point last_executed;
+    // Without a value the task is due right away, its first run isn't late then
+    std::optional<std::chrono::steady_clock::time_point> last_executed;
+    TaskPriority priority = TaskPriority::sensing;
+    TaskRateMode rate_mode = TaskRateMode::fixedDelay;
+    TaskCatchUpPolicy catch_up = TaskCatchUpPolicy::skipMissed;
+    // The task may start this much after its next execution time, so it can share a wakeup with other tasks
+    std::chrono::milliseconds slack = std::chrono::milliseconds{0};
+    // Is executed instead of func_ptr, if it is set
+    TaskFunction function{};
 };
 
-// TODO: maybe use multiple threads
-// TODO: use instance, instead of static functions
-template<auto TaskPoolSize>
-requires (ValidTaskPoolArgs<TaskPoolSize>)
+static inline constexpr size_t taskExecutionHistogramSize = 6;
+
+// Upper bounds of the execution time histogram buckets, the last bucket takes everything above
+inline constexpr std::array<std::chrono::microseconds, taskExecutionHistogramSize - 1> taskExecutionHistogramBounds{
+    std::chrono::microseconds(100), std::chrono::milliseconds(1), std::chrono::milliseconds(10),
+    std::chrono::milliseconds(100), std::chrono::seconds(1)
+};
+
+constexpr size_t executionHistogramBucketOf(std::chrono::microseconds executionTime) {
+    size_t bucket = 0;
+    while (bucket < taskExecutionHistogramBounds.size() && executionTime >= taskExecutionHistogramBounds[bucket]) {
+        ++bucket;
+    }
+    return bucket;
+}
+
+// A snapshot of the metrics of a single task, lateness is the actual start minus the end of the slack window.
+// A run of a periodic task overruns, if it takes longer than the interval of the task.
+// The drift is how far the deadlines moved away from the grid of the first deadline, fixed rate tasks don't drift.
+struct TaskMetrics {
+    TaskId id = TaskId::invalid;
+    const char *description = "";
+    TaskPriority priority = TaskPriority::sensing;
+    uint32_t runs = 0;
+    uint32_t overruns = 0;
+    std::chrono::microseconds lastExecutionTime{0};
+    std::chrono::microseconds averageExecutionTime{0};
+    std::chrono::microseconds maxExecutionTime{0};
+    std::chrono::microseconds lastLateness{0};
+    std::chrono::microseconds averageLateness{0};
+    std::chrono::microseconds maxLateness{0};
+    uint32_t skippedRuns = 0;
+    std::chrono::microseconds accumulatedDrift{0};
+    std::array<uint32_t, taskExecutionHistogramSize> executionTimeHistogram{};
+};
+
+struct TaskLatenessStatistics {
+    uint32_t runs = 0;
+    uint32_t deadlineMisses = 0;
+    std::chrono::microseconds averageLateness{0};
+    std::chrono::microseconds maxLateness{0};
+};
+
+/**
+ * \brief Executes scheduled tasks on a fixed number of workers.
+ *
+ * Every worker calls doWork with its own index from its own thread. Pending tasks are ordered by their
+ * next execution time in one schedule per priority class. A worker, which finds due tasks, keeps the first one
+ * and hands the others to idle workers, each of them is woken up separately. Each worker owns a deque of
+ * ready tasks, idle workers steal from the back of the other deques. One idle worker at a time sleeps until the
+ * next deadline (the timekeeper), the others sleep until they get work handed to them. Tasks with slack may start
+ * later than their next execution time, the timekeeper wakes up at the end of the first slack window and every
+ * task, whose window started until then, is executed with this wakeup.
+ *
+ * Posting, removing and reposting tasks never takes a lock. Slots are taken from a lock-free free list,
+ * every change to the schedules is submitted through a lock-free queue, which the dispatching worker drains
+ * into the schedules. Only workers ever touch the schedules.
+ *
+ * With more than one worker, sensing and housekeeping tasks never occupy all workers at once,
+ * so there is always a worker left for control tasks.
+ */
+template<auto TaskPoolSize, auto NumWorkers = 1u, TaskPoolClock Clock = std::chrono::steady_clock>
+requires (ValidTaskPoolArgs<TaskPoolSize, NumWorkers>)
 class TaskPool {
     public:
         using TaskResourceType = TaskResourceTracker<TaskPool>;
+        using ClockType = Clock;
 
-        [[nodiscard]] static TaskResourceType postTask(TaskDescription task);
-        [[nodiscard]] static bool removeTask(TaskId& id);
-        [[noreturn]] static void doWork();
+        TaskPool();
+        ~TaskPool() = default;
 
-    private:
-        static auto handleTaskExecutions();
-        static void repostTask(const std::pair<TaskId, TaskDescription>& task);
+        TaskPool(const TaskPool &other) = delete;
+        TaskPool(TaskPool &&other) = delete;
+
+        TaskPool &operator=(const TaskPool &other) = delete;
+        TaskPool &operator=(TaskPool &&other) = delete;
+
+        [[nodiscard]] TaskResourceType postTask(TaskDescription task);
+        [[nodiscard]] bool removeTask(TaskId& id);
+
+        // Runs the worker with the index workerIndex until requestStop is called
+        void doWork(size_t workerIndex);
+        void requestStop();
+
+        [[nodiscard]] TaskLatenessStatistics latenessOf(TaskPriority priority) const;
+        [[nodiscard]] std::optional<TaskMetrics> metricsOf(TaskId id) const;
 
+        // Calls visitor with the metrics of every task, which is currently part of the pool,
+        // until it returns false, e.g. because its buffer is full
+        template<typename Visitor>
+        void forEachTaskMetrics(Visitor &&visitor) const;
+
+        [[nodiscard]] static constexpr size_t numWorkers() { return NumWorkers; }
+
+    private:
         using TaskInfo = std::pair<TaskId, TaskDescription>;
+        using SlotIndexType = HeapHandleType<TaskPoolSize>;
 
-        static inline FixedSizeOptionalArray<TaskInfo, TaskPoolSize> _tasks;
-        static inline std::recursive_timed_mutex taskListMutex;
-        static inline std::condition_variable_any notify;
-        static inline TaskId _next_id = TaskId(0);
+        enum struct CommandType : uint8_t {
+            post, finish, remove
+        };
+
+        struct Command {
+            CommandType type;
+            SlotIndexType slot;
+            TaskId id;
+            std::chrono::steady_clock::time_point lastExecuted;
+        };
+
+        // What the workers know about the task in a slot. It is only touched with mScheduleMutex held,
+        // so a stale command is recognized by its id without reading a slot, which might be reused already.
+        struct SlotOwner {
+            TaskId id = TaskId::invalid;
+            // Ready or executed right now, the finish command frees the slot of a removed task then
+            bool running = false;
+        };
+
+        struct Worker {
+            std::mutex workerMutex;
+            std::condition_variable wakeup;
+            // Every task is at most once in one of the deques, so they can't overflow.
+            // The tasks stay in their slots, only their ids are queued.
+            RingBuffer<TaskId, TaskPoolSize + 1> readyTasks;
+            bool wakeupPending = false;
+            std::atomic_bool idle = false;
+        };
+
+        struct PriorityStatistics {
+            std::atomic<uint32_t> runs = 0;
+            std::atomic<uint32_t> deadlineMisses = 0;
+            std::atomic<uint64_t> summedLatenessUs = 0;
+            std::atomic<uint64_t> maxLatenessUs = 0;
+        };
+
+        // Written by the worker executing the task, read without any lock
+        struct TaskCounters {
+            std::atomic<const char *> description = "";
+            std::atomic<TaskPriority> priority = TaskPriority::sensing;
+            std::atomic<uint32_t> runs = 0;
+            std::atomic<uint32_t> overruns = 0;
+            std::atomic<uint64_t> lastExecutionUs = 0;
+            std::atomic<uint64_t> summedExecutionUs = 0;
+            std::atomic<uint64_t> maxExecutionUs = 0;
+            std::atomic<uint64_t> lastLatenessUs = 0;
+            std::atomic<uint64_t> summedLatenessUs = 0;
+            std::atomic<uint64_t> maxLatenessUs = 0;
+            // Written by the worker, which applies the finish commands
+            std::atomic<uint32_t> skippedRuns = 0;
+            std::atomic<uint64_t> accumulatedDriftUs = 0;
+            std::array<std::atomic<uint32_t>, taskExecutionHistogramSize> executionTimeHistogram{};
+        };
+
+        static constexpr size_t noWorker = std::numeric_limits<size_t>::max();
+        static constexpr size_t maxLowerPriorityRuns = NumWorkers > 1 ? NumWorkers - 1 : 1;
+        // Each task has at most one post or finish and one remove command in flight, this leaves room for stale ones
+        static constexpr size_t submissionQueueSize = std::bit_ceil(4 * static_cast<size_t>(TaskPoolSize));
+
+        std::optional<TaskId> takeReadyTask(size_t workerIndex);
+        std::optional<std::chrono::steady_clock::time_point> dispatchDueTasks(size_t workerIndex);
+        void waitForWork(size_t workerIndex, std::chrono::steady_clock::time_point nextExecutionAt);
+        void executeTask(TaskId id);
+        bool reserveRun(TaskPriority priority);
+        std::chrono::steady_clock::duration recordLateness(const TaskDescription &task,
+                                                           std::chrono::steady_clock::time_point startedAt);
+        void recordMetrics(SlotIndexType slot, const TaskDescription &task, std::chrono::steady_clock::duration lateness,
+                           std::chrono::steady_clock::duration executionTime);
+        void recordDrift(SlotIndexType slot, std::chrono::steady_clock::duration drift, uint32_t skippedRuns);
+        void resetMetrics(SlotIndexType slot, const TaskDescription &task);
+        std::optional<TaskMetrics> readMetrics(SlotIndexType slot) const;
+
+        void submit(const Command &command);
+        void drainSubmissions();
+        void applyCommand(const Command &command);
+        void addToSchedule(SlotIndexType slot, const TaskDescription &task);
+        bool removeFromSchedule(SlotIndexType slot, TaskPriority priority);
+
+        void handTaskToWorker(size_t workerIndex, TaskId id);
+        void wakeupWorker(size_t workerIndex);
+        std::optional<size_t> findIdleWorker(size_t excludedWorker);
+        size_t nextWorkerFor(size_t dispatchingWorker);
+        void handOverTimekeeping(size_t workerIndex);
+
+        void releaseSlot(SlotIndexType slot);
+        bool isCurrentTask(SlotIndexType slot, TaskId id) const;
+
+        auto &scheduleOf(TaskPriority priority) { return mSchedules[static_cast<size_t>(priority)]; }
+
+        // Tasks are stored in fixed slots. A slot belongs to the thread, which took it from mFreeSlots,
+        // until its post command is submitted, after that it belongs to the workers.
+        FixedSizeOptionalArray<TaskInfo, TaskPoolSize> mTasks;
+        // The id of the task, which currently owns the slot, removing a task invalidates it right away
+        std::array<std::atomic<TaskId>, TaskPoolSize> mSlotIds;
+        LockFreeQueue<SlotIndexType, std::bit_ceil(static_cast<size_t>(TaskPoolSize))> mFreeSlots;
+        LockFreeQueue<Command, submissionQueueSize> mSubmissions;
+        std::atomic<uint32_t> mNextGeneration = 0;
+        // Sensing and housekeeping tasks, which are ready or executed right now
+        std::atomic<size_t> mLowerPriorityRuns = 0;
+
+        // The pending tasks are ordered by their next execution time in the schedule of their priority.
+        // Tasks, which are ready or currently executed, keep their slot, but aren't part of a schedule.
+        std::array<IndexedMinHeap<std::chrono::steady_clock::time_point, TaskPoolSize>, numTaskPriorities> mSchedules;
+        // The pending tasks of all schedules ordered by the end of their slack window, the timekeeper wakes up
+        // at the first one and dispatches every task, whose window started until then
+        IndexedMinHeap<std::chrono::steady_clock::time_point, TaskPoolSize> mLatestStarts;
+        // Guarded by mScheduleMutex
+        std::array<SlotOwner, TaskPoolSize> mSlotOwners;
+        // Guards the schedules, only workers take it
+        std::mutex mScheduleMutex;
+
+        std::array<Worker, NumWorkers> mWorkers;
+        std::atomic<size_t> mTimekeeper = noWorker;
+        // Guarded by mScheduleMutex
+        std::chrono::steady_clock::time_point mTimekeeperDeadline{};
+        std::atomic<size_t> mNextHandoff = 0;
+        std::atomic_bool mStopRequested = false;
+
+        std::array<PriorityStatistics, numTaskPriorities> mPriorityStatistics;
+        std::array<TaskCounters, TaskPoolSize> mTaskCounters;
+
+        // Lets the tests fill the submission queue with stale commands
+        template<typename PoolType>
+        friend struct TaskPoolTestAccess;
 };
 
+// last_executed has a value, once the task was posted
 inline auto calculateNextExecutionTime(const TaskDescription &info) {
-    return info.last_executed + info.interval;
+    return *info.last_executed + info.interval;
 }
 
-template <auto TaskPoolSize> requires (ValidTaskPoolArgs<TaskPoolSize>)
-auto TaskPool<TaskPoolSize>::handleTaskExecutions() {
-    using namespace std::chrono;
+struct NextExecutionReference {
+    std::chrono::steady_clock::time_point lastExecuted;
+    uint32_t skippedRuns = 0;
+};
+
+// Returns what last_executed of a periodic task becomes after the run for deadline, which finished at finishedAt
+inline NextExecutionReference calculateNextExecutionReference(const TaskDescription &info,
+                                                              std::chrono::steady_clock::time_point deadline,
+                                                              std::chrono::steady_clock::time_point finishedAt) {
+    if (info.rate_mode == TaskRateMode::fixedDelay || info.interval <= std::chrono::milliseconds::zero()) {
+        return NextExecutionReference{ .lastExecuted = finishedAt };
+    }
+
+    if (info.catch_up == TaskCatchUpPolicy::burst || finishedAt < deadline) {
+        return NextExecutionReference{ .lastExecuted = deadline };
+    }
+
+    // Deadlines, which passed after deadline until the run was finished
+    const auto missed = static_cast<uint32_t>((finishedAt - deadline) / info.interval);
+
+    if (info.catch_up == TaskCatchUpPolicy::runOnce && missed > 0) {
+        return NextExecutionReference{ .lastExecuted = deadline + (missed - 1) * info.interval, .skippedRuns = missed - 1 };
+    }
+
+    return NextExecutionReference{ .lastExecuted = deadline + missed * info.interval, .skippedRuns = missed };
+}
+
+inline void storeMaximum(std::atomic<uint64_t> &maximum, uint64_t value) {
+    auto currentMax = maximum.load();
+    while (currentMax < value && !maximum.compare_exchange_weak(currentMax, value)) { }
+}
+
+// The lower half of the id is the slot of the task, the upper half makes the id unique over time,
+// so a stale id of a finished task can't remove a newer task in the same slot.
+constexpr TaskId makeTaskId(uint32_t generation, uint32_t slot) {
+    return static_cast<TaskId>((static_cast<uint64_t>(generation) << 32u) | slot);
+}
+
+constexpr uint32_t slotOfTaskId(TaskId id) {
+    return static_cast<uint32_t>(static_cast<uint64_t>(id) & std::numeric_limits<uint32_t>::max());
+}
+
+template <auto TaskPoolSize, auto NumWorkers, TaskPoolClock Clock> requires (ValidTaskPoolArgs<TaskPoolSize, NumWorkers>)
+TaskPool<TaskPoolSize, NumWorkers, Clock>::TaskPool() {
+    for (size_t i = 0; i < TaskPoolSize; ++i) {
+        mSlotIds[i] = TaskId::invalid;
+        (void) mFreeSlots.push(static_cast<SlotIndexType>(i));
+    }
+}
+
+// Has to be called with mScheduleMutex held
+template <auto TaskPoolSize, auto NumWorkers, TaskPoolClock Clock> requires (ValidTaskPoolArgs<TaskPoolSize, NumWorkers>)
+void TaskPool<TaskPoolSize, NumWorkers, Clock>::releaseSlot(SlotIndexType slot) {
+    mSlotOwners[slot] = SlotOwner{};
+    mTasks.erase(slot);
+    (void) mFreeSlots.push(slot);
+}
+
+template <auto TaskPoolSize, auto NumWorkers, TaskPoolClock Clock> requires (ValidTaskPoolArgs<TaskPoolSize, NumWorkers>)
+bool TaskPool<TaskPoolSize, NumWorkers, Clock>::isCurrentTask(SlotIndexType slot, TaskId id) const {
+    return id != TaskId::invalid && mSlotIds[slot] == id;
+}
+
+template <auto TaskPoolSize, auto NumWorkers, TaskPoolClock Clock> requires (ValidTaskPoolArgs<TaskPoolSize, NumWorkers>)
+void TaskPool<TaskPoolSize, NumWorkers, Clock>::doWork(size_t workerIndex)
+{
+    if (workerIndex >= NumWorkers)
+    {
+        Logger::log(LogLevel::Error, "There is no worker with index %u", static_cast<unsigned int>(workerIndex));
+        return;
+    }
+
+    while (!mStopRequested)
+    {
+        if (auto readyTask = takeReadyTask(workerIndex); readyTask.has_value())
+        {
+            handOverTimekeeping(workerIndex);
+            executeTask(*readyTask);
+            continue;
+        }
+
+        const auto nextExecutionAt = dispatchDueTasks(workerIndex);
 
-    const auto nowSinceEpoch = steady_clock::now();
-    // TODO: Add second thread to next regular execution?
-    steady_clock::time_point nextRegularExecution{ nowSinceEpoch + milliseconds{2000 } };
+        if (!nextExecutionAt.has_value())
+        {
+            continue;
+        }
+
+        waitForWork(workerIndex, *nextExecutionAt);
+    }
+}
+
+template <auto TaskPoolSize, auto NumWorkers, TaskPoolClock Clock> requires (ValidTaskPoolArgs<TaskPoolSize, NumWorkers>)
+void TaskPool<TaskPoolSize, NumWorkers, Clock>::requestStop()
+{
+    mStopRequested = true;
+
+    for (size_t i = 0; i < NumWorkers; ++i)
+    {
+        wakeupWorker(i);
+    }
+}
 
-    std::optional<TaskInfo> nextTask;
+// Takes from the front of the own deque, or steals from the back of the deque of another worker
+template <auto TaskPoolSize, auto NumWorkers, TaskPoolClock Clock> requires (ValidTaskPoolArgs<TaskPoolSize, NumWorkers>)
+auto TaskPool<TaskPoolSize, NumWorkers, Clock>::takeReadyTask(size_t workerIndex) -> std::optional<TaskId>
+{
     {
-        std::unique_lock instanceGuard{taskListMutex, std::defer_lock};
-        if (!instanceGuard.try_lock_for(1000ms))
+        auto &self = mWorkers[workerIndex];
+        std::unique_lock workerGuard{self.workerMutex};
+
+        if (auto ownTask = self.readyTasks.takeFront(); ownTask.has_value())
         {
-            return nextRegularExecution;
+            return ownTask;
         }
+    }
 
-        decltype(_tasks.begin()) toExecute = _tasks.end();;
+    for (size_t i = 1; i < NumWorkers; ++i)
+    {
+        auto &victim = mWorkers[(workerIndex + i) % NumWorkers];
+        std::unique_lock victimGuard{victim.workerMutex};
 
-        for (auto currentTask = _tasks.begin(); currentTask != _tasks.end(); ++currentTask)
+        if (auto stolenTask = victim.readyTasks.takeBack(); stolenTask.has_value())
         {
-            if (currentTask->first == TaskId::invalid)
-            {
-                continue;
-            }
+            return stolenTask;
+        }
+    }
 
-            // Logger::log(LogLevel::Debug, "Checking task %s", currentTask->second.description);
+    return std::nullopt;
+}
 
-            if (toExecute == _tasks.end())
-            {
-                toExecute = currentTask;
-                continue;
-            }
+// Applies all submitted changes, then moves all due tasks from the schedules to the workers,
+// higher priorities first. The first one is kept by this worker.
+// Returns the time of the next execution, if there is nothing to do right now.
+template <auto TaskPoolSize, auto NumWorkers, TaskPoolClock Clock> requires (ValidTaskPoolArgs<TaskPoolSize, NumWorkers>)
+auto TaskPool<TaskPoolSize, NumWorkers, Clock>::dispatchDueTasks(size_t workerIndex)
+    -> std::optional<std::chrono::steady_clock::time_point>
+{
+    using namespace std::chrono;
+
+    const auto now = Clock::now();
+    auto nextExecutionAt = now + milliseconds{2000};
+
+    {
+        std::unique_lock scheduleGuard{mScheduleMutex};
+        bool keptTask = false;
+
+        drainSubmissions();
+
+        // Tasks are only dispatched, once the first slack window ended, then every task, whose window
+        // started, is executed with the same wakeup
+        const auto firstLatestStart = mLatestStarts.top();
+        const bool windowEnded = firstLatestStart.has_value() && mLatestStarts.key(*firstLatestStart) <= now;
 
-            if (calculateNextExecutionTime(currentTask->second) < calculateNextExecutionTime(toExecute->second))
+        for (auto &currentSchedule : mSchedules)
+        {
+            while (const auto nextSlot = currentSchedule.top())
             {
-                toExecute = currentTask;
+                const auto slot = static_cast<SlotIndexType>(*nextSlot);
+                const auto thisWantsToExecuteAt = currentSchedule.key(slot);
+                if (thisWantsToExecuteAt > now || !windowEnded)
+                {
+                    nextExecutionAt = std::min(nextExecutionAt, thisWantsToExecuteAt);
+                    break;
+                }
+
+                const auto &dueTask = *mTasks[slot];
+
+                // Removed, but the remove command wasn't applied yet, it frees the slot, once it arrives
+                if (!isCurrentTask(slot, dueTask.first))
+                {
+                    (void) removeFromSchedule(slot, dueTask.second.priority);
+                    continue;
+                }
+
+                // The worker, which finishes one of the lower priority runs, will dispatch the rest
+                if (!reserveRun(dueTask.second.priority))
+                {
+                    break;
+                }
+
+                // The task keeps its slot while it is ready or executed, so it can be reposted with the same id afterwards
+                (void) removeFromSchedule(slot, dueTask.second.priority);
+                mSlotOwners[slot].running = true;
+                handTaskToWorker(keptTask ? nextWorkerFor(workerIndex) : workerIndex, dueTask.first);
+                keptTask = true;
             }
         }
 
-        if (toExecute == _tasks.end())
+        if (keptTask)
         {
-            return nextRegularExecution;
+            return std::nullopt;
         }
 
-        const auto thisWantsToExecuteAt = calculateNextExecutionTime(toExecute->second);
-        if (thisWantsToExecuteAt > nowSinceEpoch)
+        // A due task, which waits for a lower priority run, is already past the end of its window
+        if (const auto latestSlot = mLatestStarts.top(); latestSlot.has_value() && mLatestStarts.key(*latestSlot) > now)
         {
-            return thisWantsToExecuteAt;
+            nextExecutionAt = std::min(mLatestStarts.key(*latestSlot), now + milliseconds{2000});
         }
 
-        nextTask = *toExecute;
-        (void) removeTask(toExecute->first);
+        if (size_t currentTimekeeper = noWorker; mTimekeeper.compare_exchange_strong(currentTimekeeper, workerIndex))
+        {
+            mTimekeeperDeadline = nextExecutionAt;
+        }
+        else if (nextExecutionAt < mTimekeeperDeadline)
+        {
+            // A reposted task is due before the timekeeper wakes up
+            wakeupWorker(currentTimekeeper);
+        }
     }
 
-    if (!nextTask.has_value())
+    // A task submitted after draining, but before the timekeeper was claimed, didn't wake anyone
+    if (!mSubmissions.empty())
     {
-        return nextRegularExecution;
+        size_t expectedTimekeeper = workerIndex;
+        mTimekeeper.compare_exchange_strong(expectedTimekeeper, noWorker);
+        return std::nullopt;
     }
 
-    auto &currentTaskToExecute = nextTask.value().second;
+    return nextExecutionAt;
+}
 
-    Logger::log(LogLevel::Info,
-                            "=====================================[ In :%s ]======================================",
-                            currentTaskToExecute.description);
+// Has to be called with mScheduleMutex held, so only one worker at a time reserves runs
+template <auto TaskPoolSize, auto NumWorkers, TaskPoolClock Clock> requires (ValidTaskPoolArgs<TaskPoolSize, NumWorkers>)
+bool TaskPool<TaskPoolSize, NumWorkers, Clock>::reserveRun(TaskPriority priority)
+{
+    if (priority == TaskPriority::control)
+    {
+        return true;
+    }
 
-    if (currentTaskToExecute.func_ptr != nullptr) {
-        currentTaskToExecute.func_ptr(currentTaskToExecute.argument);
+    if (mLowerPriorityRuns >= maxLowerPriorityRuns)
+    {
+        return false;
     }
 
-    Logger::log(LogLevel::Info,
-                "=====================================[ Out : %s ] =====================================",
-                currentTaskToExecute.description);
+    ++mLowerPriorityRuns;
+    return true;
+}
 
-    if (currentTaskToExecute.single_shot) {
-        return nextRegularExecution;
-    }
+template <auto TaskPoolSize, auto NumWorkers, TaskPoolClock Clock> requires (ValidTaskPoolArgs<TaskPoolSize, NumWorkers>)
+void TaskPool<TaskPoolSize, NumWorkers, Clock>::waitForWork(size_t workerIndex,
+                                                     std::chrono::steady_clock::time_point nextExecutionAt)
+{
+    using namespace std::chrono;
 
-    currentTaskToExecute.last_executed = steady_clock::now();
+    auto &self = mWorkers[workerIndex];
+    const bool isTimekeeper = mTimekeeper == workerIndex;
+    const auto wakeupAt = isTimekeeper
+        ? std::min(nextExecutionAt, Clock::now() + 5000ms)
+        : Clock::now() + 5000ms;
 
-    repostTask(*nextTask);
+    {
+        std::unique_lock workerGuard{self.workerMutex};
+        self.idle = true;
+        waitUntil<Clock>(self.wakeup, workerGuard, wakeupAt, [this, &self]()
+        {
+            return self.wakeupPending || !self.readyTasks.empty() || mStopRequested;
+        });
+        self.wakeupPending = false;
+        self.idle = false;
+    }
 
-    return std::min(nextRegularExecution, calculateNextExecutionTime(currentTaskToExecute));
+    if (isTimekeeper)
+    {
+        size_t expectedTimekeeper = workerIndex;
+        mTimekeeper.compare_exchange_strong(expectedTimekeeper, noWorker);
+    }
 }
 
-template <auto TaskPoolSize> requires (ValidTaskPoolArgs<TaskPoolSize>)
-[[noreturn]] void TaskPool<TaskPoolSize>::doWork()
+// The slot belongs to the workers, while the task is ready or executed, so the task is used in place
+template <auto TaskPoolSize, auto NumWorkers, TaskPoolClock Clock> requires (ValidTaskPoolArgs<TaskPoolSize, NumWorkers>)
+void TaskPool<TaskPoolSize, NumWorkers, Clock>::executeTask(TaskId id)
 {
     using namespace std::chrono;
-    while (true)
+
+    const auto slot = static_cast<SlotIndexType>(slotOfTaskId(id));
+    auto &currentTaskToExecute = mTasks[slot]->second;
+
+    // Removed, while it was waiting in a deque, the resources of the task might be gone already.
+    // It is still finished, so its slot is freed.
+    if (isCurrentTask(slot, id))
     {
-        const auto nextExecutionAt = handleTaskExecutions();
-        const auto now = steady_clock::now();
-        if (now >= nextExecutionAt)
-        {
-            continue;
+        const auto startedAt = Clock::now();
+        const auto lateness = recordLateness(currentTaskToExecute, startedAt);
+
+        if (currentTaskToExecute.function) {
+            currentTaskToExecute.function();
+        } else if (currentTaskToExecute.func_ptr != nullptr) {
+            currentTaskToExecute.func_ptr(currentTaskToExecute.argument);
         }
 
-        const auto remainingWait = std::min(duration_cast<milliseconds>(nextExecutionAt - now), 5000ms);
+        recordMetrics(slot, currentTaskToExecute, lateness, Clock::now() - startedAt);
+    }
 
-        std::unique_lock waitLock{taskListMutex};
-        notify.wait_for(waitLock, remainingWait, []()
-        {
-            return !_tasks.empty() && std::any_of(_tasks.begin(), _tasks.end(), [](const auto& currentTaskPair)
-            {
-                const auto now = steady_clock::now();
-                return currentTaskPair.first != TaskId::invalid
-                    && calculateNextExecutionTime(currentTaskPair.second) < now;
-            });
-        });
+    const auto finishedAt = Clock::now();
+
+    if (currentTaskToExecute.priority != TaskPriority::control) {
+        --mLowerPriorityRuns;
     }
+
+    submit(Command{
+        .type = CommandType::finish,
+        .slot = slot,
+        .id = id,
+        .lastExecuted = finishedAt
+    });
 }
 
-template<typename IdType>
-requires (std::is_enum_v<IdType>)
-constexpr auto nextId(IdType currentId) {
-    return static_cast<IdType>(static_cast<std::underlying_type_t<IdType>>(currentId) + 1);
+template <auto TaskPoolSize, auto NumWorkers, TaskPoolClock Clock> requires (ValidTaskPoolArgs<TaskPoolSize, NumWorkers>)
+auto TaskPool<TaskPoolSize, NumWorkers, Clock>::recordLateness(const TaskDescription &task,
+                                                        std::chrono::steady_clock::time_point startedAt)
+    -> std::chrono::steady_clock::duration
+{
+    using namespace std::chrono;
+
+    auto &statistics = mPriorityStatistics[static_cast<size_t>(task.priority)];
+    const auto lateness = std::max(startedAt - calculateNextExecutionTime(task) - task.slack, steady_clock::duration::zero());
+    const auto latenessUs = static_cast<uint64_t>(duration_cast<microseconds>(lateness).count());
+
+    ++statistics.runs;
+    statistics.summedLatenessUs += latenessUs;
+
+    if (lateness > deadlineOf(task.priority))
+    {
+        ++statistics.deadlineMisses;
+    }
+
+    storeMaximum(statistics.maxLatenessUs, latenessUs);
+
+    return lateness;
 }
 
-// TODO: maybe use std::optional as return type
-template <auto TaskPoolSize> requires (ValidTaskPoolArgs<TaskPoolSize>)
-auto TaskPool<TaskPoolSize>::postTask(TaskDescription task) -> TaskResourceType {
-    TaskId createdId;
+// Only the worker executing the task writes to its counters
+template <auto TaskPoolSize, auto NumWorkers, TaskPoolClock Clock> requires (ValidTaskPoolArgs<TaskPoolSize, NumWorkers>)
+void TaskPool<TaskPoolSize, NumWorkers, Clock>::recordMetrics(SlotIndexType slot, const TaskDescription &task,
+                                                       std::chrono::steady_clock::duration lateness,
+                                                       std::chrono::steady_clock::duration executionTime)
+{
+    using namespace std::chrono;
+
+    auto &counters = mTaskCounters[slot];
+    const auto executionTimeUs = duration_cast<microseconds>(executionTime);
+    const auto latenessUs = static_cast<uint64_t>(duration_cast<microseconds>(lateness).count());
+
+    counters.lastExecutionUs = static_cast<uint64_t>(executionTimeUs.count());
+    counters.summedExecutionUs += static_cast<uint64_t>(executionTimeUs.count());
+    storeMaximum(counters.maxExecutionUs, static_cast<uint64_t>(executionTimeUs.count()));
+
+    counters.lastLatenessUs = latenessUs;
+    counters.summedLatenessUs += latenessUs;
+    storeMaximum(counters.maxLatenessUs, latenessUs);
+
+    ++counters.executionTimeHistogram[executionHistogramBucketOf(executionTimeUs)];
+
+    if (!task.single_shot && executionTime > task.interval)
+    {
+        ++counters.overruns;
+    }
+
+    // Incremented last, so a reader never sees a run without its times
+    ++counters.runs;
+}
+
+// Has to be called with mScheduleMutex held
+template <auto TaskPoolSize, auto NumWorkers, TaskPoolClock Clock> requires (ValidTaskPoolArgs<TaskPoolSize, NumWorkers>)
+void TaskPool<TaskPoolSize, NumWorkers, Clock>::recordDrift(SlotIndexType slot, std::chrono::steady_clock::duration drift,
+                                                            uint32_t skippedRuns)
+{
+    using namespace std::chrono;
+
+    auto &counters = mTaskCounters[slot];
+
+    counters.accumulatedDriftUs += static_cast<uint64_t>(duration_cast<microseconds>(drift).count());
+    counters.skippedRuns += skippedRuns;
+}
+
+// The slot isn't visible to readers yet, when this is called
+template <auto TaskPoolSize, auto NumWorkers, TaskPoolClock Clock> requires (ValidTaskPoolArgs<TaskPoolSize, NumWorkers>)
+void TaskPool<TaskPoolSize, NumWorkers, Clock>::resetMetrics(SlotIndexType slot, const TaskDescription &task)
+{
+    auto &counters = mTaskCounters[slot];
+
+    counters.description = task.description;
+    counters.priority = task.priority;
+    counters.runs = 0;
+    counters.overruns = 0;
+    counters.lastExecutionUs = 0;
+    counters.summedExecutionUs = 0;
+    counters.maxExecutionUs = 0;
+    counters.lastLatenessUs = 0;
+    counters.summedLatenessUs = 0;
+    counters.maxLatenessUs = 0;
+    counters.skippedRuns = 0;
+    counters.accumulatedDriftUs = 0;
+
+    for (auto &currentBucket : counters.executionTimeHistogram)
     {
-        std::unique_lock instance_guard{taskListMutex};
+        currentBucket = 0;
+    }
+}
+
+// Returns std::nullopt, if the slot is empty or was reused while reading
+template <auto TaskPoolSize, auto NumWorkers, TaskPoolClock Clock> requires (ValidTaskPoolArgs<TaskPoolSize, NumWorkers>)
+std::optional<TaskMetrics> TaskPool<TaskPoolSize, NumWorkers, Clock>::readMetrics(SlotIndexType slot) const
+{
+    using namespace std::chrono;
 
-        const auto addedTask = _tasks.append(std::make_pair(_next_id, task));
-        if (!addedTask) {
-            return TaskResourceType(task.argument, TaskId::invalid);
+    const auto id = mSlotIds[slot].load();
+
+    if (id == TaskId::invalid)
+    {
+        return std::nullopt;
+    }
+
+    const auto &counters = mTaskCounters[slot];
+    TaskMetrics metrics{
+        .id = id,
+        .description = counters.description,
+        .priority = counters.priority,
+        .runs = counters.runs,
+        .overruns = counters.overruns,
+        .lastExecutionTime = microseconds(counters.lastExecutionUs),
+        .maxExecutionTime = microseconds(counters.maxExecutionUs),
+        .lastLateness = microseconds(counters.lastLatenessUs),
+        .maxLateness = microseconds(counters.maxLatenessUs),
+        .skippedRuns = counters.skippedRuns,
+        .accumulatedDrift = microseconds(counters.accumulatedDriftUs)
+    };
+
+    if (metrics.runs > 0)
+    {
+        metrics.averageExecutionTime = microseconds(counters.summedExecutionUs / metrics.runs);
+        metrics.averageLateness = microseconds(counters.summedLatenessUs / metrics.runs);
+    }
+
+    for (size_t i = 0; i < taskExecutionHistogramSize; ++i)
+    {
+        metrics.executionTimeHistogram[i] = counters.executionTimeHistogram[i];
+    }
+
+    if (mSlotIds[slot] != id)
+    {
+        return std::nullopt;
+    }
+
+    return metrics;
+}
+
+template <auto TaskPoolSize, auto NumWorkers, TaskPoolClock Clock> requires (ValidTaskPoolArgs<TaskPoolSize, NumWorkers>)
+std::optional<TaskMetrics> TaskPool<TaskPoolSize, NumWorkers, Clock>::metricsOf(TaskId id) const
+{
+    const auto slot = slotOfTaskId(id);
+
+    if (id == TaskId::invalid || slot >= TaskPoolSize)
+    {
+        return std::nullopt;
+    }
+
+    if (auto metrics = readMetrics(static_cast<SlotIndexType>(slot)); metrics.has_value() && metrics->id == id)
+    {
+        return metrics;
+    }
+
+    return std::nullopt;
+}
+
+template <auto TaskPoolSize, auto NumWorkers, TaskPoolClock Clock> requires (ValidTaskPoolArgs<TaskPoolSize, NumWorkers>)
+template <typename Visitor>
+void TaskPool<TaskPoolSize, NumWorkers, Clock>::forEachTaskMetrics(Visitor &&visitor) const
+{
+    for (size_t slot = 0; slot < TaskPoolSize; ++slot)
+    {
+        if (const auto metrics = readMetrics(static_cast<SlotIndexType>(slot)); metrics.has_value() && !visitor(*metrics))
+        {
+            return;
         }
+    }
+}
 
-        // TODO: Maybe create method for that
-        createdId = _next_id;
-        _next_id = nextId(_next_id);
+template <auto TaskPoolSize, auto NumWorkers, TaskPoolClock Clock> requires (ValidTaskPoolArgs<TaskPoolSize, NumWorkers>)
+TaskLatenessStatistics TaskPool<TaskPoolSize, NumWorkers, Clock>::latenessOf(TaskPriority priority) const
+{
+    using namespace std::chrono;
 
-        Logger::log(LogLevel::Info, "Adding thread %s to pool", task.description);
+    const auto &statistics = mPriorityStatistics[static_cast<size_t>(priority)];
+    const auto runs = statistics.runs.load();
+
+    return TaskLatenessStatistics{
+        .runs = runs,
+        .deadlineMisses = statistics.deadlineMisses,
+        .averageLateness = microseconds(runs > 0 ? statistics.summedLatenessUs / runs : 0),
+        .maxLateness = microseconds(statistics.maxLatenessUs)
+    };
+}
+
+template <auto TaskPoolSize, auto NumWorkers, TaskPoolClock Clock> requires (ValidTaskPoolArgs<TaskPoolSize, NumWorkers>)
+void TaskPool<TaskPoolSize, NumWorkers, Clock>::submit(const Command &command)
+{
+    if (!mSubmissions.push(command))
+    {
+        // Can only happen with a lot of stale remove commands, apply it directly instead.
+        // The queued commands go first, a remove must not overtake the post of its task.
+        std::unique_lock scheduleGuard{mScheduleMutex};
+        drainSubmissions();
+        applyCommand(command);
+        return;
     }
 
-    notify.notify_one();
+    // New tasks might be due before the timekeeper wakes up, the others are applied by the worker,
+    // which submitted them, or at the next wakeup
+    if (command.type != CommandType::post)
+    {
+        return;
+    }
 
-    return TaskResourceType{task.argument, createdId};
+    if (const auto timekeeper = mTimekeeper.load(); timekeeper != noWorker)
+    {
+        wakeupWorker(timekeeper);
+    }
 }
 
-template <auto TaskPoolSize> requires (ValidTaskPoolArgs<TaskPoolSize>)
-void TaskPool<TaskPoolSize>::repostTask(const TaskInfo& task) {
+// Has to be called with mScheduleMutex held
+template <auto TaskPoolSize, auto NumWorkers, TaskPoolClock Clock> requires (ValidTaskPoolArgs<TaskPoolSize, NumWorkers>)
+void TaskPool<TaskPoolSize, NumWorkers, Clock>::drainSubmissions()
+{
+    while (const auto command = mSubmissions.pop())
     {
-        std::unique_lock instance_guard{taskListMutex};
+        applyCommand(*command);
+    }
+}
 
-        const auto addedTask = _tasks.append(task);
-        if (!addedTask) {
-            Logger::log(LogLevel::Error, "Failed to repost task %s", task.second.description);
+// Has to be called with mScheduleMutex held
+template <auto TaskPoolSize, auto NumWorkers, TaskPoolClock Clock> requires (ValidTaskPoolArgs<TaskPoolSize, NumWorkers>)
+void TaskPool<TaskPoolSize, NumWorkers, Clock>::applyCommand(const Command &command)
+{
+    const auto slot = command.slot;
+    auto &owner = mSlotOwners[slot];
+
+    switch (command.type)
+    {
+        case CommandType::post:
+            owner = SlotOwner{ .id = command.id };
+
+            // Removed, before it was scheduled for the first time, the remove command frees the slot
+            if (isCurrentTask(slot, command.id))
+            {
+                addToSchedule(slot, mTasks[slot]->second);
+            }
+            return;
+        case CommandType::finish:
+        {
+            auto &task = mTasks[slot];
+            owner.running = false;
+
+            if (!isCurrentTask(slot, command.id) || task->second.single_shot)
+            {
+                auto finishedId = command.id;
+                mSlotIds[slot].compare_exchange_strong(finishedId, TaskId::invalid);
+                releaseSlot(slot);
+                return;
+            }
+
+            {
+                const auto deadline = calculateNextExecutionTime(task->second);
+                const auto reference = calculateNextExecutionReference(task->second, deadline, command.lastExecuted);
+
+                recordDrift(slot, reference.lastExecuted - deadline - reference.skippedRuns * task->second.interval,
+                            reference.skippedRuns);
+                task->second.last_executed = reference.lastExecuted;
+            }
+            addToSchedule(slot, task->second);
             return;
         }
+        case CommandType::remove:
+            // Ready or running tasks are released, once they are finished, the slot of a finished
+            // single shot task might be reused already
+            if (owner.id != command.id || owner.running)
+            {
+                return;
+            }
 
-        Logger::log(LogLevel::Info, "Reposted task %s to pool", task.second.description);
+            (void) removeFromSchedule(slot, mTasks[slot]->second.priority);
+            releaseSlot(slot);
+            return;
     }
+}
+
+// Has to be called with mScheduleMutex held
+template <auto TaskPoolSize, auto NumWorkers, TaskPoolClock Clock> requires (ValidTaskPoolArgs<TaskPoolSize, NumWorkers>)
+void TaskPool<TaskPoolSize, NumWorkers, Clock>::addToSchedule(SlotIndexType slot, const TaskDescription &task)
+{
+    const auto executeAt = calculateNextExecutionTime(task);
 
-    notify.notify_one();
+    (void) scheduleOf(task.priority).push(slot, executeAt);
+    (void) mLatestStarts.push(slot, executeAt + std::max(task.slack, std::chrono::milliseconds::zero()));
 }
 
-template <auto TaskPoolSize> requires (ValidTaskPoolArgs<TaskPoolSize>)
-bool TaskPool<TaskPoolSize>::removeTask(TaskId& id) {
-    if (id == TaskId::invalid) {
-        return false;
+// Has to be called with mScheduleMutex held
+template <auto TaskPoolSize, auto NumWorkers, TaskPoolClock Clock> requires (ValidTaskPoolArgs<TaskPoolSize, NumWorkers>)
+bool TaskPool<TaskPoolSize, NumWorkers, Clock>::removeFromSchedule(SlotIndexType slot, TaskPriority priority)
+{
+    (void) mLatestStarts.remove(slot);
+    return scheduleOf(priority).remove(slot);
+}
+
+// Is called with mScheduleMutex held, the worker mutex is always locked after it
+template <auto TaskPoolSize, auto NumWorkers, TaskPoolClock Clock> requires (ValidTaskPoolArgs<TaskPoolSize, NumWorkers>)
+void TaskPool<TaskPoolSize, NumWorkers, Clock>::handTaskToWorker(size_t workerIndex, TaskId id)
+{
+    auto &worker = mWorkers[workerIndex];
+    {
+        std::unique_lock workerGuard{worker.workerMutex};
+        worker.readyTasks.append(id);
+        worker.wakeupPending = true;
     }
 
+    worker.wakeup.notify_one();
+}
+
+template <auto TaskPoolSize, auto NumWorkers, TaskPoolClock Clock> requires (ValidTaskPoolArgs<TaskPoolSize, NumWorkers>)
+void TaskPool<TaskPoolSize, NumWorkers, Clock>::wakeupWorker(size_t workerIndex)
+{
+    auto &worker = mWorkers[workerIndex];
     {
-        std::unique_lock instance_guard{taskListMutex};
+        std::unique_lock workerGuard{worker.workerMutex};
+        worker.wakeupPending = true;
+    }
 
-        const auto found = _tasks.modifyOrRemove([id](const auto &currentTaskPair) {
-            Logger::log(LogLevel::Info, "Removed task %s from pool", currentTaskPair.second.description);
-            return currentTaskPair.first == id;
-        });
+    worker.wakeup.notify_one();
+}
+
+template <auto TaskPoolSize, auto NumWorkers, TaskPoolClock Clock> requires (ValidTaskPoolArgs<TaskPoolSize, NumWorkers>)
+std::optional<size_t> TaskPool<TaskPoolSize, NumWorkers, Clock>::findIdleWorker(size_t excludedWorker)
+{
+    const size_t start = mNextHandoff.fetch_add(1) % NumWorkers;
+
+    for (size_t i = 0; i < NumWorkers; ++i)
+    {
+        const auto candidate = (start + i) % NumWorkers;
 
-        if (found)
+        if (candidate != excludedWorker && mWorkers[candidate].idle)
         {
-            id = TaskId::invalid;
+            return candidate;
         }
+    }
+
+    return std::nullopt;
+}
+
+// Picks an idle worker in round-robin order, if there is none the task is queued on the calling worker,
+// where it can be stolen from, once another worker is done
+template <auto TaskPoolSize, auto NumWorkers, TaskPoolClock Clock> requires (ValidTaskPoolArgs<TaskPoolSize, NumWorkers>)
+size_t TaskPool<TaskPoolSize, NumWorkers, Clock>::nextWorkerFor(size_t dispatchingWorker)
+{
+    return findIdleWorker(dispatchingWorker).value_or(dispatchingWorker);
+}
+
+// A worker, which is about to execute a task, can't keep track of the next deadline,
+// so an idle worker has to take over
+template <auto TaskPoolSize, auto NumWorkers, TaskPoolClock Clock> requires (ValidTaskPoolArgs<TaskPoolSize, NumWorkers>)
+void TaskPool<TaskPoolSize, NumWorkers, Clock>::handOverTimekeeping(size_t workerIndex)
+{
+    size_t expectedTimekeeper = workerIndex;
+    mTimekeeper.compare_exchange_strong(expectedTimekeeper, noWorker);
+
+    if (mTimekeeper != noWorker)
+    {
+        return;
+    }
+
+    if (const auto idleWorker = findIdleWorker(workerIndex); idleWorker.has_value())
+    {
+        wakeupWorker(*idleWorker);
+    }
+}
+
+// TODO: maybe use std::optional as return type
+template <auto TaskPoolSize, auto NumWorkers, TaskPoolClock Clock> requires (ValidTaskPoolArgs<TaskPoolSize, NumWorkers>)
+auto TaskPool<TaskPoolSize, NumWorkers, Clock>::postTask(TaskDescription task) -> TaskResourceType {
+    auto slot = mFreeSlots.pop();
+
+    // Removed tasks only free their slot, once a worker applied the removal
+    if (!slot && mScheduleMutex.try_lock()) {
+        drainSubmissions();
+        mScheduleMutex.unlock();
+        slot = mFreeSlots.pop();
+    }
 
-        return found;
+    if (!slot) {
+        Logger::log(LogLevel::Warning, "No free slot for task %s", task.description);
+        return TaskResourceType(this, task.argument, TaskId::invalid);
     }
-}
\ No newline at end of file
+
+    if (!task.last_executed.has_value()) {
+        task.last_executed = Clock::now() - task.interval;
+    }
+
+    const auto createdId = makeTaskId(mNextGeneration++, *slot);
+    const auto argument = task.argument;
+    const auto description = task.description;
+
+    resetMetrics(*slot, task);
+    mTasks.insert(*slot, std::make_pair(createdId, std::move(task)));
+    mSlotIds[*slot] = createdId;
+
+    submit(Command{ .type = CommandType::post, .slot = *slot, .id = createdId });
+
+    LOG_IF_ENABLED(LogLevel::Info, "Adding thread %s to pool", description);
+
+    return TaskResourceType{this, argument, createdId};
+}
+
+template <auto TaskPoolSize, auto NumWorkers, TaskPoolClock Clock> requires (ValidTaskPoolArgs<TaskPoolSize, NumWorkers>)
+bool TaskPool<TaskPoolSize, NumWorkers, Clock>::removeTask(TaskId& id) {
+    const auto slot = slotOfTaskId(id);
+
+    if (id == TaskId::invalid || slot >= TaskPoolSize) {
+        return false;
+    }
+
+    auto removedId = id;
+    if (!mSlotIds[slot].compare_exchange_strong(removedId, TaskId::invalid)) {
+        return false;
+    }
+
+    // The worker, which applies this, frees the slot, if the task is pending. Otherwise it is freed,
+    // once the running task is finished.
+    submit(Command{ .type = CommandType::remove, .slot = static_cast<SlotIndexType>(slot), .id = id });
+
+    id = TaskId::invalid;
+    return true;
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+/**
+ * \brief A clock, which only moves, when it is advanced or when somebody waits on it.
+ *
+ * Waiting on the clock doesn't take any real time, the clock jumps to the deadline instead.
+ * This replays long schedules on the host in a fraction of the time, as long as only one thread waits on it,
+ * e.g. a TaskPool with a single worker. The time points are steady_clock time points, so the clock can be used
+ * with code, which stores steady_clock time points.
+ */
+class VirtualClock final {
+public:
+    using duration = std::chrono::steady_clock::duration;
+    using rep = duration::rep;
+    using period = duration::period;
+    using time_point = std::chrono::steady_clock::time_point;
+
+    static constexpr bool is_steady = true;
+
+    static time_point now() noexcept {
+        return time_point(duration(sNow.load()));
+    }
+
+    static void advance(duration by) {
+        sNow += by.count();
+    }
+
+    // The clock never goes backwards
+    static void advanceTo(time_point to) {
+        auto current = sNow.load();
+        while (current < to.time_since_epoch().count()
+               && !sNow.compare_exchange_weak(current, to.time_since_epoch().count())) { }
+    }
+
+    static void reset(time_point to = time_point{}) {
+        sNow = to.time_since_epoch().count();
+    }
+
+    template<typename Predicate>
+    static bool waitUntil(std::condition_variable &, std::unique_lock<std::mutex> &, time_point deadline,
+                          Predicate predicate) {
+        if (predicate()) {
+            return true;
+        }
+
+        advanceTo(deadline);
+        return predicate();
+    }
+
+private:
+    static inline std::atomic<rep> sNow = 0;
+};
@@ -0,0 +1,300 @@
+#include <gtest/gtest.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "utils/batching_log_sink.h"
+#include "utils/time/virtual_clock.h"
+
+namespace {
+    using namespace std::chrono_literals;
+
+    bool writeAll(int socketFd, const std::string &data) {
+        size_t written = 0;
+        while (written < data.size()) {
+            const auto result = ::send(socketFd, data.data() + written, data.size() - written, MSG_NOSIGNAL);
+            if (result <= 0) {
+                return false;
+            }
+            written += static_cast<size_t>(result);
+        }
+        return true;
+    }
+
+    // Reads until the end of the headers and then the body, if there is a Content-Length
+    bool readMessage(int socketFd, std::string &buffer, std::string &headers, std::string &body) {
+        std::array<char, 512> chunk{};
+
+        while (buffer.find("\r\n\r\n") == std::string::npos) {
+            const auto received = ::recv(socketFd, chunk.data(), chunk.size(), 0);
+            if (received <= 0) {
+                return false;
+            }
+            buffer.append(chunk.data(), static_cast<size_t>(received));
+        }
+
+        const auto headerEnd = buffer.find("\r\n\r\n") + 4;
+        headers = buffer.substr(0, headerEnd);
+
+        size_t contentLength = 0;
+        if (const auto lengthAt = headers.find("Content-Length: "); lengthAt != std::string::npos) {
+            contentLength = std::stoul(headers.substr(lengthAt + 16));
+        }
+
+        while (buffer.size() < headerEnd + contentLength) {
+            const auto received = ::recv(socketFd, chunk.data(), chunk.size(), 0);
+            if (received <= 0) {
+                return false;
+            }
+            buffer.append(chunk.data(), static_cast<size_t>(received));
+        }
+
+        body = buffer.substr(headerEnd, contentLength);
+        buffer.erase(0, headerEnd + contentLength);
+        return true;
+    }
+
+    // Stands in for the remote log host, keeps the connections alive and answers every request with statusCode
+    class LocalLogServer {
+    public:
+        LocalLogServer() {
+            mListenFd = ::socket(AF_INET, SOCK_STREAM, 0);
+
+            sockaddr_in address{};
+            address.sin_family = AF_INET;
+            address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            address.sin_port = 0;
+
+            ::bind(mListenFd, reinterpret_cast<sockaddr *>(&address), sizeof(address));
+            ::listen(mListenFd, 4);
+
+            socklen_t length = sizeof(address);
+            ::getsockname(mListenFd, reinterpret_cast<sockaddr *>(&address), &length);
+            mPort = ntohs(address.sin_port);
+
+            mAcceptThread = std::thread([this]() { acceptConnections(); });
+        }
+
+        ~LocalLogServer() {
+            ::shutdown(mListenFd, SHUT_RDWR);
+            ::close(mListenFd);
+            mAcceptThread.join();
+
+            for (auto &currentThread : mConnectionThreads) {
+                currentThread.join();
+            }
+        }
+
+        [[nodiscard]] uint16_t port() const { return mPort; }
+        [[nodiscard]] int acceptedConnections() const { return mAcceptedConnections; }
+
+        std::vector<std::string> bodies() {
+            std::unique_lock guard{mMutex};
+            return mBodies;
+        }
+
+        std::atomic_int statusCode = 200;
+
+    private:
+        void acceptConnections() {
+            while (true) {
+                const int connectionFd = ::accept(mListenFd, nullptr, nullptr);
+                if (connectionFd < 0) {
+                    return;
+                }
+
+                ++mAcceptedConnections;
+                mConnectionThreads.emplace_back([this, connectionFd]() { serve(connectionFd); });
+            }
+        }
+
+        void serve(int connectionFd) {
+            std::string buffer;
+            std::string headers;
+            std::string body;
+
+            while (readMessage(connectionFd, buffer, headers, body)) {
+                {
+                    std::unique_lock guard{mMutex};
+                    mBodies.push_back(body);
+                }
+
+                const auto response = "HTTP/1.1 " + std::to_string(statusCode.load())
+                    + " Status\r\nContent-Length: 0\r\nConnection: keep-alive\r\n\r\n";
+                if (!writeAll(connectionFd, response)) {
+                    break;
+                }
+            }
+
+            ::close(connectionFd);
+        }
+
+        int mListenFd = -1;
+        uint16_t mPort = 0;
+        std::atomic_int mAcceptedConnections = 0;
+        std::thread mAcceptThread;
+        std::vector<std::thread> mConnectionThreads;
+        std::mutex mMutex;
+        std::vector<std::string> mBodies;
+    };
+
+    // Does, what the HttpLogTransport does on the device, with plain sockets
+    class SocketTransport {
+    public:
+        ~SocketTransport() {
+            disconnect();
+        }
+
+        bool send(const char *data, size_t length) {
+            if (mSocketFd < 0 && !connect()) {
+                return false;
+            }
+
+            const std::string request = "POST /log HTTP/1.1\r\nHost: localhost\r\nContent-Type: application/json\r\n"
+                "Content-Length: " + std::to_string(length) + "\r\nConnection: keep-alive\r\n\r\n"
+                + std::string(data, length);
+
+            std::string headers;
+            std::string body;
+            if (!writeAll(mSocketFd, request) || !readMessage(mSocketFd, mBuffer, headers, body)) {
+                disconnect();
+                return false;
+            }
+
+            const auto statusCode = std::stoi(headers.substr(headers.find(' ') + 1));
+            return statusCode >= 200 && statusCode < 300;
+        }
+
+        void disconnect() {
+            if (mSocketFd >= 0) {
+                ::close(mSocketFd);
+                mSocketFd = -1;
+            }
+            mBuffer.clear();
+        }
+
+        const char *deviceId() { return "test-device"; }
+
+        uint16_t port = 0;
+
+    private:
+        bool connect() {
+            mSocketFd = ::socket(AF_INET, SOCK_STREAM, 0);
+
+            sockaddr_in address{};
+            address.sin_family = AF_INET;
+            address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            address.sin_port = htons(port);
+
+            if (::connect(mSocketFd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0) {
+                disconnect();
+                return false;
+            }
+            return true;
+        }
+
+        int mSocketFd = -1;
+        std::string mBuffer;
+    };
+
+    // Fails, as long as available is false
+    struct ScriptedTransport {
+        bool send(const char *data, size_t length) {
+            ++attempts;
+            if (available) {
+                batches.emplace_back(data, length);
+            }
+            return available;
+        }
+
+        void disconnect() { }
+        const char *deviceId() { return "dev"; }
+
+        bool available = true;
+        int attempts = 0;
+        std::vector<std::string> batches;
+    };
+}
+
+TEST(BatchingLogSink, SendsBatchesOverOneConnection) {
+    LocalLogServer server;
+    BatchingLogSink<SocketTransport, 256, VirtualClock> sink;
+    sink.transport().port = server.port();
+    VirtualClock::reset();
+
+    EXPECT_TRUE(sink.log(LogLevel::Info, "Pump %d started", 1));
+    EXPECT_TRUE(sink.log(LogLevel::Warning, "Said \"hi\"\n"));
+    EXPECT_EQ(sink.pendingRecords(), 2u);
+    EXPECT_TRUE(server.bodies().empty());
+
+    VirtualClock::advance(decltype(sink)::flushInterval);
+    sink.poll();
+    EXPECT_EQ(sink.pendingRecords(), 0u);
+
+    // Filling the batch to the threshold sends it right away
+    while (sink.statistics().sentBatches < 2) {
+        ASSERT_TRUE(sink.log(LogLevel::Debug, "Filling the batch"));
+    }
+
+    const auto bodies = server.bodies();
+    ASSERT_EQ(bodies.size(), 2u);
+    EXPECT_EQ(bodies[0], R"([{"device_id":"test-device","level":"info","msg":"Pump 1 started"},)"
+                         R"({"device_id":"test-device","level":"warn","msg":"Said \"hi\"\n"}])");
+    EXPECT_EQ(bodies[1].front(), '[');
+    EXPECT_EQ(bodies[1].back(), ']');
+    EXPECT_EQ(server.acceptedConnections(), 1);
+}
+
+TEST(BatchingLogSink, BacksOffWhileTheHostIsUnavailable) {
+    BatchingLogSink<ScriptedTransport, 256, VirtualClock> sink;
+    using SinkType = decltype(sink);
+    VirtualClock::reset();
+
+    sink.transport().available = false;
+    EXPECT_TRUE(sink.log(LogLevel::Error, "Lost"));
+    EXPECT_FALSE(sink.flush());
+    EXPECT_EQ(sink.transport().attempts, 1);
+
+    // No attempt, until the backoff passed, then the backoff doubles
+    VirtualClock::advance(SinkType::minBackoff / 2);
+    EXPECT_FALSE(sink.flush());
+    EXPECT_EQ(sink.transport().attempts, 1);
+
+    VirtualClock::advance(SinkType::minBackoff / 2);
+    EXPECT_FALSE(sink.flush());
+    EXPECT_EQ(sink.transport().attempts, 2);
+
+    VirtualClock::advance(SinkType::minBackoff);
+    EXPECT_FALSE(sink.flush());
+    EXPECT_EQ(sink.transport().attempts, 2);
+
+    // The kept records are sent, once the host is back
+    sink.transport().available = true;
+    VirtualClock::advance(SinkType::minBackoff);
+    EXPECT_TRUE(sink.flush());
+    ASSERT_EQ(sink.transport().batches.size(), 1u);
+    EXPECT_EQ(sink.transport().batches[0], R"([{"device_id":"dev","level":"error","msg":"Lost"}])");
+    EXPECT_EQ(sink.statistics().failedBatches, 2u);
+}
+
+TEST(BatchingLogSink, DropsRecordsWhichDontFitWhileBackedOff) {
+    BatchingLogSink<ScriptedTransport, 128, VirtualClock> sink;
+    VirtualClock::reset();
+
+    sink.transport().available = false;
+    for (int i = 0; i < 10; ++i) {
+        (void) sink.log(LogLevel::Info, "Record %d", i);
+    }
+
+    EXPECT_GT(sink.statistics().droppedRecords, 0u);
+    EXPECT_EQ(sink.pendingRecords() + sink.statistics().droppedRecords, 10u);
+}
@@ -0,0 +1,36 @@
+#include <cstdio>
+#include <cstring>
+
+void runTimerQueueBenchmark();
+void runTaskPoolBenchmark();
+void runLoggerBenchmark();
+void runSampleFilterBenchmark();
+
+struct Benchmark {
+    const char *name;
+    void (*run)();
+};
+
+static constexpr Benchmark benchmarks[] = {
+    {"timer_queue", runTimerQueueBenchmark},
+    {"task_pool", runTaskPoolBenchmark},
+    {"logger", runLoggerBenchmark},
+    {"sample_filter", runSampleFilterBenchmark},
+};
+
+// Runs all benchmarks or only the ones given as arguments
+int main(int argc, char **argv) {
+    for (const auto &currentBenchmark : benchmarks) {
+        bool selected = argc <= 1;
+
+        for (int i = 1; i < argc; ++i) {
+            selected |= std::strcmp(argv[i], currentBenchmark.name) == 0;
+        }
+
+        if (selected) {
+            currentBenchmark.run();
+        }
+    }
+
+    return 0;
+}
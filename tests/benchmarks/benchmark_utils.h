@@ -0,0 +1,17 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+
+template<typename Callable>
+double measureNanosecondsPerIteration(size_t iterations, Callable &&callable) {
+    using namespace std::chrono;
+
+    const auto start = steady_clock::now();
+    for (size_t i = 0; i < iterations; ++i) {
+        callable();
+    }
+    const auto end = steady_clock::now();
+
+    return static_cast<double>(duration_cast<nanoseconds>(end - start).count()) / static_cast<double>(iterations);
+}
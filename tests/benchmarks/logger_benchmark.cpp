@@ -0,0 +1,110 @@
+#include <chrono>
+#include <cstdio>
+
+#include "utils/logger.h"
+
+#include "benchmark_utils.h"
+
+// Compares the cost of a log call, which is removed at compile time or filtered at runtime,
+// with calls, which are written synchronously or queued for the drain task,
+// and with calls of a call site, which is rate limited
+namespace {
+    template<int Tag>
+    class CountingSink final {
+        public:
+            bool install() { return true; }
+            bool uninstall() { return true; }
+
+            template<typename ... Arguments>
+            bool log(LogLevel level, const char *fmt, Arguments && ... args) {
+                ++written;
+                return true;
+            }
+
+            static inline size_t written = 0;
+    };
+
+    using CompiledOutLogger = ApplicationLogger<QuietBackend, LogLevel::Info, CountingSink<0>>;
+    using FilteredLogger = ApplicationLogger<QuietBackend, LogLevel::Debug, CountingSink<1>>;
+    using SynchronousLogger = ApplicationLogger<QuietBackend, LogLevel::Debug, CountingSink<2>>;
+    using AsyncLogger = ApplicationLogger<QuietBackend, LogLevel::Debug, CountingSink<3>>;
+    using BinaryLogger = ApplicationLogger<QuietBackend, LogLevel::Debug, CountingSink<4>>;
+    using RepeatedLogger = ApplicationLogger<QuietBackend, LogLevel::Debug, CountingSink<5>>;
+    using RateLimitedLogger = ApplicationLogger<QuietBackend, LogLevel::Debug, CountingSink<6>>;
+
+    constexpr size_t iterations = 2'000'000;
+
+    // Only the calls are measured, the queue is drained in between, like the drain task would do it
+    template<typename LoggerType>
+    double nanosecondsPerQueuedCall(LogEncoding encoding, unsigned int &value) {
+        using namespace std::chrono;
+
+        const double temperature = 24.5;
+        const size_t rounds = iterations / asyncLogQueueSize;
+        steady_clock::duration measured{0};
+
+        LoggerType::enableAsync(LogOverflowPolicy::dropNew, encoding);
+
+        for (size_t round = 0; round < rounds; ++round) {
+            const auto start = steady_clock::now();
+            for (size_t i = 0; i < asyncLogQueueSize; ++i) {
+                (void) LoggerType::log(LogLevel::Debug, "Sensor %u read %.2f degrees", ++value, temperature);
+            }
+            measured += steady_clock::now() - start;
+
+            (void) LoggerType::drain();
+        }
+
+        return static_cast<double>(duration_cast<nanoseconds>(measured).count())
+            / static_cast<double>(rounds * asyncLogQueueSize);
+    }
+}
+
+void runLoggerBenchmark() {
+    std::printf("=== Logger: cost per Logger::log call ===\n");
+
+    unsigned int value = 0;
+
+    std::printf("compiled out       %8.2f ns/call\n", measureNanosecondsPerIteration(iterations, [&value]() {
+        (void) CompiledOutLogger::log(LogLevel::Debug, "Value %u", ++value);
+    }));
+
+    FilteredLogger::ignoreLogsBelow(LogLevel::Info);
+    std::printf("filtered (runtime) %8.2f ns/call\n", measureNanosecondsPerIteration(iterations, [&value]() {
+        (void) FilteredLogger::log(LogLevel::Debug, "Value %u", ++value);
+    }));
+
+    std::printf("synchronous        %8.2f ns/call\n", measureNanosecondsPerIteration(iterations, [&value]() {
+        (void) SynchronousLogger::log(LogLevel::Debug, "Value %u", ++value);
+    }));
+
+    AsyncLogger::enableAsync(LogOverflowPolicy::dropOldest);
+    std::printf("async incl. drain  %8.2f ns/call\n", measureNanosecondsPerIteration(iterations, [&value]() {
+        (void) AsyncLogger::log(LogLevel::Debug, "Value %u", ++value);
+
+        if (value % asyncLogQueueSize == 0) {
+            (void) AsyncLogger::drain();
+        }
+    }));
+
+    std::printf("async text, call   %8.2f ns/call\n",
+                nanosecondsPerQueuedCall<AsyncLogger>(LogEncoding::text, value));
+    std::printf("async binary, call %8.2f ns/call\n",
+                nanosecondsPerQueuedCall<BinaryLogger>(LogEncoding::binary, value));
+
+    // A failing sensor, which logs the same warning over and over
+    RepeatedLogger::enableRateLimit();
+    std::printf("repeated record    %8.2f ns/call\n", measureNanosecondsPerIteration(iterations, []() {
+        (void) RepeatedLogger::log(LogLevel::Warning, "Couldn't read sensor %d", 3);
+    }));
+
+    RateLimitedLogger::enableRateLimit();
+    std::printf("rate limited       %8.2f ns/call\n", measureNanosecondsPerIteration(iterations, [&value]() {
+        (void) RateLimitedLogger::log(LogLevel::Warning, "Sensor read %u", ++value);
+    }));
+
+    std::printf("written records: compiled out %zu, filtered %zu, synchronous %zu, async %zu, binary %zu, "
+                "repeated %zu, rate limited %zu\n",
+                CountingSink<0>::written, CountingSink<1>::written, CountingSink<2>::written, CountingSink<3>::written,
+                CountingSink<4>::written, CountingSink<5>::written, CountingSink<6>::written);
+}
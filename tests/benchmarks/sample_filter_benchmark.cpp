@@ -0,0 +1,78 @@
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <memory>
+#include <random>
+
+#include "utils/container/ring_buffer.h"
+#include "utils/container/sample_filter.h"
+
+#include "benchmark_utils.h"
+
+// Compares the median of a sorted copy of the window, which is what a filter without
+// an order statistics structure would do, with the filters, which keep the window ordered.
+namespace {
+    template<size_t WindowSize>
+    struct SortingMedianFilter {
+        float filter(float value) {
+            window.append(value);
+
+            window.copyOut(sorted);
+            std::sort(sorted.begin(), sorted.begin() + window.size());
+
+            return sorted[window.size() / 2];
+        }
+
+        RingBuffer<float, WindowSize> window;
+        std::array<float, WindowSize> sorted{};
+    };
+
+    template<typename FilterType>
+    double nanosecondsPerSample(FilterType &filter, size_t samples) {
+        std::mt19937 generator(42);
+        std::normal_distribution<float> noise(7.0f, 0.05f);
+        volatile float sink = 0.0f;
+
+        return measureNanosecondsPerIteration(samples, [&]() {
+            const auto result = filter.filter(noise(generator));
+            sink = static_cast<float>(result.value_or(0.0f));
+        });
+    }
+
+    template<size_t WindowSize>
+    double nanosecondsPerSortedSample(size_t samples) {
+        auto filter = std::make_unique<SortingMedianFilter<WindowSize>>();
+        std::mt19937 generator(42);
+        std::normal_distribution<float> noise(7.0f, 0.05f);
+        volatile float sink = 0.0f;
+
+        return measureNanosecondsPerIteration(samples, [&]() {
+            sink = filter->filter(noise(generator));
+        });
+    }
+
+    template<size_t WindowSize>
+    double nanosecondsPerFilteredSample(SampleFilterKind kind, size_t samples) {
+        auto filter = std::make_unique<SampleFilter<float, WindowSize>>(SampleFilterSettings{ .kind = kind });
+        return nanosecondsPerSample(*filter, samples);
+    }
+
+    template<size_t WindowSize>
+    void compareFilters() {
+        const size_t samples = std::max<size_t>(2000, 4'000'000 / WindowSize);
+        std::printf("%6zu samples : sorted median %9.1f ns, median %7.1f ns, hampel %7.1f ns, trimmed mean %7.1f ns\n",
+                    WindowSize,
+                    nanosecondsPerSortedSample<WindowSize>(samples),
+                    nanosecondsPerFilteredSample<WindowSize>(SampleFilterKind::median, samples * 4),
+                    nanosecondsPerFilteredSample<WindowSize>(SampleFilterKind::hampel, samples * 4),
+                    nanosecondsPerFilteredSample<WindowSize>(SampleFilterKind::trimmedMean, samples * 4));
+    }
+}
+
+void runSampleFilterBenchmark() {
+    std::printf("=== Sample filter: filter one sample of a full window ===\n");
+    compareFilters<10>();
+    compareFilters<64>();
+    compareFilters<256>();
+    compareFilters<1024>();
+}
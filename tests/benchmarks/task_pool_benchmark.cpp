@@ -0,0 +1,202 @@
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "utils/logger.h"
+
+#include "benchmark_utils.h"
+
+using Logger = ApplicationLogger<QuietBackend, LogLevel::Debug, VoidSink>;
+
+#include "utils/task_pool.h"
+#include "utils/time/virtual_clock.h"
+
+// Measures how many short tasks the pool gets through and how late a single task is started,
+// depending on the number of workers
+namespace {
+    using namespace std::chrono;
+
+    constexpr size_t numThroughputTasks = 5000;
+    constexpr size_t numLatencySamples = 200;
+
+    template<size_t NumWorkers>
+    class BenchmarkPool {
+    public:
+        using PoolType = TaskPool<1024u, NumWorkers>;
+
+        BenchmarkPool() : pool(std::make_unique<PoolType>()) {
+            for (size_t i = 0; i < NumWorkers; ++i) {
+                threads.emplace_back([this, i]() { pool->doWork(i); });
+            }
+        }
+
+        ~BenchmarkPool() {
+            pool->requestStop();
+            for (auto &currentThread : threads) {
+                currentThread.join();
+            }
+        }
+
+        std::unique_ptr<PoolType> pool;
+        std::vector<std::thread> threads;
+    };
+
+    struct ThroughputState {
+        std::atomic<size_t> executed = 0;
+    };
+
+    void shortTask(void *argument) {
+        // Simulates a blocking bus transaction, e.g. reading a sensor
+        std::this_thread::sleep_for(microseconds(200));
+
+        ++static_cast<ThroughputState *>(argument)->executed;
+    }
+
+    struct LatencyState {
+        steady_clock::time_point dueAt;
+        std::atomic<int64_t> lateness = -1;
+    };
+
+    void latencyTask(void *argument) {
+        auto *state = static_cast<LatencyState *>(argument);
+        state->lateness = duration_cast<nanoseconds>(steady_clock::now() - state->dueAt).count();
+    }
+
+    template<size_t NumWorkers>
+    void measureThroughput() {
+        BenchmarkPool<NumWorkers> benchmarkPool;
+        ThroughputState state;
+        std::vector<typename BenchmarkPool<NumWorkers>::PoolType::TaskResourceType> resources;
+        resources.reserve(numThroughputTasks);
+
+        const auto start = steady_clock::now();
+        for (size_t i = 0; i < numThroughputTasks; ++i) {
+            auto resource = benchmarkPool.pool->postTask(TaskDescription{
+                .single_shot = true,
+                .func_ptr = shortTask,
+                .interval = milliseconds(0),
+                .argument = &state,
+                .description = "Throughput task",
+                .last_executed = steady_clock::now()
+            });
+
+            // The pool is full, wait for the workers to catch up
+            while (!resource.isActive()) {
+                std::this_thread::yield();
+                resource = benchmarkPool.pool->postTask(TaskDescription{
+                    .single_shot = true,
+                    .func_ptr = shortTask,
+                    .interval = milliseconds(0),
+                    .argument = &state,
+                    .description = "Throughput task",
+                    .last_executed = steady_clock::now()
+                });
+            }
+
+            resources.emplace_back(std::move(resource));
+        }
+
+        while (state.executed < numThroughputTasks) {
+            std::this_thread::yield();
+        }
+        const auto elapsed = duration_cast<duration<double>>(steady_clock::now() - start);
+
+        std::printf("%2zu workers : %10.0f tasks/s", NumWorkers, numThroughputTasks / elapsed.count());
+    }
+
+    template<size_t NumWorkers>
+    void measureWakeupLatency() {
+        BenchmarkPool<NumWorkers> benchmarkPool;
+        int64_t summedLateness = 0;
+        int64_t maxLateness = 0;
+
+        for (size_t i = 0; i < numLatencySamples; ++i) {
+            LatencyState state;
+            const auto now = steady_clock::now();
+            state.dueAt = now + milliseconds(1);
+
+            auto resource = benchmarkPool.pool->postTask(TaskDescription{
+                .single_shot = true,
+                .func_ptr = latencyTask,
+                .interval = milliseconds(1),
+                .argument = &state,
+                .description = "Latency task",
+                .last_executed = now
+            });
+
+            while (state.lateness < 0) {
+                std::this_thread::yield();
+            }
+
+            summedLateness += state.lateness;
+            maxLateness = std::max<int64_t>(maxLateness, state.lateness);
+        }
+
+        std::printf(", wakeup latency avg %8.1f us, max %8.1f us\n",
+                    summedLateness / 1000.0 / numLatencySamples, maxLateness / 1000.0);
+    }
+
+    void countTask(void *argument) {
+        ++static_cast<ThroughputState *>(argument)->executed;
+    }
+
+    void stopPool(void *pool) {
+        static_cast<TaskPool<64u, 1u, VirtualClock> *>(pool)->requestStop();
+    }
+
+    // Replays a week of periodic tasks in virtual time, this only measures the scheduling path
+    void measureSimulatedWeek() {
+        using PoolType = TaskPool<64u, 1u, VirtualClock>;
+
+        VirtualClock::reset();
+        auto pool = std::make_unique<PoolType>();
+        ThroughputState state;
+        std::vector<PoolType::TaskResourceType> resources;
+
+        for (size_t i = 0; i < 32; ++i) {
+            resources.emplace_back(pool->postTask(TaskDescription{
+                .single_shot = false,
+                .func_ptr = countTask,
+                .interval = seconds(1 + i % 8),
+                .argument = &state,
+                .description = "Simulated task",
+                .last_executed = VirtualClock::now(),
+                .priority = static_cast<TaskPriority>(i % numTaskPriorities)
+            }));
+        }
+        resources.emplace_back(pool->postTask(TaskDescription{
+            .single_shot = true,
+            .func_ptr = stopPool,
+            .interval = days(7),
+            .argument = pool.get(),
+            .description = "Stop",
+            .last_executed = VirtualClock::now(),
+            .priority = TaskPriority::control
+        }));
+
+        const auto start = steady_clock::now();
+        pool->doWork(0);
+        const auto elapsed = duration_cast<duration<double>>(steady_clock::now() - start);
+
+        std::printf("simulated week : %zu tasks in %.2f s, %10.0f tasks/s\n",
+                    state.executed.load(), elapsed.count(), state.executed / elapsed.count());
+    }
+
+    template<size_t NumWorkers>
+    void measurePool() {
+        measureThroughput<NumWorkers>();
+        measureWakeupLatency<NumWorkers>();
+    }
+}
+
+void runTaskPoolBenchmark() {
+    std::printf("=== Task pool: %zu blocking tasks of 200us, %zu timed wakeups ===\n", numThroughputTasks, numLatencySamples);
+    measurePool<1>();
+    measurePool<2>();
+    measurePool<4>();
+    measurePool<8>();
+    measureSimulatedWeek();
+}
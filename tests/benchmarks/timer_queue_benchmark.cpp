@@ -0,0 +1,99 @@
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <random>
+
+#include "utils/container/fixed_size_optional_array.h"
+#include "utils/container/indexed_min_heap.h"
+
+#include "benchmark_utils.h"
+
+// Compares the linear scan, which the TaskPool used to find the next due task,
+// with the indexed heap it uses now. Every cycle pops the earliest timer, reschedules it
+// and cancels / reposts another one, which is roughly what a busy pool does per wakeup.
+namespace {
+    using TimePoint = uint64_t;
+
+    template<size_t NumTimers>
+    struct LinearScanQueue {
+        bool push(size_t handle, TimePoint key) {
+            timers.insert(handle, std::make_pair(handle, key));
+            return true;
+        }
+
+        bool remove(size_t handle) {
+            timers.erase(handle);
+            return true;
+        }
+
+        std::optional<size_t> pop() {
+            auto earliest = timers.end();
+
+            for (auto current = timers.begin(); current != timers.end(); ++current) {
+                if (earliest == timers.end() || current->second < earliest->second) {
+                    earliest = current;
+                }
+            }
+
+            if (earliest == timers.end()) {
+                return std::nullopt;
+            }
+
+            const auto handle = earliest->first;
+            timers.erase(handle);
+            return handle;
+        }
+
+        FixedSizeOptionalArray<std::pair<size_t, TimePoint>, NumTimers> timers;
+    };
+
+    template<size_t NumTimers>
+    struct HeapQueue {
+        bool push(size_t handle, TimePoint key) { return heap.push(handle, key); }
+        bool remove(size_t handle) { return heap.remove(handle); }
+        std::optional<size_t> pop() { return heap.pop(); }
+
+        IndexedMinHeap<TimePoint, NumTimers> heap;
+    };
+
+    template<template<size_t> typename QueueType, size_t NumTimers>
+    double nanosecondsPerCycle(size_t cycles) {
+        auto queue = std::make_unique<QueueType<NumTimers>>();
+        std::mt19937 generator(NumTimers);
+        TimePoint now = 0;
+
+        for (size_t i = 0; i < NumTimers; ++i) {
+            (void) queue->push(i, generator() % 10000);
+        }
+
+        return measureNanosecondsPerIteration(cycles, [&]() {
+            const auto next = queue->pop();
+            now += 1;
+            (void) queue->push(*next, now + generator() % 10000);
+
+            const auto toCancel = generator() % NumTimers;
+            if (queue->remove(toCancel)) {
+                (void) queue->push(toCancel, now + generator() % 10000);
+            }
+        });
+    }
+
+    template<size_t NumTimers>
+    void compareQueues() {
+        const size_t cycles = std::max<size_t>(1000, 2'000'000 / NumTimers);
+        std::printf("%8zu timers : linear scan %10.1f ns/cycle, indexed heap %8.1f ns/cycle\n",
+                    NumTimers,
+                    nanosecondsPerCycle<LinearScanQueue, NumTimers>(cycles),
+                    nanosecondsPerCycle<HeapQueue, NumTimers>(cycles * 10));
+    }
+}
+
+void runTimerQueueBenchmark() {
+    std::printf("=== Timer queue: pop next, reschedule, cancel ===\n");
+    compareQueues<16>();
+    compareQueues<64>();
+    compareQueues<256>();
+    compareQueues<1024>();
+    compareQueues<4096>();
+    compareQueues<16384>();
+}
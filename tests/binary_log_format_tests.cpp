@@ -0,0 +1,70 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+#include "utils/binary_log_format.h"
+
+namespace {
+    template<typename ... Arguments>
+    std::string formatDeferred(const char *format, const Arguments & ... arguments) {
+        std::array<char, 128> encoded{};
+        std::array<char, 256> formatted{};
+
+        const auto encodedLength = encodeBinaryLogArguments(encoded.data(), encoded.size(), arguments ...);
+        EXPECT_TRUE(encodedLength.has_value());
+
+        formatBinaryLogRecord(formatted.data(), formatted.size(), format, encoded.data(), encodedLength.value_or(0));
+        return formatted.data();
+    }
+
+    template<typename ... Arguments>
+    std::string formatNow(const char *format, const Arguments & ... arguments) {
+        std::array<char, 256> formatted{};
+        snprintf(formatted.data(), formatted.size(), format, arguments ...);
+        return formatted.data();
+    }
+}
+
+TEST(BinaryLogFormat, FormatsLikeSnprintf) {
+    EXPECT_EQ(formatDeferred("No arguments, 100%%"), formatNow("No arguments, 100%%"));
+    EXPECT_EQ(formatDeferred("Pin %d set to %u", 13, 1u), formatNow("Pin %d set to %u", 13, 1u));
+    EXPECT_EQ(formatDeferred("%5d|%-5d|%05d", -42, 42, 42), formatNow("%5d|%-5d|%05d", -42, 42, 42));
+    EXPECT_EQ(formatDeferred("%x %X %#o", -1, 255u, 8), formatNow("%x %X %#o", -1, 255u, 8));
+    EXPECT_EQ(formatDeferred("%lld %llu", INT64_MIN, UINT64_MAX), formatNow("%lld %llu", INT64_MIN, UINT64_MAX));
+    EXPECT_EQ(formatDeferred("%zu bytes", sizeof(int64_t)), formatNow("%zu bytes", sizeof(int64_t)));
+    EXPECT_EQ(formatDeferred("%.2f %e %g", 3.14159, 0.5f, 1e10), formatNow("%.2f %e %g", 3.14159, 0.5f, 1e10));
+    EXPECT_EQ(formatDeferred("%*d|%.*f", 6, 7, 1, 2.25), formatNow("%*d|%.*f", 6, 7, 1, 2.25));
+    EXPECT_EQ(formatDeferred("%c%c", 'o', 'k'), formatNow("%c%c", 'o', 'k'));
+
+    int value = 0;
+    EXPECT_EQ(formatDeferred("%p", &value), formatNow("%p", static_cast<void *>(&value)));
+}
+
+TEST(BinaryLogFormat, MarksMissingArguments) {
+    EXPECT_EQ(formatDeferred("%d and %d", 1), "1 and ?");
+    EXPECT_EQ(formatDeferred("Trailing %"), "Trailing ");
+}
+
+TEST(BinaryLogFormat, RejectsArgumentsWhichDontFit) {
+    std::array<char, 10> encoded{};
+
+    EXPECT_TRUE(encodeBinaryLogArguments(encoded.data(), encoded.size(), 1, 2u).has_value());
+    EXPECT_FALSE(encodeBinaryLogArguments(encoded.data(), encoded.size(), 1, 2.0).has_value());
+    static_assert(!BinaryLogArgument<const char *>);
+    static_assert(BinaryLogArgument<const int *>);
+}
+
+TEST(BinaryLogFormat, TruncatesLikeSnprintf) {
+    std::array<char, 128> encoded{};
+    std::array<char, 8> formatted{};
+
+    const auto encodedLength = encodeBinaryLogArguments(encoded.data(), encoded.size(), 123456);
+    const auto length = formatBinaryLogRecord(formatted.data(), formatted.size(), "Value %d", encoded.data(),
+                                              *encodedLength);
+
+    EXPECT_EQ(length, std::string("Value 123456").size());
+    EXPECT_STREQ(formatted.data(), "Value 1");
+}
@@ -0,0 +1,191 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <optional>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
+#include "build_config.h"
+#include "utils/coroutine_task.h"
+#include "utils/time/virtual_clock.h"
+
+namespace {
+    using namespace std::chrono_literals;
+
+    using RealPool = TaskPool<16u, 2u>;
+    using SimulatedPool = TaskPool<16u, 1u, VirtualClock>;
+
+    bool waitFor(auto condition, std::chrono::milliseconds timeout = std::chrono::milliseconds(2000)) {
+        const auto until = std::chrono::steady_clock::now() + timeout;
+        while (!condition()) {
+            if (std::chrono::steady_clock::now() > until) {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    }
+
+    // Moves like the drivers do, the running coroutine is handed over to the new counter
+    class OwnedCounter {
+    public:
+        explicit OwnedCounter(RealPool &pool);
+
+        OwnedCounter(OwnedCounter &&other) noexcept : mTask(std::move(other.mTask)) {
+            mTask.handOver(this, [this, &other]() { count = other.count.exchange(0); });
+        }
+
+        std::atomic_int count = 0;
+
+    private:
+        CoroutineTask<RealPool> mTask;
+    };
+
+    CoroutineTask<RealPool> countForOwner(std::stop_token token) {
+        const auto owner = co_await currentOwner<OwnedCounter>();
+
+        while (!token.stop_requested()) {
+            ++owner->count;
+            co_await sleepFor(1ms);
+        }
+    }
+
+    OwnedCounter::OwnedCounter(RealPool &pool)
+        : mTask(CoroutineTask<RealPool>::spawnFor(this, pool, "Owned counter", TaskPriority::sensing, countForOwner)) { }
+
+    std::optional<OwnedCounter> createCounter(RealPool &pool) {
+        return OwnedCounter(pool);
+    }
+
+    CoroutineTask<RealPool> countUntilStopped(std::stop_token token, std::atomic_int *counter) {
+        while (!token.stop_requested()) {
+            ++*counter;
+            co_await sleepFor(1ms);
+        }
+    }
+
+    struct PollResults {
+        SimulatedPool *pool;
+        bool becameReady = false;
+        VirtualClock::time_point readyAt{};
+        bool timedOut = false;
+        VirtualClock::time_point timedOutAt{};
+    };
+
+    CoroutineTask<SimulatedPool> pollTwice(std::stop_token, PollResults *results) {
+        const auto start = VirtualClock::now();
+
+        results->becameReady = co_await untilReady([start]() { return VirtualClock::now() >= start + 2s; },
+                                                   100ms, 5s);
+        results->readyAt = VirtualClock::now();
+
+        results->timedOut = !co_await untilReady([]() { return false; }, 100ms, 1s);
+        results->timedOutAt = VirtualClock::now();
+
+        results->pool->requestStop();
+    }
+}
+
+TEST(CoroutineTask, ResumesOnWorkersUntilStopped) {
+    RealPool pool;
+    std::vector<std::thread> workers;
+    std::atomic_int counter = 0;
+
+    for (size_t i = 0; i < RealPool::numWorkers(); ++i) {
+        workers.emplace_back([&pool, i]() { pool.doWork(i); });
+    }
+
+    const auto before = CoroutineTaskCounters::statistics();
+    {
+        auto task = CoroutineTask<RealPool>::spawn(pool, "Counter", TaskPriority::sensing, countUntilStopped, &counter);
+
+        EXPECT_TRUE(task.isRunning());
+        EXPECT_EQ(CoroutineTaskCounters::statistics().runningTasks, before.runningTasks + 1);
+        EXPECT_GT(CoroutineTaskCounters::statistics().frameBytes, before.frameBytes);
+        EXPECT_TRUE(waitFor([&counter]() { return counter >= 10; }));
+    }
+
+    // The coroutine doesn't run anymore, once the task is destroyed, the pending resume releases the frame
+    const int countAfterStop = counter;
+    EXPECT_TRUE(waitFor([&before]() {
+        return CoroutineTaskCounters::statistics().runningTasks == before.runningTasks;
+    }));
+    EXPECT_EQ(CoroutineTaskCounters::statistics().frameBytes, before.frameBytes);
+
+    std::this_thread::sleep_for(20ms);
+    EXPECT_EQ(counter, countAfterStop);
+
+    pool.requestStop();
+    for (auto &currentWorker : workers) {
+        currentWorker.join();
+    }
+}
+
+TEST(CoroutineTask, HandsTheCoroutineOverToTheMovedOwner) {
+    RealPool pool;
+    std::vector<std::thread> workers;
+    const auto before = CoroutineTaskCounters::statistics();
+
+    {
+        // Like the drivers during boot, the workers don't run yet, so moving mustn't wait for them
+        auto created = createCounter(pool);
+        ASSERT_TRUE(created.has_value());
+        OwnedCounter counter{std::move(*created)};
+        EXPECT_EQ(CoroutineTaskCounters::statistics().runningTasks, before.runningTasks + 1);
+
+        for (size_t i = 0; i < RealPool::numWorkers(); ++i) {
+            workers.emplace_back([&pool, i]() { pool.doWork(i); });
+        }
+
+        EXPECT_TRUE(waitFor([&counter]() { return counter.count >= 5; }));
+        EXPECT_EQ(created->count, 0);
+    }
+
+    EXPECT_TRUE(waitFor([&before]() {
+        return CoroutineTaskCounters::statistics().runningTasks == before.runningTasks;
+    }));
+
+    pool.requestStop();
+    for (auto &currentWorker : workers) {
+        currentWorker.join();
+    }
+}
+
+TEST(CoroutineTask, StopsWithoutWaitingForWorkers) {
+    RealPool pool;
+    std::atomic_int counter = 0;
+    const auto before = CoroutineTaskCounters::statistics();
+
+    {
+        auto task = CoroutineTask<RealPool>::spawn(pool, "Counter", TaskPriority::sensing, countUntilStopped, &counter);
+        EXPECT_TRUE(task.isRunning());
+    }
+
+    // The pending resume releases the frame, once the workers run
+    std::thread worker([&pool]() { pool.doWork(0); });
+    EXPECT_TRUE(waitFor([&before]() {
+        return CoroutineTaskCounters::statistics().runningTasks == before.runningTasks;
+    }));
+    EXPECT_EQ(counter, 0);
+
+    pool.requestStop();
+    worker.join();
+}
+
+TEST(CoroutineTask, PollsUntilReadyOrTimeout) {
+    VirtualClock::reset();
+    const auto start = VirtualClock::now();
+    SimulatedPool pool;
+    PollResults results{ .pool = &pool };
+
+    auto task = CoroutineTask<SimulatedPool>::spawn(pool, "Poller", TaskPriority::control, pollTwice, &results);
+    pool.doWork(0);
+
+    EXPECT_TRUE(results.becameReady);
+    EXPECT_EQ(results.readyAt - start, 2s);
+    EXPECT_TRUE(results.timedOut);
+    EXPECT_EQ(results.timedOutAt - results.readyAt, 1s);
+    EXPECT_FALSE(task.isRunning());
+}
@@ -0,0 +1,155 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "utils/file_log_sink.h"
+#include "utils/time/virtual_clock.h"
+
+namespace {
+    using namespace std::chrono_literals;
+
+    struct TemporaryLogDirectory {
+        static inline std::string directory;
+        static inline const char *Path = nullptr;
+    };
+
+    class FileLogSinkTest : public ::testing::Test {
+    protected:
+        void SetUp() override {
+            TemporaryLogDirectory::directory = (std::filesystem::temp_directory_path()
+                / ("file_log_sink_" + std::to_string(::getpid()) + "_"
+                   + ::testing::UnitTest::GetInstance()->current_test_info()->name())).string();
+            TemporaryLogDirectory::Path = TemporaryLogDirectory::directory.c_str();
+            std::filesystem::remove_all(TemporaryLogDirectory::directory);
+            VirtualClock::reset();
+        }
+
+        void TearDown() override {
+            std::filesystem::remove_all(TemporaryLogDirectory::directory);
+        }
+
+        static std::string readLog(size_t index) {
+            const auto name = index == 0 ? std::string("log.txt") : "log." + std::to_string(index) + ".txt";
+            std::ifstream file(std::filesystem::path(TemporaryLogDirectory::directory) / name);
+            std::stringstream content;
+            content << file.rdbuf();
+            return content.str();
+        }
+
+        static bool logExists(size_t index) {
+            const auto name = index == 0 ? std::string("log.txt") : "log." + std::to_string(index) + ".txt";
+            return std::filesystem::exists(std::filesystem::path(TemporaryLogDirectory::directory) / name);
+        }
+    };
+
+    constexpr FileLogSinkConfig smallFiles{
+        .bufferSize = 512,
+        .maxFileSize = 1024,
+        .maxFiles = 3,
+        .flushIntervalMs = 1000,
+        .flushLevel = LogLevel::Error
+    };
+
+    using SmallSink = FileLogSink<TemporaryLogDirectory, smallFiles, VirtualClock>;
+}
+
+TEST_F(FileLogSinkTest, FlushesOnTimeAndSeverity) {
+    SmallSink sink;
+
+    EXPECT_TRUE(sink.log(LogLevel::Info, "Pump %d started", 1));
+    EXPECT_FALSE(logExists(0));
+    EXPECT_GT(sink.bufferedBytes(), 0u);
+
+    VirtualClock::advance(1s);
+    sink.poll();
+    EXPECT_EQ(sink.bufferedBytes(), 0u);
+    EXPECT_EQ(readLog(0), "[info] Pump 1 started\n");
+
+    // The logging thread doesn't wait for the file system, the next poll writes and syncs the buffer
+    EXPECT_TRUE(sink.log(LogLevel::Warning, "Buffered"));
+    EXPECT_TRUE(sink.log(LogLevel::Error, "Written with the next poll"));
+    EXPECT_EQ(readLog(0), "[info] Pump 1 started\n");
+
+    sink.poll();
+    EXPECT_EQ(sink.bufferedBytes(), 0u);
+    EXPECT_EQ(readLog(0), "[info] Pump 1 started\n[warn] Buffered\n[error] Written with the next poll\n");
+}
+
+TEST_F(FileLogSinkTest, WritesWholeBlocksWhenTheBufferIsFull) {
+    SmallSink sink;
+    const std::string line(99, 'x');
+
+    // 100 bytes per record with the prefix "[info] " and the newline
+    for (int i = 0; i < 6; ++i) {
+        ASSERT_TRUE(sink.log(LogLevel::Info, "%.92s", line.c_str()));
+    }
+
+    EXPECT_EQ(std::filesystem::file_size(std::filesystem::path(TemporaryLogDirectory::directory) / "log.txt"),
+              SmallSink::blockSize);
+    EXPECT_EQ(sink.bufferedBytes(), 600u - SmallSink::blockSize);
+
+    ASSERT_TRUE(sink.flush(false));
+    EXPECT_EQ(readLog(0).size(), 600u);
+    EXPECT_EQ(readLog(0).find('\n'), 99u);
+}
+
+TEST_F(FileLogSinkTest, RotatesBySizeAndKeepsMaxFiles) {
+    SmallSink sink;
+
+    for (int i = 0; i < 200; ++i) {
+        ASSERT_TRUE(sink.log(LogLevel::Info, "Record %03d with some padding to fill the files", i));
+    }
+    ASSERT_TRUE(sink.flush(true));
+
+    EXPECT_TRUE(logExists(0));
+    EXPECT_TRUE(logExists(1));
+    EXPECT_TRUE(logExists(2));
+    EXPECT_FALSE(logExists(3));
+    EXPECT_GT(sink.statistics().rotations, 2u);
+
+    for (size_t index = 0; index < 3; ++index) {
+        EXPECT_LE(readLog(index).size(), smallFiles.maxFileSize);
+    }
+
+    // The newest records are in log.txt, the older ones in the rotated files
+    EXPECT_NE(readLog(0).find("Record 199"), std::string::npos);
+    EXPECT_EQ(readLog(1).find("Record 199"), std::string::npos);
+    EXPECT_EQ(sink.statistics().droppedRecords, 0u);
+}
+
+TEST_F(FileLogSinkTest, RotatesAFileOfAPreviousBootBeforeWriting) {
+    std::filesystem::create_directories(TemporaryLogDirectory::directory);
+    {
+        std::ofstream previous(std::filesystem::path(TemporaryLogDirectory::directory) / "log.txt");
+        previous << std::string(smallFiles.maxFileSize, 'p');
+    }
+
+    SmallSink sink;
+    ASSERT_TRUE(sink.log(LogLevel::Info, "After reboot"));
+    ASSERT_TRUE(sink.flush(false));
+
+    EXPECT_EQ(sink.statistics().rotations, 1u);
+    EXPECT_EQ(readLog(0), "[info] After reboot\n");
+    EXPECT_EQ(readLog(1).size(), smallFiles.maxFileSize);
+}
+
+TEST_F(FileLogSinkTest, WorksAsSinkOfAnAsyncLogger) {
+    using TestLogger = ApplicationLogger<QuietBackend, LogLevel::Debug, SmallSink>;
+
+    TestLogger::enableAsync(LogOverflowPolicy::dropNew);
+    EXPECT_TRUE(TestLogger::log(LogLevel::Info, "Queued %d", 7));
+    EXPECT_FALSE(logExists(0));
+
+    // The drain task writes the record into the buffer of the sink and flushes it, once the interval passed
+    EXPECT_EQ(TestLogger::drain(), 1u);
+    EXPECT_FALSE(logExists(0));
+
+    VirtualClock::advance(1s);
+    EXPECT_EQ(TestLogger::drain(), 0u);
+    EXPECT_EQ(readLog(0), "[info] Queued 7\n");
+}
@@ -0,0 +1,97 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "utils/container/indexed_min_heap.h"
+
+TEST(IndexedMinHeap, PopsInKeyOrder) {
+    IndexedMinHeap<int, 8> heap;
+
+    EXPECT_TRUE(heap.empty());
+    EXPECT_FALSE(heap.top().has_value());
+
+    EXPECT_TRUE(heap.push(0, 50));
+    EXPECT_TRUE(heap.push(1, 10));
+    EXPECT_TRUE(heap.push(2, 30));
+    EXPECT_TRUE(heap.push(3, 20));
+    EXPECT_EQ(heap.size(), 4);
+
+    EXPECT_EQ(heap.top(), 1);
+    EXPECT_EQ(heap.key(*heap.top()), 10);
+
+    EXPECT_EQ(heap.pop(), 1);
+    EXPECT_EQ(heap.pop(), 3);
+    EXPECT_EQ(heap.pop(), 2);
+    EXPECT_EQ(heap.pop(), 0);
+    EXPECT_FALSE(heap.pop().has_value());
+    EXPECT_TRUE(heap.empty());
+}
+
+TEST(IndexedMinHeap, RejectsInvalidHandles) {
+    IndexedMinHeap<int, 4> heap;
+
+    EXPECT_TRUE(heap.push(2, 1));
+    EXPECT_FALSE(heap.push(2, 5));
+    EXPECT_FALSE(heap.push(4, 5));
+    EXPECT_FALSE(heap.remove(3));
+    EXPECT_FALSE(heap.update(1, 3));
+    EXPECT_EQ(heap.size(), 1);
+}
+
+TEST(IndexedMinHeap, RemoveAndUpdate) {
+    IndexedMinHeap<int, 8> heap;
+
+    for (int i = 0; i < 8; ++i) {
+        EXPECT_TRUE(heap.push(i, i * 10));
+    }
+
+    EXPECT_TRUE(heap.remove(0));
+    EXPECT_FALSE(heap.contains(0));
+    EXPECT_EQ(heap.top(), 1);
+
+    EXPECT_TRUE(heap.update(7, -1));
+    EXPECT_EQ(heap.top(), 7);
+
+    EXPECT_TRUE(heap.update(7, 100));
+    EXPECT_EQ(heap.top(), 1);
+
+    EXPECT_TRUE(heap.remove(4));
+    EXPECT_TRUE(heap.push(0, 35));
+
+    std::vector<size_t> order;
+    while (auto handle = heap.pop()) {
+        order.push_back(*handle);
+    }
+
+    EXPECT_EQ(order, (std::vector<size_t>{1, 2, 3, 0, 5, 6, 7}));
+}
+
+TEST(IndexedMinHeap, MatchesSortedOrderWithRandomRemovals) {
+    constexpr size_t numElements = 512;
+    IndexedMinHeap<uint32_t, numElements> heap;
+    std::mt19937 generator(42);
+    std::vector<std::pair<uint32_t, size_t>> expected;
+
+    for (size_t i = 0; i < numElements; ++i) {
+        const auto key = static_cast<uint32_t>(generator() % 10000);
+        EXPECT_TRUE(heap.push(i, key));
+        expected.emplace_back(key, i);
+    }
+
+    for (size_t i = 0; i < numElements; i += 3) {
+        EXPECT_TRUE(heap.remove(i));
+        std::erase_if(expected, [i](const auto &entry) { return entry.second == i; });
+    }
+
+    std::ranges::sort(expected);
+
+    for (const auto &[key, handle] : expected) {
+        const auto top = heap.pop();
+        ASSERT_TRUE(top.has_value());
+        EXPECT_EQ(heap.key(*top), key);
+    }
+
+    EXPECT_TRUE(heap.empty());
+}
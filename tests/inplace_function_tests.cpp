@@ -0,0 +1,71 @@
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <utility>
+
+#include "utils/inplace_function.h"
+
+namespace {
+    // Counts the living copies, so leaks and double destructions show up
+    struct Tracked {
+        explicit Tracked(int *living) : living(living) { ++*living; }
+        Tracked(Tracked &&other) noexcept : living(other.living) { ++*living; }
+        ~Tracked() { --*living; }
+
+        int *living;
+    };
+}
+
+TEST(InplaceFunction, CallsCapturingLambdas) {
+    int sum = 0;
+    const int offset = 3;
+    InplaceFunction<void(int), 32> addTo{[&sum, offset](int value) { sum += value + offset; }};
+
+    ASSERT_TRUE(static_cast<bool>(addTo));
+    addTo(1);
+    addTo(2);
+
+    EXPECT_EQ(sum, 9);
+}
+
+TEST(InplaceFunction, EmptyFunctionsDoNothing) {
+    InplaceFunction<int(), 16> function;
+
+    EXPECT_FALSE(static_cast<bool>(function));
+    EXPECT_EQ(function(), 0);
+
+    function = []() { return 42; };
+    EXPECT_EQ(function(), 42);
+
+    function = nullptr;
+    EXPECT_FALSE(static_cast<bool>(function));
+}
+
+TEST(InplaceFunction, MovesOwnershipOfTheCallable) {
+    int living = 0;
+    {
+        InplaceFunction<int(), 32> first{[tracked = Tracked{&living}, value = 7]() { return value; }};
+        EXPECT_EQ(living, 1);
+
+        InplaceFunction<int(), 32> second{std::move(first)};
+        EXPECT_EQ(living, 1);
+        EXPECT_FALSE(static_cast<bool>(first));
+        EXPECT_EQ(second(), 7);
+
+        InplaceFunction<int(), 32> third{[tracked = Tracked{&living}]() { return 1; }};
+        EXPECT_EQ(living, 2);
+
+        third = std::move(second);
+        EXPECT_EQ(living, 1);
+        EXPECT_EQ(third(), 7);
+    }
+
+    EXPECT_EQ(living, 0);
+}
+
+TEST(InplaceFunction, StoresMoveOnlyCallables) {
+    InplaceFunction<int(), 16> function{[pointer = std::make_unique<int>(5)]() { return *pointer; }};
+
+    EXPECT_EQ(function(), 5);
+    static_assert(!std::is_copy_constructible_v<decltype(function)>);
+}
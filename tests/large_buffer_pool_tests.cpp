@@ -0,0 +1,211 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "utils/large_buffer_pool.h"
+
+namespace {
+    using TestPool = LargeBufferPool<BufferLocation::stack,
+        BufferSizeClass<64, 3>,
+        BufferSizeClass<256, 40>,
+        BufferSizeClass<1024, 2>>;
+
+    using HeapPool = LargeBufferPool<BufferLocation::heap, BufferSizeClass<128, 2>>;
+    // Every test with waiting callers gets its own pool, so the metrics aren't shared
+    using SingleBufferPool = LargeBufferPool<BufferLocation::stack, BufferSizeClass<32, 1>>;
+    using FifoPool = LargeBufferPool<BufferLocation::stack, BufferSizeClass<48, 1>>;
+    using MetricsPool = LargeBufferPool<BufferLocation::stack, BufferSizeClass<16, 2>, BufferSizeClass<96, 1>>;
+
+    template<typename PoolType>
+    std::vector<BufferSizeClassMetrics> metricsOf() {
+        std::vector<BufferSizeClassMetrics> metrics;
+        PoolType::forEachSizeClassMetrics([&metrics](const BufferSizeClassMetrics &current) {
+            metrics.push_back(current);
+        });
+        return metrics;
+    }
+}
+
+TEST(LargeBufferPool, ChoosesTheBestFittingSizeClass) {
+    auto tiny = TestPool::get_free_buffer(1);
+    auto exact = TestPool::get_free_buffer(64);
+    auto medium = TestPool::get_free_buffer(65);
+    auto large = TestPool::get_free_buffer(1000);
+
+    ASSERT_TRUE(tiny.has_value());
+    ASSERT_TRUE(exact.has_value());
+    ASSERT_TRUE(medium.has_value());
+    ASSERT_TRUE(large.has_value());
+
+    EXPECT_EQ(tiny->size(), 64u);
+    EXPECT_EQ(exact->size(), 64u);
+    EXPECT_EQ(medium->size(), 256u);
+    EXPECT_EQ(large->size(), 1024u);
+    EXPECT_NE(tiny->data(), exact->data());
+
+    EXPECT_FALSE(TestPool::get_free_buffer(TestPool::maxBufferSize + 1).has_value());
+}
+
+TEST(LargeBufferPool, SizeClassesRunOutSeparately) {
+    std::vector<TestPool::LargeBufferBorrowerType> borrowed;
+
+    for (size_t i = 0; i < 2; ++i) {
+        auto buffer = TestPool::get_free_buffer(1024);
+        ASSERT_TRUE(buffer.has_value());
+        borrowed.emplace_back(std::move(*buffer));
+    }
+
+    // The smaller classes don't give their buffers to larger requests, and the other way around
+    EXPECT_FALSE(TestPool::get_free_buffer(1024).has_value());
+    EXPECT_TRUE(TestPool::get_free_buffer(64).has_value());
+
+    char *returned = borrowed.back().data();
+    borrowed.pop_back();
+
+    auto again = TestPool::get_free_buffer(512);
+    ASSERT_TRUE(again.has_value());
+    EXPECT_EQ(again->data(), returned);
+}
+
+TEST(LargeBufferPool, LendsEveryBufferOnceAcrossThreads) {
+    constexpr size_t numThreads = 4;
+    constexpr size_t rounds = 2000;
+    std::atomic_bool overlapping = false;
+    std::vector<std::atomic_bool> inUse(40);
+    std::vector<std::thread> threads;
+
+    std::optional<TestPool::LargeBufferBorrowerType> first = TestPool::get_free_buffer(256);
+    ASSERT_TRUE(first.has_value());
+    const char *base = first->data();
+    first.reset();
+
+    for (size_t i = 0; i < numThreads; ++i) {
+        threads.emplace_back([&]() {
+            for (size_t round = 0; round < rounds; ++round) {
+                auto buffer = TestPool::get_free_buffer(200);
+                if (!buffer.has_value()) {
+                    continue;
+                }
+
+                const auto index = static_cast<size_t>(buffer->data() - base) / buffer->size();
+                if (index >= inUse.size() || inUse[index].exchange(true)) {
+                    overlapping = true;
+                }
+                inUse[index] = false;
+            }
+        });
+    }
+
+    for (auto &currentThread : threads) {
+        currentThread.join();
+    }
+
+    EXPECT_FALSE(overlapping);
+}
+
+TEST(LargeBufferPool, AllocatesHeapSlabs) {
+    auto first = HeapPool::get_free_buffer(100);
+    auto second = HeapPool::get_free_buffer(100);
+
+    ASSERT_TRUE(first.has_value());
+    ASSERT_TRUE(second.has_value());
+    EXPECT_EQ(std::abs(first->data() - second->data()), 128);
+    EXPECT_FALSE(HeapPool::get_free_buffer(100).has_value());
+
+    std::fill_n(first->data(), first->size(), 'x');
+    first.reset();
+    EXPECT_TRUE(HeapPool::get_free_buffer(128).has_value());
+}
+
+TEST(LargeBufferPool, WaitsForAReturnedBuffer) {
+    using namespace std::chrono_literals;
+
+    auto borrowed = SingleBufferPool::get_free_buffer(32);
+    ASSERT_TRUE(borrowed.has_value());
+    EXPECT_FALSE(SingleBufferPool::get_free_buffer(32).has_value());
+    EXPECT_FALSE(SingleBufferPool::wait_for_free_buffer(32, 20ms).has_value());
+
+    char *returned = borrowed->data();
+    std::thread returner([&borrowed]() {
+        std::this_thread::sleep_for(20ms);
+        borrowed.reset();
+    });
+
+    auto waited = SingleBufferPool::wait_for_free_buffer(32, 5s);
+    returner.join();
+
+    ASSERT_TRUE(waited.has_value());
+    EXPECT_EQ(waited->data(), returned);
+}
+
+TEST(LargeBufferPool, HandsReturnedBuffersToTheWaitersInOrder) {
+    using namespace std::chrono_literals;
+
+    auto borrowed = FifoPool::get_free_buffer(48);
+    ASSERT_TRUE(borrowed.has_value());
+
+    std::mutex orderMutex;
+    std::vector<int> order;
+    std::vector<std::thread> waiters;
+
+    for (int i = 0; i < 3; ++i) {
+        waiters.emplace_back([i, &orderMutex, &order]() {
+            auto buffer = FifoPool::wait_for_free_buffer(48, 5s);
+            ASSERT_TRUE(buffer.has_value());
+
+            std::unique_lock guard{orderMutex};
+            order.push_back(i);
+        });
+
+        // Waits, until the waiter is queued
+        while (metricsOf<FifoPool>()[0].waitingCallers != static_cast<uint32_t>(i + 1)) {
+            std::this_thread::yield();
+        }
+    }
+
+    borrowed.reset();
+    for (auto &currentWaiter : waiters) {
+        currentWaiter.join();
+    }
+
+    EXPECT_EQ(order, (std::vector<int>{0, 1, 2}));
+}
+
+TEST(LargeBufferPool, ReportsMetricsPerSizeClass) {
+    using namespace std::chrono_literals;
+
+    {
+        auto first = MetricsPool::get_free_buffer(10);
+        auto second = MetricsPool::get_free_buffer(16);
+        auto large = MetricsPool::get_free_buffer(64);
+
+        EXPECT_FALSE(MetricsPool::get_free_buffer(1).has_value());
+        EXPECT_FALSE(MetricsPool::wait_for_free_buffer(96, 10ms).has_value());
+
+        const auto metrics = metricsOf<MetricsPool>();
+        ASSERT_EQ(metrics.size(), 2u);
+        EXPECT_EQ(metrics[0].borrowedBuffers, 2u);
+        EXPECT_EQ(metrics[1].borrowedBuffers, 1u);
+    }
+
+    auto again = MetricsPool::get_free_buffer(16);
+    const auto metrics = metricsOf<MetricsPool>();
+
+    EXPECT_EQ(metrics[0].bufferSize, 16u);
+    EXPECT_EQ(metrics[0].numBuffers, 2u);
+    EXPECT_EQ(metrics[0].borrowedBuffers, 1u);
+    EXPECT_EQ(metrics[0].highWaterMark, 2u);
+    EXPECT_EQ(metrics[0].failedAcquisitions, 1u);
+    EXPECT_EQ(metrics[0].waitTimeHistogram[0], 3u);
+
+    EXPECT_EQ(metrics[1].bufferSize, 96u);
+    EXPECT_EQ(metrics[1].highWaterMark, 1u);
+    EXPECT_EQ(metrics[1].failedAcquisitions, 1u);
+    EXPECT_EQ(metrics[1].waitTimeHistogram[0], 1u);
+}
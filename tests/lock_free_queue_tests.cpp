@@ -0,0 +1,80 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "utils/container/lock_free_queue.h"
+
+TEST(LockFreeQueue, PushAndPopInOrder) {
+    LockFreeQueue<int, 4> queue;
+
+    EXPECT_TRUE(queue.empty());
+    EXPECT_FALSE(queue.pop().has_value());
+
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_TRUE(queue.push(i));
+    }
+
+    EXPECT_FALSE(queue.push(4));
+    EXPECT_FALSE(queue.empty());
+
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_EQ(queue.pop(), i);
+    }
+
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST(LockFreeQueue, WrapsAround) {
+    LockFreeQueue<int, 2> queue;
+
+    for (int i = 0; i < 10; ++i) {
+        EXPECT_TRUE(queue.push(i));
+        EXPECT_TRUE(queue.push(i + 100));
+        EXPECT_EQ(queue.pop(), i);
+        EXPECT_EQ(queue.pop(), i + 100);
+    }
+
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST(LockFreeQueue, MultipleProducersSingleConsumer) {
+    constexpr int numProducers = 4;
+    constexpr int valuesPerProducer = 10000;
+    LockFreeQueue<int, 64> queue;
+    std::vector<std::thread> producers;
+
+    for (int producer = 0; producer < numProducers; ++producer) {
+        producers.emplace_back([&queue, producer]() {
+            for (int i = 0; i < valuesPerProducer; ++i) {
+                while (!queue.push(producer * valuesPerProducer + i)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    // Values of one producer have to arrive in the order they were pushed
+    std::vector<int> lastValueOf(numProducers, -1);
+    int received = 0;
+
+    while (received < numProducers * valuesPerProducer) {
+        const auto value = queue.pop();
+        if (!value.has_value()) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        const int producer = *value / valuesPerProducer;
+        EXPECT_GT(*value, lastValueOf[producer]);
+        lastValueOf[producer] = *value;
+        ++received;
+    }
+
+    for (auto &currentProducer : producers) {
+        currentProducer.join();
+    }
+
+    EXPECT_TRUE(queue.empty());
+}
@@ -0,0 +1,148 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <chrono>
+#include <string>
+#include <thread>
+
+#include "utils/logger.h"
+#include "utils/time/virtual_clock.h"
+
+namespace {
+    using namespace std::chrono_literals;
+
+    constexpr LogRateLimitConfig smallBurst{
+        .burst = 2,
+        .refillIntervalMs = 1000,
+        .repeatReportIntervalMs = 10000,
+        .numCallSites = 2
+    };
+
+    using TestLimiter = LogRateLimiter<smallBurst, VirtualClock>;
+
+    constexpr const char *readFailed = "Couldn't read sensor %d";
+    constexpr const char *busFailed = "Bus %d failed";
+    constexpr const char *bufferMissing = "Couldn't find free buffer";
+}
+
+TEST(LogRateLimiter, RefillsTheBucketOfEveryCallSite) {
+    TestLimiter limiter;
+    VirtualClock::reset();
+
+    EXPECT_TRUE(limiter.admit(LogLevel::Warning, readFailed, hashLogArguments(1)).admitted);
+    EXPECT_TRUE(limiter.admit(LogLevel::Warning, readFailed, hashLogArguments(2)).admitted);
+    EXPECT_FALSE(limiter.admit(LogLevel::Warning, readFailed, hashLogArguments(3)).admitted);
+    EXPECT_FALSE(limiter.admit(LogLevel::Warning, readFailed, hashLogArguments(4)).admitted);
+
+    // Other call sites have their own bucket
+    EXPECT_TRUE(limiter.admit(LogLevel::Warning, busFailed, hashLogArguments(1)).admitted);
+
+    VirtualClock::advance(1s);
+    const auto admission = limiter.admit(LogLevel::Warning, readFailed, hashLogArguments(5));
+    EXPECT_TRUE(admission.admitted);
+    EXPECT_EQ(admission.suppressedRecords, 2u);
+    EXPECT_FALSE(limiter.admit(LogLevel::Warning, readFailed, hashLogArguments(6)).admitted);
+    EXPECT_EQ(limiter.suppressedRecords(), 3u);
+}
+
+TEST(LogRateLimiter, CollapsesRepeatedRecords) {
+    TestLimiter limiter;
+    VirtualClock::reset();
+
+    EXPECT_TRUE(limiter.admit(LogLevel::Warning, readFailed, hashLogArguments(1)).admitted);
+
+    // Repeats don't take tokens, so they are collapsed as long as they are repeated
+    for (int i = 0; i < 100; ++i) {
+        const auto admission = limiter.admit(LogLevel::Warning, readFailed, hashLogArguments(1));
+        EXPECT_FALSE(admission.admitted);
+        EXPECT_EQ(admission.repeatedRecords, 0u);
+        VirtualClock::advance(10ms);
+    }
+
+    const auto admission = limiter.admit(LogLevel::Warning, readFailed, hashLogArguments(2));
+    EXPECT_TRUE(admission.admitted);
+    EXPECT_EQ(admission.repeatedRecords, 100u);
+    EXPECT_EQ(admission.repeatedLevel, LogLevel::Warning);
+}
+
+TEST(LogRateLimiter, ReportsRecordsWhichAreRepeatedForever) {
+    TestLimiter limiter;
+    VirtualClock::reset();
+
+    EXPECT_TRUE(limiter.admit(LogLevel::Error, bufferMissing, hashLogArguments()).admitted);
+
+    uint32_t reportedRecords = 0;
+    for (int i = 0; i < 10; ++i) {
+        VirtualClock::advance(3s);
+        const auto admission = limiter.admit(LogLevel::Error, bufferMissing, hashLogArguments());
+        EXPECT_FALSE(admission.admitted);
+        reportedRecords += admission.repeatedRecords;
+    }
+
+    // Reported after 12s and 24s, the last two repeats are still collapsed
+    EXPECT_EQ(reportedRecords, 8u);
+    EXPECT_EQ(limiter.suppressedRecords(), 10u);
+}
+
+TEST(LogRateLimiter, ComparesStringsByAddress) {
+    std::string first = "sensor";
+    std::string second = "sensor";
+
+    EXPECT_EQ(hashLogArguments(first.c_str(), 1), hashLogArguments(first.c_str(), 1));
+    EXPECT_NE(hashLogArguments(first.c_str(), 1), hashLogArguments(first.c_str(), 2));
+    EXPECT_NE(hashLogArguments(first.c_str(), 1), hashLogArguments(second.c_str(), 1));
+
+    // Views for %.*s aren't terminated, so they must not be read
+    const std::array<char, 3> unterminated{'a', 'b', 'c'};
+    EXPECT_EQ(hashLogArguments(3, unterminated.data()), hashLogArguments(3, unterminated.data()));
+}
+
+TEST(LogRateLimiter, DoesntLimitCallSitesWithoutAFreeEntry) {
+    TestLimiter limiter;
+    VirtualClock::reset();
+
+    EXPECT_TRUE(limiter.admit(LogLevel::Info, readFailed, hashLogArguments(1)).admitted);
+    EXPECT_TRUE(limiter.admit(LogLevel::Info, busFailed, hashLogArguments(1)).admitted);
+
+    for (int i = 0; i < 5; ++i) {
+        EXPECT_TRUE(limiter.admit(LogLevel::Info, bufferMissing, hashLogArguments(i)).admitted);
+    }
+
+    // Once the bucket of a call site is full again, its entry can be reused
+    VirtualClock::advance(1s);
+    for (int i = 0; i < 3; ++i) {
+        (void) limiter.admit(LogLevel::Info, bufferMissing, hashLogArguments(i));
+    }
+    EXPECT_FALSE(limiter.admit(LogLevel::Info, bufferMissing, hashLogArguments(3)).admitted);
+}
+
+TEST(LogRateLimiter, ClaimsEntriesFromSeveralThreads) {
+    constexpr LogRateLimitConfig manyCallSites{
+        .burst = 2,
+        .refillIntervalMs = 1000,
+        .repeatReportIntervalMs = 10000,
+        .numCallSites = 8
+    };
+    static constexpr std::array<const char *, 4> formats{ "Pump %d", "Heater %d", "Light %d", "Sensor %d" };
+
+    LogRateLimiter<manyCallSites, VirtualClock> limiter;
+    VirtualClock::reset();
+    std::array<int, formats.size()> admitted{};
+
+    {
+        std::array<std::jthread, formats.size()> threads;
+        for (size_t i = 0; i < threads.size(); ++i) {
+            threads[i] = std::jthread([&limiter, &admitted, i]() {
+                for (int value = 0; value < 100; ++value) {
+                    admitted[i] += limiter.admit(LogLevel::Warning, formats[i], hashLogArguments(value)).admitted;
+                }
+            });
+        }
+    }
+
+    // Every call site has its own entry, so each of them got exactly its burst
+    for (const auto currentAdmitted : admitted) {
+        EXPECT_EQ(currentAdmitted, manyCallSites.burst);
+    }
+    EXPECT_EQ(limiter.suppressedRecords(), formats.size() * (100 - manyCallSites.burst));
+}
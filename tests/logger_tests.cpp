@@ -0,0 +1,211 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "utils/logger.h"
+
+namespace {
+    // Every logger gets its own Tag, so the static state of the loggers doesn't leak between tests
+    template<int Tag>
+    class RecordingSink final {
+        public:
+            bool install() { return true; }
+            bool uninstall() { return true; }
+
+            template<typename ... Arguments>
+            bool log(LogLevel level, const char *fmt, Arguments && ... args) {
+                std::array<char, 256> formatted{};
+                snprintf(formatted.data(), formatted.size(), fmt, args ...);
+                records.emplace_back(formatted.data());
+                return true;
+            }
+
+            static inline std::vector<std::string> records;
+    };
+}
+
+TEST(AsyncLogger, QueuesRecordsUntilDrained) {
+    using Sink = RecordingSink<0>;
+    using TestLogger = ApplicationLogger<QuietBackend, LogLevel::Debug, Sink>;
+
+    TestLogger::enableAsync(LogOverflowPolicy::dropNew);
+
+    EXPECT_TRUE(TestLogger::log(LogLevel::Info, "First %d", 1));
+    EXPECT_TRUE(TestLogger::log(LogLevel::Info, "Second %s", "record"));
+    EXPECT_TRUE(Sink::records.empty());
+
+    EXPECT_EQ(TestLogger::drain(), 2u);
+    ASSERT_EQ(Sink::records.size(), 2u);
+    EXPECT_EQ(Sink::records[0], "First 1");
+    EXPECT_EQ(Sink::records[1], "Second record");
+
+    TestLogger::disableAsync();
+    EXPECT_TRUE(TestLogger::log(LogLevel::Info, "Synchronous"));
+    EXPECT_EQ(Sink::records.back(), "Synchronous");
+}
+
+TEST(AsyncLogger, AppliesOverflowPolicy) {
+    using DropNewSink = RecordingSink<1>;
+    using DropNewLogger = ApplicationLogger<QuietBackend, LogLevel::Debug, DropNewSink>;
+
+    DropNewLogger::enableAsync(LogOverflowPolicy::dropNew);
+    for (size_t i = 0; i < asyncLogQueueSize + 3; ++i) {
+        (void) DropNewLogger::log(LogLevel::Info, "Record %u", static_cast<unsigned int>(i));
+    }
+
+    EXPECT_EQ(DropNewLogger::statistics().droppedRecords, 3u);
+    EXPECT_EQ(DropNewLogger::drain(), asyncLogQueueSize);
+    EXPECT_EQ(DropNewSink::records.front(), "Record 0");
+
+    using DropOldestSink = RecordingSink<2>;
+    using DropOldestLogger = ApplicationLogger<QuietBackend, LogLevel::Debug, DropOldestSink>;
+
+    DropOldestLogger::enableAsync(LogOverflowPolicy::dropOldest);
+    for (size_t i = 0; i < asyncLogQueueSize + 3; ++i) {
+        (void) DropOldestLogger::log(LogLevel::Info, "Record %u", static_cast<unsigned int>(i));
+    }
+
+    EXPECT_EQ(DropOldestLogger::statistics().droppedRecords, 3u);
+    EXPECT_EQ(DropOldestLogger::drain(), asyncLogQueueSize);
+    EXPECT_EQ(DropOldestSink::records.front(), "Record 3");
+    EXPECT_EQ(DropOldestSink::records.back(), "Record " + std::to_string(asyncLogQueueSize + 2));
+}
+
+TEST(AsyncLogger, BlocksUntilTheDrainTaskMadeRoom) {
+    using Sink = RecordingSink<3>;
+    using TestLogger = ApplicationLogger<QuietBackend, LogLevel::Debug, Sink>;
+    constexpr size_t numProducers = 4;
+    constexpr size_t recordsPerProducer = 100;
+
+    TestLogger::enableAsync(LogOverflowPolicy::block);
+
+    std::atomic_bool producing = true;
+    std::thread drainer([&producing]() {
+        while (producing) {
+            (void) TestLogger::drain();
+            std::this_thread::yield();
+        }
+    });
+
+    std::vector<std::thread> producers;
+    for (size_t i = 0; i < numProducers; ++i) {
+        producers.emplace_back([]() {
+            for (size_t j = 0; j < recordsPerProducer; ++j) {
+                (void) TestLogger::log(LogLevel::Info, "Record %u", static_cast<unsigned int>(j));
+            }
+        });
+    }
+
+    for (auto &currentProducer : producers) {
+        currentProducer.join();
+    }
+    producing = false;
+    drainer.join();
+    (void) TestLogger::drain();
+
+    EXPECT_EQ(Sink::records.size(), numProducers * recordsPerProducer);
+    EXPECT_EQ(TestLogger::statistics().droppedRecords, 0u);
+}
+
+TEST(AsyncLogger, TruncatesOversizedRecords) {
+    using Sink = RecordingSink<4>;
+    using TestLogger = ApplicationLogger<QuietBackend, LogLevel::Debug, Sink>;
+    const std::string longMessage(asyncLogMessageSize + 10, 'x');
+
+    TestLogger::enableAsync(LogOverflowPolicy::dropNew);
+
+    // The caller never waits for the sinks
+    EXPECT_TRUE(TestLogger::log(LogLevel::Warning, "%s", longMessage.c_str()));
+    EXPECT_TRUE(Sink::records.empty());
+    EXPECT_EQ(TestLogger::statistics().oversizedRecords, 1u);
+
+    EXPECT_EQ(TestLogger::drain(), 1u);
+    ASSERT_EQ(Sink::records.size(), 1u);
+    EXPECT_EQ(Sink::records[0], longMessage.substr(0, asyncLogMessageSize - 4) + "...");
+}
+
+TEST(Logger, FiltersBelowCompiledAndRuntimeLevel) {
+    using Sink = RecordingSink<5>;
+    using TestLogger = ApplicationLogger<QuietBackend, LogLevel::Info, Sink>;
+
+    EXPECT_FALSE(TestLogger::isEnabled(LogLevel::Debug));
+    EXPECT_TRUE(TestLogger::log(LogLevel::Debug, "Compiled out"));
+    EXPECT_TRUE(TestLogger::log(LogLevel::Info, "Kept"));
+
+    TestLogger::ignoreLogsBelow(LogLevel::Warning);
+    EXPECT_FALSE(TestLogger::isEnabled(LogLevel::Info));
+    EXPECT_TRUE(TestLogger::log(LogLevel::Info, "Filtered at runtime"));
+    EXPECT_TRUE(TestLogger::log(LogLevel::Error, "Error"));
+
+    ASSERT_EQ(Sink::records.size(), 2u);
+    EXPECT_EQ(Sink::records[0], "Kept");
+    EXPECT_EQ(Sink::records[1], "Error");
+}
+
+TEST(Logger, SkipsTheArgumentsOfDisabledLevels) {
+    using Sink = RecordingSink<8>;
+    // LOG_IF_ENABLED uses the Logger of the scope
+    using Logger = ApplicationLogger<QuietBackend, LogLevel::Info, Sink>;
+    int evaluations = 0;
+    const auto expensive = [&evaluations]() { return ++evaluations; };
+
+    LOG_IF_ENABLED(LogLevel::Debug, "Compiled out %d", expensive());
+    LOG_IF_ENABLED(LogLevel::Info, "Kept %d", expensive());
+
+    Logger::ignoreLogsBelow(LogLevel::Warning);
+    LOG_IF_ENABLED(LogLevel::Info, "Filtered at runtime %d", expensive());
+
+    EXPECT_EQ(evaluations, 1);
+    ASSERT_EQ(Sink::records.size(), 1u);
+    EXPECT_EQ(Sink::records[0], "Kept 1");
+}
+
+TEST(AsyncLogger, DefersFormattingOfBinaryRecords) {
+    using Sink = RecordingSink<6>;
+    using TestLogger = ApplicationLogger<QuietBackend, LogLevel::Debug, Sink>;
+
+    TestLogger::enableAsync(LogOverflowPolicy::dropNew, LogEncoding::binary);
+
+    EXPECT_TRUE(TestLogger::log(LogLevel::Info, "Pin %d at %.1f%%", 4, 12.5));
+    EXPECT_TRUE(TestLogger::log(LogLevel::Info, "Text %s", "argument"));
+    EXPECT_TRUE(Sink::records.empty());
+
+    EXPECT_EQ(TestLogger::drain(), 2u);
+    ASSERT_EQ(Sink::records.size(), 2u);
+    EXPECT_EQ(Sink::records[0], "Pin 4 at 12.5%");
+    EXPECT_EQ(Sink::records[1], "Text argument");
+}
+
+TEST(Logger, SummarizesRecordsOfLimitedCallSites) {
+    using Sink = RecordingSink<7>;
+    using TestLogger = ApplicationLogger<QuietBackend, LogLevel::Debug, Sink>;
+    constexpr const char *failedRead = "Couldn't read sensor %d";
+
+    TestLogger::enableRateLimit();
+
+    for (int i = 0; i < 20; ++i) {
+        EXPECT_TRUE(TestLogger::log(LogLevel::Warning, "Couldn't read temperature"));
+    }
+    EXPECT_TRUE(TestLogger::log(LogLevel::Warning, failedRead, 1));
+    EXPECT_TRUE(TestLogger::log(LogLevel::Warning, "Couldn't read temperature %s", "again"));
+
+    // Different values aren't repeats, but the bucket of the call site runs empty
+    for (int i = 0; i < 20; ++i) {
+        EXPECT_TRUE(TestLogger::log(LogLevel::Warning, failedRead, i));
+    }
+
+    ASSERT_GE(Sink::records.size(), 3u);
+    EXPECT_EQ(Sink::records[0], "Couldn't read temperature");
+    EXPECT_EQ(Sink::records[1], "Couldn't read sensor 1");
+    EXPECT_EQ(Sink::records[2], "Couldn't read temperature again");
+    EXPECT_EQ(Sink::records.size(), 3u + LogRateLimitConfig{}.burst - 1);
+    EXPECT_EQ(TestLogger::statistics().suppressedRecords, 19u + 20u - (LogRateLimitConfig{}.burst - 1));
+
+    TestLogger::disableRateLimit();
+    EXPECT_TRUE(TestLogger::log(LogLevel::Warning, failedRead, 1));
+    EXPECT_EQ(Sink::records.back(), "Couldn't read sensor 1");
+}
@@ -0,0 +1,110 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "utils/memory_log_sink.h"
+#include "utils/time/virtual_clock.h"
+
+namespace {
+    using namespace std::chrono_literals;
+
+    using SmallSink = MemoryLogSink<4, 16, VirtualClock>;
+
+    std::vector<std::string> messagesSince(const SmallSink &sink, uint32_t since, RecentLogRange &range) {
+        std::vector<std::string> messages;
+        range = sink.forEachRecordSince(since, [&messages](const SmallSink::RecordType &record) {
+            messages.emplace_back(record.message.data());
+            return true;
+        });
+        return messages;
+    }
+}
+
+TEST(MemoryLogSink, FetchesRecordsIncrementally) {
+    VirtualClock::reset();
+    SmallSink sink;
+    RecentLogRange range{};
+
+    EXPECT_TRUE(messagesSince(sink, 0, range).empty());
+    EXPECT_EQ(range.lastSequence, 0u);
+
+    EXPECT_TRUE(sink.log(LogLevel::Info, "First %d", 1));
+    VirtualClock::advance(250ms);
+    EXPECT_TRUE(sink.log(LogLevel::Warning, "Second"));
+
+    EXPECT_EQ(messagesSince(sink, 0, range), (std::vector<std::string>{"First 1", "Second"}));
+    EXPECT_EQ(range.lastSequence, 2u);
+    EXPECT_EQ(range.missedRecords, 0u);
+
+    EXPECT_TRUE(sink.log(LogLevel::Error, "Third"));
+    EXPECT_EQ(messagesSince(sink, range.lastSequence, range), std::vector<std::string>{"Third"});
+    EXPECT_EQ(range.lastSequence, 3u);
+
+    EXPECT_TRUE(messagesSince(sink, range.lastSequence, range).empty());
+    EXPECT_EQ(range.lastSequence, 3u);
+
+    sink.forEachRecordSince(1, [](const SmallSink::RecordType &record) {
+        EXPECT_EQ(record.sequence, 2u);
+        EXPECT_EQ(record.level, LogLevel::Warning);
+        EXPECT_EQ(record.uptimeMs, 250u);
+        return false;
+    });
+}
+
+TEST(MemoryLogSink, ReportsOverwrittenRecords) {
+    SmallSink sink;
+    RecentLogRange range{};
+
+    for (int i = 1; i <= 10; ++i) {
+        EXPECT_TRUE(sink.log(LogLevel::Info, "Record %d", i));
+    }
+
+    EXPECT_EQ(messagesSince(sink, 3, range),
+              (std::vector<std::string>{"Record 7", "Record 8", "Record 9", "Record 10"}));
+    EXPECT_EQ(range.missedRecords, 3u);
+    EXPECT_EQ(range.lastSequence, 10u);
+
+    // Truncated to the message size
+    EXPECT_TRUE(sink.log(LogLevel::Info, "A message longer than sixteen characters"));
+    EXPECT_EQ(messagesSince(sink, 10, range), std::vector<std::string>{"A message longe"});
+
+    // A sequence number from before a restart starts from the beginning
+    EXPECT_EQ(messagesSince(sink, 1000, range).size(), 4u);
+    EXPECT_EQ(range.lastSequence, 11u);
+}
+
+TEST(MemoryLogSink, StopsWhenTheVisitorIsFull) {
+    SmallSink sink;
+
+    for (int i = 1; i <= 3; ++i) {
+        EXPECT_TRUE(sink.log(LogLevel::Info, "Record %d", i));
+    }
+
+    size_t visited = 0;
+    const auto range = sink.forEachRecordSince(0, [&visited](const SmallSink::RecordType &) {
+        return ++visited < 2;
+    });
+
+    // The second record wasn't taken, so it is fetched again with the next call
+    EXPECT_EQ(range.lastSequence, 1u);
+}
+
+TEST(MemoryLogSink, IsReachableThroughTheLogger) {
+    using RecentSink = MemoryLogSink<8>;
+    using TestLogger = ApplicationLogger<QuietBackend, LogLevel::Debug, RecentSink>;
+
+    EXPECT_TRUE(TestLogger::log(LogLevel::Info, "Pump %d started", 2));
+    EXPECT_EQ(TestLogger::sink<RecentSink>().lastSequence(), 1u);
+
+    TestLogger::enableAsync(LogOverflowPolicy::dropNew, LogEncoding::binary);
+    EXPECT_TRUE(TestLogger::log(LogLevel::Info, "Pump %d stopped", 2));
+    EXPECT_EQ(TestLogger::drain(), 1u);
+
+    std::vector<std::string> messages;
+    TestLogger::sink<RecentSink>().forEachRecordSince(0, [&messages](const RecentSink::RecordType &record) {
+        messages.emplace_back(record.message.data());
+        return true;
+    });
+    EXPECT_EQ(messages, (std::vector<std::string>{"Pump 2 started", "Pump 2 stopped"}));
+}
@@ -0,0 +1,95 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+#include "utils/request_arena.h"
+
+namespace {
+    struct Argument {
+        int index = 0;
+        double value = 0.0;
+    };
+}
+
+TEST(RequestArena, AllocatesAlignedMemoryInOrder) {
+    alignas(std::max_align_t) std::array<char, 256> memory{};
+    RequestArena arena(memory.data(), memory.size());
+
+    auto *first = static_cast<char *>(arena.allocate(3, 1));
+    auto *second = arena.create<Argument>(Argument{ .index = 4, .value = 2.5 });
+
+    ASSERT_NE(first, nullptr);
+    ASSERT_NE(second, nullptr);
+    EXPECT_EQ(first, memory.data());
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(second) % alignof(Argument), 0u);
+    EXPECT_GT(reinterpret_cast<char *>(second), first);
+    EXPECT_EQ(second->index, 4);
+    EXPECT_EQ(arena.used(), static_cast<size_t>(reinterpret_cast<char *>(second + 1) - memory.data()));
+    EXPECT_EQ(arena.used() + arena.remaining(), arena.capacity());
+}
+
+TEST(RequestArena, FailsWhenTheRequestDoesntFit) {
+    std::array<char, 64> memory{};
+    RequestArena arena(memory.data(), memory.size());
+
+    EXPECT_EQ(arena.allocate(65, 1), nullptr);
+    EXPECT_TRUE(arena.allocateArray<uint32_t>(17).empty());
+    EXPECT_TRUE(arena.allocateArray<char>(SIZE_MAX).empty());
+    EXPECT_EQ(arena.used(), 0u);
+
+    EXPECT_EQ(arena.allocateArray<char>(60).size(), 60u);
+    EXPECT_EQ(arena.copyString("too long").data(), nullptr);
+    EXPECT_EQ(arena.remaining(), 4u);
+}
+
+TEST(RequestArena, CopiesZeroTerminatedStrings) {
+    std::array<char, 64> memory{};
+    memory.fill('x');
+    RequestArena arena(memory.data(), memory.size());
+    const char uri[] = "/api/v1/devices/3";
+
+    auto copy = arena.copyString(std::string_view(uri).substr(8, 7));
+
+    EXPECT_EQ(copy, "devices");
+    EXPECT_EQ(copy.data()[copy.size()], '\0');
+    EXPECT_EQ(arena.used(), 8u);
+}
+
+TEST(RequestArena, HandsOutTheRestAndIsReleasedAtOnce) {
+    std::array<char, 128> memory{};
+    RequestArena arena(memory.data(), memory.size());
+
+    ASSERT_FALSE(arena.allocateArray<char>(32).empty());
+    auto answer = arena.allocateRemaining();
+
+    EXPECT_EQ(answer.size(), 96u);
+    EXPECT_EQ(answer.data(), memory.data() + 32);
+    EXPECT_EQ(arena.remaining(), 0u);
+    EXPECT_EQ(arena.allocate(1, 1), nullptr);
+
+    arena.reset();
+    EXPECT_EQ(arena.remaining(), memory.size());
+    EXPECT_EQ(arena.allocateArray<char>(8).data(), memory.data());
+}
+
+TEST(RequestArena, ScopesSetTheCurrentArenaOfTheThread) {
+    std::array<char, 32> outerMemory{};
+    std::array<char, 32> innerMemory{};
+    RequestArena outer(outerMemory.data(), outerMemory.size());
+    RequestArena inner(innerMemory.data(), innerMemory.size());
+
+    EXPECT_EQ(RequestArena::current(), nullptr);
+    {
+        RequestArenaScope outerScope(outer);
+        EXPECT_EQ(RequestArena::current(), &outer);
+        {
+            RequestArenaScope innerScope(inner);
+            EXPECT_EQ(RequestArena::current(), &inner);
+        }
+        EXPECT_EQ(RequestArena::current(), &outer);
+    }
+    EXPECT_EQ(RequestArena::current(), nullptr);
+}
@@ -4,6 +4,13 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <array>
+#include <numeric>
+#include <ranges>
+#include <string>
+#include <vector>
+
 TEST(RingBuffer, Basic) {
     RingBuffer<int, 10> rb;
     for (size_t i = 0; i < 10; ++i) {
@@ -116,8 +123,8 @@ TEST(RingBuffer, TakeBack) {
     EXPECT_EQ(rb.size(), 3);
 
     // Take all remaining elements
-    rb.takeBack();
-    rb.takeBack();
+    EXPECT_EQ(rb.takeBack(), 3);
+    EXPECT_EQ(rb.takeBack(), 2);
     value = rb.takeBack();
     EXPECT_TRUE(value.has_value());
     EXPECT_EQ(value.value(), 1);
@@ -150,8 +157,8 @@ TEST(RingBuffer, TakeFront) {
     EXPECT_EQ(rb.size(), 3);
 
     // Take all remaining elements
-    rb.takeFront();
-    rb.takeFront();
+    EXPECT_EQ(rb.takeFront(), 3);
+    EXPECT_EQ(rb.takeFront(), 4);
     value = rb.takeFront();
     EXPECT_TRUE(value.has_value());
     EXPECT_EQ(value.value(), 5);
@@ -194,4 +201,90 @@ TEST(RingBuffer, MixedOperations) {
 
     rb.removeFront();
     EXPECT_EQ(rb.front(), 4);
-}
\ No newline at end of file
+}
+
+TEST(RingBuffer, RandomAccessIterator) {
+    static_assert(std::random_access_iterator<RingBuffer<int, 5>::iterator>);
+    static_assert(std::random_access_iterator<RingBuffer<int, 5>::const_iterator>);
+    static_assert(std::ranges::random_access_range<const RingBuffer<int, 5>>);
+
+    RingBuffer<int, 5> rb;
+    EXPECT_EQ(rb.begin(), rb.end());
+
+    for (int i = 1; i <= 7; ++i) {
+        rb.append(i);
+    }
+
+    // The buffer wrapped around, iteration still starts with the oldest value
+    EXPECT_EQ(std::vector<int>(rb.begin(), rb.end()), (std::vector<int>{3, 4, 5, 6, 7}));
+    EXPECT_EQ(rb.end() - rb.begin(), 5);
+    EXPECT_EQ(rb.begin()[4], 7);
+    EXPECT_EQ(*(rb.end() - 2), 6);
+    EXPECT_TRUE(std::ranges::is_sorted(rb));
+    EXPECT_EQ(*std::ranges::lower_bound(rb, 5), 5);
+
+    std::ranges::fill(rb, 1);
+    EXPECT_EQ(std::accumulate(rb.cbegin(), rb.cend(), 0), 5);
+}
+
+TEST(RingBuffer, ContiguousSpans) {
+    RingBuffer<int, 5> rb;
+    EXPECT_TRUE(rb.asSpans()[0].empty());
+
+    rb.append(1);
+    rb.append(2);
+    EXPECT_EQ(rb.asSpans()[0].size(), 2u);
+    EXPECT_TRUE(rb.asSpans()[1].empty());
+
+    for (int i = 3; i <= 8; ++i) {
+        rb.append(i);
+    }
+
+    const auto &constRb = rb;
+    const auto spans = constRb.asSpans();
+    std::vector<int> joined(spans[0].begin(), spans[0].end());
+    joined.insert(joined.end(), spans[1].begin(), spans[1].end());
+
+    EXPECT_EQ(joined, (std::vector<int>{4, 5, 6, 7, 8}));
+    EXPECT_FALSE(spans[1].empty());
+}
+
+TEST(RingBuffer, BulkAppendAndCopyOut) {
+    RingBuffer<int, 5> rb;
+    const std::array<int, 3> first{1, 2, 3};
+    const std::array<int, 4> second{4, 5, 6, 7};
+    const std::array<int, 7> tooMany{10, 11, 12, 13, 14, 15, 16};
+
+    rb.append(first);
+    rb.append(second);
+    EXPECT_EQ(rb.size(), 5);
+    EXPECT_EQ(std::vector<int>(rb.begin(), rb.end()), (std::vector<int>{3, 4, 5, 6, 7}));
+
+    std::array<int, 5> out{};
+    EXPECT_EQ(rb.copyOut(out), 5u);
+    EXPECT_EQ(out, (std::array<int, 5>{3, 4, 5, 6, 7}));
+
+    std::array<int, 2> shortOut{};
+    EXPECT_EQ(rb.copyOut(shortOut), 2u);
+    EXPECT_EQ(shortOut, (std::array<int, 2>{3, 4}));
+
+    rb.append(tooMany);
+    EXPECT_EQ(std::vector<int>(rb.begin(), rb.end()), (std::vector<int>{12, 13, 14, 15, 16}));
+
+    rb.removeFront();
+    rb.append(std::span<const int>(first.data(), 1));
+    EXPECT_EQ(rb.back(), 1);
+    EXPECT_EQ(rb.front(), 13);
+}
+
+TEST(RingBuffer, BulkAppendOfNonTrivialValues) {
+    RingBuffer<std::string, 3> rb;
+    const std::array<std::string, 2> values{"a", "b"};
+
+    rb.append(values);
+    rb.append(values);
+
+    std::array<std::string, 3> out{};
+    EXPECT_EQ(rb.copyOut(out), 3u);
+    EXPECT_EQ(out, (std::array<std::string, 3>{"b", "a", "b"}));
+}
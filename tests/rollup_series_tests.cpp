@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <vector>
+
+#include "utils/container/rollup_series.h"
+#include "utils/time/virtual_clock.h"
+
+namespace {
+    using namespace std::chrono_literals;
+
+    constexpr RollupSeriesConfig smallSeries{
+        .numMinuteBuckets = 10,
+        .numFifteenMinuteBuckets = 8,
+        .numHourBuckets = 6
+    };
+
+    using TestSeries = RollupSeries<float, smallSeries, VirtualClock>;
+
+    template<typename SeriesType>
+    std::vector<typename SeriesType::BucketType> bucketsOf(const SeriesType &series, std::chrono::seconds window,
+                                                           RollupResolution &resolution) {
+        std::vector<typename SeriesType::BucketType> buckets;
+        resolution = series.forEachBucket(window, [&buckets](const auto &currentBucket) {
+            buckets.push_back(currentBucket);
+        });
+        return buckets;
+    }
+
+    class RollupSeriesTest : public ::testing::Test {
+    protected:
+        void SetUp() override {
+            VirtualClock::reset();
+        }
+    };
+}
+
+TEST_F(RollupSeriesTest, AggregatesSamplesPerMinute) {
+    TestSeries series;
+
+    series.put(4.0f);
+    VirtualClock::advance(20s);
+    series.put(1.0f);
+    VirtualClock::advance(20s);
+    series.put(7.0f);
+    VirtualClock::advance(30s);
+    series.put(10.0f);
+
+    RollupResolution resolution{};
+    const auto buckets = bucketsOf(series, 5min, resolution);
+
+    EXPECT_EQ(resolution, RollupResolution::oneMinute);
+    ASSERT_EQ(buckets.size(), 2u);
+    EXPECT_EQ(buckets[0].count, 3u);
+    EXPECT_FLOAT_EQ(buckets[0].min, 1.0f);
+    EXPECT_FLOAT_EQ(buckets[0].max, 7.0f);
+    EXPECT_FLOAT_EQ(buckets[0].mean, 4.0f);
+    EXPECT_EQ(buckets[1].count, 1u);
+    EXPECT_EQ(buckets[1].start - buckets[0].start, 1min);
+}
+
+TEST_F(RollupSeriesTest, PicksTheResolutionForTheWindow) {
+    EXPECT_EQ(TestSeries::resolutionFor(10min), RollupResolution::oneMinute);
+    EXPECT_EQ(TestSeries::resolutionFor(11min), RollupResolution::fifteenMinutes);
+    EXPECT_EQ(TestSeries::resolutionFor(2h), RollupResolution::fifteenMinutes);
+    EXPECT_EQ(TestSeries::resolutionFor(3h), RollupResolution::oneHour);
+    EXPECT_EQ(TestSeries::resolutionFor(24h * 7), RollupResolution::oneHour);
+}
+
+TEST_F(RollupSeriesTest, KeepsOnlyTheLastBucketsOfEveryResolution) {
+    TestSeries series;
+
+    // One sample every minute for ten hours, the value is the minute
+    for (int minute = 0; minute < 600; ++minute) {
+        series.put(static_cast<float>(minute));
+        VirtualClock::advance(1min);
+    }
+
+    RollupResolution resolution{};
+    auto minutes = bucketsOf(series, 10min, resolution);
+    ASSERT_EQ(minutes.size(), 10u);
+    EXPECT_FLOAT_EQ(minutes.front().min, 590.0f);
+    EXPECT_FLOAT_EQ(minutes.back().max, 599.0f);
+
+    auto quarters = bucketsOf(series, 2h, resolution);
+    EXPECT_EQ(resolution, RollupResolution::fifteenMinutes);
+    ASSERT_EQ(quarters.size(), 8u);
+    EXPECT_EQ(quarters.back().count, 15u);
+    EXPECT_FLOAT_EQ(quarters.back().mean, 592.0f);
+
+    // Only six closed buckets and the open one are kept, the window asks for more
+    auto hours = bucketsOf(series, 24h, resolution);
+    EXPECT_EQ(resolution, RollupResolution::oneHour);
+    ASSERT_EQ(hours.size(), 7u);
+    EXPECT_FLOAT_EQ(hours.front().min, 180.0f);
+    EXPECT_FLOAT_EQ(hours.back().max, 599.0f);
+    EXPECT_EQ(hours.back().count, 60u);
+}
+
+TEST_F(RollupSeriesTest, SkipsIntervalsWithoutSamples) {
+    TestSeries series;
+
+    series.put(1.0f);
+    VirtualClock::advance(5min);
+    series.put(2.0f);
+
+    RollupResolution resolution{};
+    const auto buckets = bucketsOf(series, 10min, resolution);
+
+    ASSERT_EQ(buckets.size(), 2u);
+    EXPECT_EQ(buckets[1].start - buckets[0].start, 5min);
+    EXPECT_TRUE(bucketsOf(TestSeries{}, 10min, resolution).empty());
+}
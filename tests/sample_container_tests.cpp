@@ -1,7 +1,9 @@
 #include "utils/container/sample_container.h"
 
 #include <gtest/gtest.h>
+#include <atomic>
 #include <chrono>
+#include <thread>
 
 // Helper function to simulate sampling with time intervals
 template <typename T, typename AvgType, uint32_t NSamples>
@@ -114,8 +116,79 @@ TEST(SampleContainerTests, RingBufferOverwrite) {
     EXPECT_EQ(container.size(), 5);
     EXPECT_FLOAT_EQ(container.last(), 6.0f); // Last value should be the most recent
 }
+// Test 8: The running statistics only cover the samples in the window
+TEST(SampleContainerTests, SlidingWindowStatistics) {
+    constexpr uint32_t windowSize = 200;
+    SampleContainer<float, float, windowSize> container(1000.0f);
+    std::vector<float> data;
+
+    for (int i = 0; i < 1000; ++i) {
+        data.push_back(7.0f + 0.25f * static_cast<float>((i * 37) % 11) - (i % 2 == 0 ? 1.0f : 0.0f));
+    }
+    simulateSampling(container, data, 2);
+
+    double mean = 0.0;
+    for (size_t i = data.size() - windowSize; i < data.size(); ++i) {
+        mean += data[i];
+    }
+    mean /= windowSize;
+
+    double squaredDifferences = 0.0;
+    for (size_t i = data.size() - windowSize; i < data.size(); ++i) {
+        squaredDifferences += (data[i] - mean) * (data[i] - mean);
+    }
+
+    ASSERT_EQ(container.size(), windowSize);
+    EXPECT_NEAR(container.average(), mean, 1e-4);
+    EXPECT_NEAR(container.variance(), squaredDifferences / (windowSize - 1), 1e-4);
+    EXPECT_NEAR(container.stdVariance(), std::sqrt(squaredDifferences / (windowSize - 1)), 1e-4);
+}
+
+// Test 9: Integral averages are rounded, the variance isn't
+TEST(SampleContainerTests, IntegralSlidingWindow) {
+    SampleContainer<int32_t, int32_t, 5> container(1000.0f);
+    std::vector<int32_t> data = {100, 101, 102, 103, 104, 110, 111};
+    simulateSampling(container, data, 1);
+
+    // The window holds 102, 103, 104, 110, 111
+    EXPECT_EQ(container.size(), 5);
+    EXPECT_EQ(container.average(), 106);
+    EXPECT_NEAR(container.variance(), 17.5f, 0.01f);
+}
+
+// Test 10: The aggregates are read without a lock, while samples are put
+TEST(SampleContainerTests, ConsistentAggregatesWhileWriting) {
+    SampleContainer<int32_t, int32_t, 5> container(1000.0f);
+    std::atomic_bool writing{true};
+    std::atomic<uint32_t> inconsistentReads{0};
+
+    // The window always holds the last five of the consecutive values, so the average is last - 2
+    std::thread reader([&container, &writing, &inconsistentReads]() {
+        while (writing.load()) {
+            const auto aggregates = container.aggregates();
+
+            if (aggregates.size == 5 && aggregates.average != aggregates.last - 2) {
+                inconsistentReads.fetch_add(1);
+            }
+        }
+    });
+
+    auto currentTime = std::chrono::steady_clock::now();
+    for (int32_t i = 0; i < 20000; ++i) {
+        currentTime += std::chrono::seconds(1);
+        container.putSample(i, currentTime);
+    }
+    writing = false;
+    reader.join();
+
+    EXPECT_EQ(inconsistentReads.load(), 0u);
+    EXPECT_EQ(container.last(), 19999);
+    EXPECT_EQ(container.average(), 19997);
+    EXPECT_NEAR(container.variance(), 2.5f, 0.01f);
+}
+
 // TODO: Empty container, how to handle this?
-// // Test 8: Empty container behavior
+// // Test 11: Empty container behavior
 // TEST(SampleContainerTests, EmptyContainer) {
 //     SampleContainer<float, float, 10> container;
 //
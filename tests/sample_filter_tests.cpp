@@ -0,0 +1,121 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <numeric>
+#include <optional>
+#include <random>
+#include <vector>
+
+#include "utils/container/order_statistic_window.h"
+#include "utils/container/sample_container.h"
+#include "utils/container/sample_filter.h"
+
+TEST(OrderStatisticWindow, MatchesTheSortedWindow) {
+    OrderStatisticWindow<int32_t, 31> window;
+    std::deque<int32_t> reference;
+    std::mt19937 generator(7);
+    std::uniform_int_distribution<int32_t> values(-50, 50);
+
+    for (int i = 0; i < 2000; ++i) {
+        const auto value = values(generator);
+        window.push(value);
+        reference.push_back(value);
+
+        if (reference.size() > window.capacity()) {
+            reference.pop_front();
+        }
+
+        std::vector<int32_t> sorted(reference.begin(), reference.end());
+        std::sort(sorted.begin(), sorted.end());
+
+        ASSERT_EQ(window.size(), sorted.size());
+        const auto k = static_cast<size_t>(i) % sorted.size();
+        ASSERT_EQ(window.select(k), sorted[k]);
+        ASSERT_EQ(window.sumOfSmallest(k), std::accumulate(sorted.begin(), sorted.begin() + k, 0.0));
+        ASSERT_EQ(window.sumOfSmallest(sorted.size()), std::accumulate(sorted.begin(), sorted.end(), 0.0));
+    }
+}
+
+TEST(OrderStatisticWindow, InterpolatesQuantiles) {
+    OrderStatisticWindow<float, 8> window;
+
+    for (float value : {4.0f, 1.0f, 3.0f, 2.0f}) {
+        window.push(value);
+    }
+
+    EXPECT_DOUBLE_EQ(window.median(), 2.5);
+    EXPECT_DOUBLE_EQ(window.quantile(0.0), 1.0);
+    EXPECT_DOUBLE_EQ(window.quantile(1.0), 4.0);
+    EXPECT_DOUBLE_EQ(window.quantile(0.25), 1.75);
+}
+
+TEST(SampleFilter, MedianRemovesSingleSpikes) {
+    SampleFilter<float, 5> filter(SampleFilterSettings{ .kind = SampleFilterKind::median });
+    std::vector<float> filtered;
+
+    for (float value : {10.0f, 10.0f, 10.0f, 50.0f, 10.0f, 10.0f}) {
+        const auto result = filter.filter(value);
+        ASSERT_TRUE(result.has_value());
+        filtered.push_back(*result);
+    }
+
+    EXPECT_FLOAT_EQ(*std::max_element(filtered.begin(), filtered.end()), 10.0f);
+}
+
+TEST(SampleFilter, HampelDropsOutliersButFollowsSteps) {
+    SampleFilter<float, 9> filter(SampleFilterSettings{ .kind = SampleFilterKind::hampel, .hampelThreshold = 3.0f });
+    const std::vector<float> noise = {7.00f, 7.02f, 6.98f, 7.01f, 6.99f, 7.03f, 6.97f, 7.00f, 7.02f};
+
+    for (float value : noise) {
+        EXPECT_TRUE(filter.filter(value).has_value());
+    }
+
+    EXPECT_FALSE(filter.filter(9.5f).has_value());
+    EXPECT_TRUE(filter.filter(7.01f).has_value());
+
+    // After a real step, the new level is accepted, once it fills half of the window
+    size_t accepted = 0;
+    for (int i = 0; i < 9; ++i) {
+        accepted += filter.filter(8.0f + 0.01f * static_cast<float>(i % 3)).has_value() ? 1 : 0;
+    }
+
+    EXPECT_GE(accepted, 4u);
+    EXPECT_TRUE(filter.filter(8.01f).has_value());
+}
+
+TEST(SampleFilter, TrimmedMeanIgnoresTheExtremes) {
+    SampleFilter<int32_t, 10> filter(SampleFilterSettings{ .kind = SampleFilterKind::trimmedMean, .trimFraction = 0.2f });
+    std::optional<int32_t> result;
+
+    for (int32_t value : {100, 102, 98, 101, 99, 5000, -4000, 100, 101, 99}) {
+        result = filter.filter(value);
+    }
+
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(*result, 100);
+
+    // A single sample isn't trimmed away
+    SampleFilter<int32_t, 10> singleSample(SampleFilterSettings{ .kind = SampleFilterKind::trimmedMean });
+    EXPECT_EQ(singleSample.filter(3), std::optional<int32_t>(3));
+}
+
+TEST(SampleFilter, IsSelectedBySampleContainerSettings) {
+    SampleContainer<float, float, 9> container(SampleContainerSettings<float>{
+        .maxRateOfChange = 0.001f,
+        .filter = SampleFilterSettings{ .kind = SampleFilterKind::hampel }
+    });
+    auto currentTime = std::chrono::steady_clock::now();
+
+    // The rate of change would reject these, the hampel filter only drops the spike
+    for (float value : {7.0f, 7.1f, 6.9f, 7.05f, 6.95f, 7.0f, 7.1f, 6.9f, 7.0f}) {
+        currentTime += std::chrono::seconds(1);
+        EXPECT_TRUE(container.putSample(value, currentTime));
+    }
+
+    currentTime += std::chrono::seconds(1);
+    EXPECT_FALSE(container.putSample(12.0f, currentTime));
+    EXPECT_EQ(container.size(), 9u);
+    EXPECT_NEAR(container.average(), 7.0f, 0.05f);
+}
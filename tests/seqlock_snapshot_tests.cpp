@@ -0,0 +1,80 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "utils/container/seqlock_snapshot.h"
+
+namespace {
+    // Every field has the same value, so a torn read shows up as fields, which differ
+    struct Aggregates {
+        uint64_t first = 0;
+        uint32_t second = 0;
+        uint16_t third = 0;
+        double fourth = 0.0;
+    };
+
+    Aggregates makeAggregates(uint32_t value) {
+        return Aggregates{ .first = value, .second = value, .third = static_cast<uint16_t>(value),
+                           .fourth = static_cast<double>(value) };
+    }
+}
+
+TEST(SeqLockSnapshot, StartsWithTheInitialValue) {
+    SeqLockSnapshot<Aggregates> defaultSnapshot;
+    SeqLockSnapshot<Aggregates> snapshot(makeAggregates(3));
+
+    EXPECT_EQ(defaultSnapshot.load().first, 0u);
+    EXPECT_EQ(snapshot.load().second, 3u);
+    EXPECT_EQ(snapshot.load().fourth, 3.0);
+}
+
+TEST(SeqLockSnapshot, ReturnsTheLastStoredValue) {
+    SeqLockSnapshot<Aggregates> snapshot;
+
+    for (uint32_t i = 1; i <= 5; ++i) {
+        snapshot.store(makeAggregates(i));
+        const auto loaded = snapshot.load();
+
+        EXPECT_EQ(loaded.first, i);
+        EXPECT_EQ(loaded.third, i);
+    }
+}
+
+TEST(SeqLockSnapshot, ReadersNeverSeeTornValues) {
+    constexpr uint32_t numStores = 200000;
+    SeqLockSnapshot<Aggregates> snapshot;
+    std::atomic_bool writing{true};
+    std::atomic<uint32_t> tornReads{0};
+    std::vector<std::thread> readers;
+
+    for (int i = 0; i < 3; ++i) {
+        readers.emplace_back([&snapshot, &writing, &tornReads]() {
+            uint64_t lastSeen = 0;
+
+            while (writing.load()) {
+                const auto loaded = snapshot.load();
+
+                if (loaded.first != loaded.second || static_cast<uint16_t>(loaded.first) != loaded.third
+                    || static_cast<double>(loaded.first) != loaded.fourth || loaded.first < lastSeen) {
+                    tornReads.fetch_add(1);
+                }
+                lastSeen = loaded.first;
+            }
+        });
+    }
+
+    for (uint32_t i = 1; i <= numStores; ++i) {
+        snapshot.store(makeAggregates(i));
+    }
+    writing = false;
+
+    for (auto &currentReader : readers) {
+        currentReader.join();
+    }
+
+    EXPECT_EQ(tornReads.load(), 0u);
+    EXPECT_EQ(snapshot.load().first, numStores);
+}
@@ -0,0 +1,625 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <thread>
+#include <vector>
+
+#include "build_config.h"
+#include "utils/task_pool.h"
+#include "utils/time/virtual_clock.h"
+
+namespace {
+    template<typename PoolType>
+    class RunningPool {
+    public:
+        RunningPool() {
+            for (size_t i = 0; i < PoolType::numWorkers(); ++i) {
+                mThreads.emplace_back([this, i]() { pool.doWork(i); });
+            }
+        }
+
+        ~RunningPool() {
+            pool.requestStop();
+            for (auto &currentThread : mThreads) {
+                currentThread.join();
+            }
+        }
+
+        PoolType pool;
+    private:
+        std::vector<std::thread> mThreads;
+    };
+
+    void increment(void *counter) {
+        ++*static_cast<std::atomic_int *>(counter);
+    }
+
+    bool waitFor(auto condition, std::chrono::milliseconds timeout = std::chrono::milliseconds(2000)) {
+        const auto until = std::chrono::steady_clock::now() + timeout;
+        while (!condition()) {
+            if (std::chrono::steady_clock::now() > until) {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    }
+}
+
+TEST(TaskPool, ExecutesSingleShotTasksOnce) {
+    using PoolType = TaskPool<64u, 4u>;
+    RunningPool<PoolType> runningPool;
+    std::atomic_int counter = 0;
+    std::vector<PoolType::TaskResourceType> resources;
+
+    for (int i = 0; i < 32; ++i) {
+        resources.emplace_back(runningPool.pool.postTask(TaskDescription{
+            .single_shot = true,
+            .func_ptr = increment,
+            .interval = std::chrono::milliseconds(i % 4),
+            .argument = &counter,
+            .description = "Single shot",
+            .last_executed = std::chrono::steady_clock::now()
+        }));
+        EXPECT_TRUE(resources.back().isActive());
+    }
+
+    EXPECT_TRUE(waitFor([&counter]() { return counter == 32; }));
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_EQ(counter, 32);
+}
+
+TEST(TaskPool, RepeatsPeriodicTasksUntilRemoved) {
+    using PoolType = TaskPool<8u, 2u>;
+    RunningPool<PoolType> runningPool;
+    std::atomic_int counter = 0;
+
+    auto resource = runningPool.pool.postTask(TaskDescription{
+        .single_shot = false,
+        .func_ptr = increment,
+        .interval = std::chrono::milliseconds(2),
+        .argument = &counter,
+        .description = "Periodic",
+        .last_executed = std::chrono::steady_clock::now()
+    });
+
+    EXPECT_TRUE(waitFor([&counter]() { return counter >= 5; }));
+
+    resource.invalidate();
+    EXPECT_FALSE(resource.isActive());
+
+    // A run, which already started, may still finish
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    const int countAfterRemoval = counter;
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_EQ(counter, countAfterRemoval);
+}
+
+TEST(TaskPool, ExecutesCapturingLambdas) {
+    using PoolType = TaskPool<8u, 2u>;
+    RunningPool<PoolType> runningPool;
+    std::atomic_int counter = 0;
+    const int step = 3;
+
+    auto resource = runningPool.pool.postTask(TaskDescription{
+        .single_shot = false,
+        .interval = std::chrono::milliseconds(2),
+        .description = "Lambda",
+        .last_executed = std::chrono::steady_clock::now(),
+        .function = [&counter, step]() { counter += step; }
+    });
+
+    EXPECT_TRUE(waitFor([&counter]() { return counter >= 15; }));
+    EXPECT_EQ(counter % step, 0);
+}
+
+TEST(TaskPool, RemovedTaskIsNotExecuted) {
+    using PoolType = TaskPool<8u, 2u>;
+    RunningPool<PoolType> runningPool;
+    std::atomic_int counter = 0;
+
+    {
+        auto resource = runningPool.pool.postTask(TaskDescription{
+            .single_shot = true,
+            .func_ptr = increment,
+            .interval = std::chrono::milliseconds(20),
+            .argument = &counter,
+            .description = "Removed before execution",
+            .last_executed = std::chrono::steady_clock::now()
+        });
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(40));
+    EXPECT_EQ(counter, 0);
+}
+
+TEST(TaskPool, SkipsRemovedTasksWaitingForAWorker) {
+    using PoolType = TaskPool<2u, 1u>;
+    PoolType pool;
+    std::atomic_int counter = 0;
+    const auto past = std::chrono::steady_clock::now() - std::chrono::seconds(1);
+    PoolType::TaskResourceType removed;
+
+    // Both are dispatched with the same wakeup, so the second one waits in the deque, while the first one removes it
+    auto remover = pool.postTask(TaskDescription{ .interval = std::chrono::milliseconds(0), .last_executed = past,
+        .priority = TaskPriority::control, .function = [&removed]() { removed.invalidate(); } });
+    removed = pool.postTask(TaskDescription{ .func_ptr = increment, .interval = std::chrono::milliseconds(0),
+        .argument = &counter, .last_executed = past + std::chrono::milliseconds(1), .priority = TaskPriority::control });
+
+    std::thread worker([&pool]() { pool.doWork(0); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+    // Both slots were freed
+    auto first = pool.postTask(TaskDescription{ .func_ptr = increment, .interval = std::chrono::milliseconds(0),
+        .argument = &counter, .last_executed = past });
+    auto second = pool.postTask(TaskDescription{ .func_ptr = increment, .interval = std::chrono::milliseconds(0),
+        .argument = &counter, .last_executed = past });
+    EXPECT_TRUE(first.isActive());
+    EXPECT_TRUE(second.isActive());
+    EXPECT_TRUE(waitFor([&counter]() { return counter == 2; }));
+
+    pool.requestStop();
+    worker.join();
+    EXPECT_EQ(counter, 2);
+}
+
+template<typename PoolType>
+struct TaskPoolTestAccess {
+    static constexpr size_t submissionQueueSize = PoolType::submissionQueueSize;
+
+    static void submitStaleRemove(PoolType &pool) {
+        pool.submit(typename PoolType::Command{ .type = PoolType::CommandType::remove, .slot = 0,
+            .id = makeTaskId(std::numeric_limits<uint32_t>::max() - 1, 0) });
+    }
+};
+
+TEST(TaskPool, AppliesQueuedPostsBeforeAnOverflowingRemove) {
+    using PoolType = TaskPool<2u, 1u>;
+    using Access = TaskPoolTestAccess<PoolType>;
+    PoolType pool;
+
+    for (size_t i = 0; i + 1 < Access::submissionQueueSize; ++i) {
+        Access::submitStaleRemove(pool);
+    }
+
+    // The post takes the last place in the queue, so the remove doesn't fit anymore
+    auto removed = pool.postTask(TaskDescription{ .description = "Removed right away" });
+    ASSERT_TRUE(removed.isActive());
+    removed.invalidate();
+
+    // Both slots are free again
+    auto first = pool.postTask(TaskDescription{ .description = "First" });
+    auto second = pool.postTask(TaskDescription{ .description = "Second" });
+    EXPECT_TRUE(first.isActive());
+    EXPECT_TRUE(second.isActive());
+}
+
+TEST(TaskPool, StopsVisitingMetricsOnceTheVisitorIsFull) {
+    TaskPool<4u, 1u> pool;
+    std::array<TaskPool<4u, 1u>::TaskResourceType, 4> tasks;
+
+    for (auto &currentTask : tasks) {
+        currentTask = pool.postTask(TaskDescription{ .description = "Task" });
+    }
+
+    // Like an answer buffer, which only takes two records
+    std::vector<TaskId> printed;
+    pool.forEachTaskMetrics([&printed](const TaskMetrics &metrics) {
+        if (printed.size() == 2) {
+            return false;
+        }
+
+        printed.push_back(metrics.id);
+        return true;
+    });
+
+    ASSERT_EQ(printed.size(), 2u);
+    EXPECT_EQ(printed[0], tasks[0].id());
+    EXPECT_EQ(printed[1], tasks[1].id());
+}
+
+TEST(TaskPool, RejectsTasksWhenFull) {
+    TaskPool<2u, 1u> pool;
+
+    auto first = pool.postTask(TaskDescription{ .description = "First" });
+    auto second = pool.postTask(TaskDescription{ .description = "Second" });
+    auto third = pool.postTask(TaskDescription{ .description = "Third" });
+
+    EXPECT_TRUE(first.isActive());
+    EXPECT_TRUE(second.isActive());
+    EXPECT_FALSE(third.isActive());
+
+    auto staleId = first.id();
+    first.invalidate();
+    auto fourth = pool.postTask(TaskDescription{ .description = "Fourth" });
+    EXPECT_TRUE(fourth.isActive());
+
+    // The stale id of the first task must not remove the new task in the same slot
+    EXPECT_FALSE(pool.removeTask(staleId));
+    EXPECT_TRUE(fourth.isActive());
+}
+
+namespace {
+    struct OrderRecorder {
+        std::mutex orderMutex;
+        std::vector<int> order;
+    };
+
+    struct RecordedTask {
+        OrderRecorder *recorder;
+        int value;
+    };
+
+    void recordOrder(void *argument) {
+        auto *task = static_cast<RecordedTask *>(argument);
+        std::unique_lock guard{task->recorder->orderMutex};
+        task->recorder->order.push_back(task->value);
+    }
+
+    void blockFor50ms(void *) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+}
+
+TEST(TaskPool, DispatchesHigherPrioritiesFirst) {
+    using PoolType = TaskPool<8u, 1u>;
+    PoolType pool;
+    OrderRecorder recorder;
+    RecordedTask housekeeping{&recorder, 2};
+    RecordedTask sensing{&recorder, 1};
+    RecordedTask control{&recorder, 0};
+    RecordedTask laterControl{&recorder, 3};
+    const auto past = std::chrono::steady_clock::now() - std::chrono::seconds(1);
+
+    auto first = pool.postTask(TaskDescription{ .func_ptr = recordOrder, .interval = std::chrono::milliseconds(0),
+        .argument = &housekeeping, .last_executed = past, .priority = TaskPriority::housekeeping });
+    auto second = pool.postTask(TaskDescription{ .func_ptr = recordOrder, .interval = std::chrono::milliseconds(10),
+        .argument = &laterControl, .last_executed = past, .priority = TaskPriority::control });
+    auto third = pool.postTask(TaskDescription{ .func_ptr = recordOrder, .interval = std::chrono::milliseconds(0),
+        .argument = &sensing, .last_executed = past, .priority = TaskPriority::sensing });
+    auto fourth = pool.postTask(TaskDescription{ .func_ptr = recordOrder, .interval = std::chrono::milliseconds(0),
+        .argument = &control, .last_executed = past, .priority = TaskPriority::control });
+
+    std::thread worker([&pool]() { pool.doWork(0); });
+    EXPECT_TRUE(waitFor([&recorder]() {
+        std::unique_lock guard{recorder.orderMutex};
+        return recorder.order.size() == 4;
+    }));
+    pool.requestStop();
+    worker.join();
+
+    EXPECT_EQ(recorder.order, (std::vector<int>{0, 3, 1, 2}));
+    EXPECT_EQ(pool.latenessOf(TaskPriority::control).runs, 2);
+    EXPECT_EQ(pool.latenessOf(TaskPriority::sensing).runs, 1);
+    EXPECT_EQ(pool.latenessOf(TaskPriority::housekeeping).deadlineMisses, 0);
+    EXPECT_EQ(pool.latenessOf(TaskPriority::sensing).deadlineMisses, 1);
+}
+
+TEST(TaskPool, KeepsAWorkerForControlTasks) {
+    using PoolType = TaskPool<16u, 2u>;
+    RunningPool<PoolType> runningPool;
+    std::atomic_int counter = 0;
+    std::vector<PoolType::TaskResourceType> resources;
+    const auto now = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < 4; ++i) {
+        resources.emplace_back(runningPool.pool.postTask(TaskDescription{
+            .func_ptr = blockFor50ms, .interval = std::chrono::milliseconds(0),
+            .description = "Slow stats", .last_executed = now, .priority = TaskPriority::housekeeping }));
+    }
+
+    resources.emplace_back(runningPool.pool.postTask(TaskDescription{
+        .func_ptr = increment, .interval = std::chrono::milliseconds(5), .argument = &counter,
+        .description = "Switch", .last_executed = now, .priority = TaskPriority::control }));
+
+    EXPECT_TRUE(waitFor([&counter]() { return counter == 1; }));
+    EXPECT_EQ(runningPool.pool.latenessOf(TaskPriority::control).deadlineMisses, 0);
+    EXPECT_LT(runningPool.pool.latenessOf(TaskPriority::control).maxLateness, std::chrono::milliseconds(40));
+    EXPECT_LE(runningPool.pool.latenessOf(TaskPriority::housekeeping).runs, 2);
+}
+
+TEST(TaskPool, PostsAndRemovesFromManyThreads) {
+    using PoolType = TaskPool<64u, 2u>;
+    constexpr int numProducers = 4;
+    constexpr int tasksPerProducer = 200;
+    RunningPool<PoolType> runningPool;
+    std::array<std::atomic_int, numProducers> counters{};
+    std::vector<std::thread> producers;
+
+    for (int producer = 0; producer < numProducers; ++producer) {
+        producers.emplace_back([&runningPool, &counter = counters[producer]]() {
+            for (int i = 0; i < tasksPerProducer; ++i) {
+                auto singleShot = runningPool.pool.postTask(TaskDescription{ .single_shot = true, .func_ptr = increment,
+                    .interval = std::chrono::milliseconds(0), .argument = &counter, .description = "Single shot",
+                    .last_executed = std::chrono::steady_clock::now() });
+                EXPECT_TRUE(singleShot.isActive());
+
+                // Removed before it is due
+                auto removed = runningPool.pool.postTask(TaskDescription{ .func_ptr = increment,
+                    .interval = std::chrono::milliseconds(500), .argument = &counter, .description = "Removed",
+                    .last_executed = std::chrono::steady_clock::now() });
+                EXPECT_TRUE(removed.isActive());
+                removed.invalidate();
+
+                EXPECT_TRUE(waitFor([&counter, i]() { return counter == i + 1; }));
+            }
+        });
+    }
+
+    for (auto &currentProducer : producers) {
+        currentProducer.join();
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    for (const auto &counter : counters) {
+        EXPECT_EQ(counter, tasksPerProducer);
+    }
+}
+
+TEST(TaskPool, KeepsMetricsPerTask) {
+    using PoolType = TaskPool<8u, 1u>;
+    PoolType pool;
+    std::atomic_int counter = 0;
+    const auto past = std::chrono::steady_clock::now() - std::chrono::milliseconds(100);
+
+    auto slow = pool.postTask(TaskDescription{ .single_shot = false, .func_ptr = blockFor50ms,
+        .interval = std::chrono::milliseconds(20), .description = "Slow", .last_executed = past,
+        .priority = TaskPriority::housekeeping });
+    auto fast = pool.postTask(TaskDescription{ .single_shot = false, .func_ptr = increment,
+        .interval = std::chrono::milliseconds(20), .argument = &counter, .description = "Fast", .last_executed = past });
+
+    ASSERT_TRUE(pool.metricsOf(slow.id()).has_value());
+    EXPECT_EQ(pool.metricsOf(slow.id())->runs, 0);
+
+    std::thread worker([&pool]() { pool.doWork(0); });
+    EXPECT_TRUE(waitFor([&pool, &slow]() { return pool.metricsOf(slow.id())->runs >= 2; }));
+    pool.requestStop();
+    worker.join();
+
+    const auto slowMetrics = *pool.metricsOf(slow.id());
+    EXPECT_STREQ(slowMetrics.description, "Slow");
+    EXPECT_EQ(slowMetrics.priority, TaskPriority::housekeeping);
+    EXPECT_GE(slowMetrics.lastExecutionTime, std::chrono::milliseconds(50));
+    EXPECT_GE(slowMetrics.maxExecutionTime, slowMetrics.averageExecutionTime);
+    EXPECT_EQ(slowMetrics.overruns, slowMetrics.runs);
+    EXPECT_EQ(slowMetrics.executionTimeHistogram[executionHistogramBucketOf(std::chrono::milliseconds(50))],
+              slowMetrics.runs);
+    // The first run started 80ms after it was due
+    EXPECT_GE(slowMetrics.maxLateness, std::chrono::milliseconds(80));
+
+    const auto fastMetrics = *pool.metricsOf(fast.id());
+    EXPECT_EQ(fastMetrics.runs, static_cast<uint32_t>(counter));
+    EXPECT_EQ(fastMetrics.overruns, 0);
+    EXPECT_EQ(fastMetrics.executionTimeHistogram[0], fastMetrics.runs);
+
+    size_t numVisited = 0;
+    pool.forEachTaskMetrics([&numVisited](const TaskMetrics &) { ++numVisited; return true; });
+    EXPECT_EQ(numVisited, 2);
+
+    auto staleId = fast.id();
+    fast.invalidate();
+    EXPECT_FALSE(pool.metricsOf(staleId).has_value());
+}
+
+namespace {
+    using SimulatedPool = TaskPool<16u, 1u, VirtualClock>;
+
+    void stopPool(void *pool) {
+        static_cast<SimulatedPool *>(pool)->requestStop();
+    }
+
+    struct ScheduleTransitions {
+        SimulatedPool *pool;
+        SimulatedPool::TaskResourceType next;
+        int transitions = 0;
+    };
+
+    // Posts itself again for the next transition, like a schedule, which switches every six hours
+    void switchSchedule(void *argument) {
+        auto *schedule = static_cast<ScheduleTransitions *>(argument);
+        ++schedule->transitions;
+
+        schedule->next = schedule->pool->postTask(TaskDescription{ .single_shot = true, .func_ptr = switchSchedule,
+            .interval = std::chrono::hours(6), .argument = schedule, .description = "Schedule transition",
+            .last_executed = VirtualClock::now(), .priority = TaskPriority::control });
+    }
+}
+
+TEST(TaskPoolSimulation, ReplaysAWeekInVirtualTime) {
+    using namespace std::chrono;
+
+    VirtualClock::reset();
+    const auto start = VirtualClock::now();
+    SimulatedPool pool;
+    std::atomic_int deviceUpdates = 0;
+    std::atomic_int sensorReads = 0;
+    std::atomic_int statsRuns = 0;
+    ScheduleTransitions schedule{ .pool = &pool };
+
+    auto devices = pool.postTask(TaskDescription{ .single_shot = false, .func_ptr = increment,
+        .interval = seconds(5), .argument = &deviceUpdates, .description = "Device Updater",
+        .last_executed = start, .priority = TaskPriority::control });
+    auto sensors = pool.postTask(TaskDescription{ .single_shot = false, .func_ptr = increment,
+        .interval = seconds(10), .argument = &sensorReads, .description = "Reading from sensor",
+        .last_executed = start, .priority = TaskPriority::sensing });
+    auto stats = pool.postTask(TaskDescription{ .single_shot = false, .func_ptr = increment,
+        .interval = minutes(1), .argument = &statsRuns, .description = "Stats",
+        .last_executed = start, .priority = TaskPriority::housekeeping });
+    schedule.next = pool.postTask(TaskDescription{ .single_shot = true, .func_ptr = switchSchedule, .interval = hours(6),
+        .argument = &schedule, .description = "Schedule transition", .last_executed = start,
+        .priority = TaskPriority::control });
+    auto stop = pool.postTask(TaskDescription{ .single_shot = true, .func_ptr = stopPool,
+        .interval = days(7) + milliseconds(500), .argument = &pool, .description = "Stop",
+        .last_executed = start, .priority = TaskPriority::control });
+
+    pool.doWork(0);
+
+    EXPECT_EQ(VirtualClock::now() - start, days(7) + milliseconds(500));
+    EXPECT_EQ(deviceUpdates, days(7) / seconds(5));
+    EXPECT_EQ(sensorReads, days(7) / seconds(10));
+    EXPECT_EQ(statsRuns, days(7) / minutes(1));
+    EXPECT_EQ(schedule.transitions, days(7) / hours(6));
+
+    // Nothing is late, if the tasks take no time
+    EXPECT_EQ(pool.latenessOf(TaskPriority::control).maxLateness, microseconds(0));
+    EXPECT_EQ(pool.latenessOf(TaskPriority::sensing).maxLateness, microseconds(0));
+    EXPECT_EQ(pool.metricsOf(devices.id())->runs, static_cast<uint32_t>(deviceUpdates));
+}
+
+TEST(TaskPool, CalculatesNextExecutionPerCatchUpPolicy) {
+    using namespace std::chrono;
+
+    const steady_clock::time_point deadline{seconds(100)};
+    TaskDescription task{ .single_shot = false, .interval = seconds(10), .rate_mode = TaskRateMode::fixedRate };
+
+    // In time, the next deadline is one interval after the last one
+    auto reference = calculateNextExecutionReference(task, deadline, deadline + seconds(2));
+    EXPECT_EQ(reference.lastExecuted, deadline);
+    EXPECT_EQ(reference.skippedRuns, 0u);
+
+    // 25 seconds late, the deadlines at 110 and 120 passed
+    task.catch_up = TaskCatchUpPolicy::skipMissed;
+    reference = calculateNextExecutionReference(task, deadline, deadline + seconds(25));
+    EXPECT_EQ(reference.lastExecuted + task.interval, deadline + seconds(30));
+    EXPECT_EQ(reference.skippedRuns, 2u);
+
+    task.catch_up = TaskCatchUpPolicy::runOnce;
+    reference = calculateNextExecutionReference(task, deadline, deadline + seconds(25));
+    EXPECT_EQ(reference.lastExecuted + task.interval, deadline + seconds(20));
+    EXPECT_EQ(reference.skippedRuns, 1u);
+
+    task.catch_up = TaskCatchUpPolicy::burst;
+    reference = calculateNextExecutionReference(task, deadline, deadline + seconds(25));
+    EXPECT_EQ(reference.lastExecuted + task.interval, deadline + seconds(10));
+    EXPECT_EQ(reference.skippedRuns, 0u);
+
+    task.rate_mode = TaskRateMode::fixedDelay;
+    reference = calculateNextExecutionReference(task, deadline, deadline + seconds(25));
+    EXPECT_EQ(reference.lastExecuted, deadline + seconds(25));
+}
+
+namespace {
+    // Takes 800ms of virtual time
+    void slowUpdate(void *counter) {
+        VirtualClock::advance(std::chrono::milliseconds(800));
+        ++*static_cast<std::atomic_int *>(counter);
+    }
+
+    std::optional<TaskMetrics> simulateSlowUpdates(TaskRateMode rateMode, int &runs) {
+        using namespace std::chrono;
+
+        VirtualClock::reset();
+        const auto start = VirtualClock::now();
+        SimulatedPool pool;
+        std::atomic_int counter = 0;
+
+        auto updater = pool.postTask(TaskDescription{ .single_shot = false, .func_ptr = slowUpdate,
+            .interval = seconds(10), .argument = &counter, .description = "Device Updater", .last_executed = start,
+            .priority = TaskPriority::control, .rate_mode = rateMode });
+        auto stop = pool.postTask(TaskDescription{ .single_shot = true, .func_ptr = stopPool,
+            .interval = seconds(100) + milliseconds(500), .argument = &pool, .description = "Stop",
+            .last_executed = start, .priority = TaskPriority::control });
+
+        pool.doWork(0);
+
+        runs = counter;
+        return pool.metricsOf(updater.id());
+    }
+}
+
+TEST(TaskPoolSimulation, FixedRateTasksDontDrift) {
+    using namespace std::chrono;
+
+    int runs = 0;
+    const auto fixedDelay = simulateSlowUpdates(TaskRateMode::fixedDelay, runs);
+    ASSERT_TRUE(fixedDelay.has_value());
+    // Executed every 10.8 seconds
+    EXPECT_EQ(runs, 9);
+    EXPECT_EQ(fixedDelay->accumulatedDrift, milliseconds(800) * 9);
+
+    const auto fixedRate = simulateSlowUpdates(TaskRateMode::fixedRate, runs);
+    ASSERT_TRUE(fixedRate.has_value());
+    EXPECT_EQ(runs, 10);
+    EXPECT_EQ(fixedRate->accumulatedDrift, microseconds(0));
+    EXPECT_EQ(fixedRate->skippedRuns, 0u);
+}
+
+TEST(TaskPoolSimulation, FirstRunWithoutReferenceIsntLate) {
+    using namespace std::chrono;
+
+    // A day of uptime, the first run must not be counted against the start of the clock
+    VirtualClock::reset(VirtualClock::time_point(hours(24)));
+    const auto start = VirtualClock::now();
+    SimulatedPool pool;
+    std::atomic_int counter = 0;
+
+    auto updater = pool.postTask(TaskDescription{ .single_shot = false, .func_ptr = increment,
+        .interval = seconds(10), .argument = &counter, .description = "Device Updater",
+        .priority = TaskPriority::control, .rate_mode = TaskRateMode::fixedRate,
+        .catch_up = TaskCatchUpPolicy::runOnce });
+    auto stop = pool.postTask(TaskDescription{ .single_shot = true, .func_ptr = stopPool,
+        .interval = seconds(25), .argument = &pool, .description = "Stop", .last_executed = start,
+        .priority = TaskPriority::control });
+
+    pool.doWork(0);
+
+    // Runs right away, then every ten seconds
+    EXPECT_EQ(counter, 3);
+    const auto metrics = pool.metricsOf(updater.id());
+    ASSERT_TRUE(metrics.has_value());
+    EXPECT_EQ(metrics->maxLateness, microseconds(0));
+    EXPECT_EQ(metrics->skippedRuns, 0u);
+    EXPECT_EQ(metrics->accumulatedDrift, microseconds(0));
+    EXPECT_EQ(pool.latenessOf(TaskPriority::control).deadlineMisses, 0u);
+}
+
+namespace {
+    struct Executions {
+        std::vector<VirtualClock::time_point> startedAt;
+    };
+
+    void recordStart(void *executions) {
+        static_cast<Executions *>(executions)->startedAt.push_back(VirtualClock::now());
+    }
+}
+
+TEST(TaskPoolSimulation, CoalescesOverlappingSlackWindows) {
+    using namespace std::chrono;
+
+    VirtualClock::reset();
+    const auto start = VirtualClock::now();
+    SimulatedPool pool;
+    Executions sensor;
+    Executions updater;
+    Executions strict;
+
+    // The windows of the sensor [10s, 13s] and the updater [12s, 12.5s] overlap, so both start at 12.5s.
+    // The window of the strict task [14s, 14s] doesn't overlap with them.
+    auto sensorTask = pool.postTask(TaskDescription{ .single_shot = true, .func_ptr = recordStart,
+        .interval = seconds(10), .argument = &sensor, .description = "Sensor", .last_executed = start,
+        .priority = TaskPriority::sensing, .slack = seconds(3) });
+    auto updaterTask = pool.postTask(TaskDescription{ .single_shot = true, .func_ptr = recordStart,
+        .interval = seconds(12), .argument = &updater, .description = "Updater", .last_executed = start,
+        .priority = TaskPriority::control, .slack = milliseconds(500) });
+    auto strictTask = pool.postTask(TaskDescription{ .single_shot = true, .func_ptr = recordStart,
+        .interval = seconds(14), .argument = &strict, .description = "Strict", .last_executed = start,
+        .priority = TaskPriority::control });
+    auto stop = pool.postTask(TaskDescription{ .single_shot = true, .func_ptr = stopPool,
+        .interval = seconds(20), .argument = &pool, .description = "Stop", .last_executed = start,
+        .priority = TaskPriority::control });
+
+    pool.doWork(0);
+
+    ASSERT_EQ(sensor.startedAt.size(), 1u);
+    ASSERT_EQ(updater.startedAt.size(), 1u);
+    ASSERT_EQ(strict.startedAt.size(), 1u);
+    EXPECT_EQ(sensor.startedAt[0] - start, milliseconds(12500));
+    EXPECT_EQ(updater.startedAt[0] - start, milliseconds(12500));
+    EXPECT_EQ(strict.startedAt[0] - start, seconds(14));
+
+    // Starting within the slack window isn't late
+    EXPECT_EQ(pool.latenessOf(TaskPriority::sensing).maxLateness, microseconds(0));
+}